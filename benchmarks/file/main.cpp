@@ -4,11 +4,20 @@
 #define ANKERL_NANOBENCH_IMPLEMENT
 #include <nanobench.h>
 
+#include <atomic>
 #include <cstdio>
 #include <fstream>
 #include <lexy/input/file.hpp>
+#include <string>
+#include <thread>
+#include <vector>
 
-std::size_t use_buffer(const lexy::buffer<>& buffer)
+#if defined(__unix__) || defined(__APPLE__)
+#    include <sys/resource.h>
+#endif
+
+template <typename Input>
+std::size_t use_buffer(const Input& buffer)
 {
     std::size_t sum = 0;
     for (auto ptr = buffer.data(); ptr != buffer.data() + buffer.size(); ++ptr)
@@ -68,6 +77,121 @@ void write_file(std::size_t size)
         out.write(reinterpret_cast<const char*>(&i), sizeof(i));
 }
 
+long page_faults()
+{
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt + usage.ru_majflt;
+#else
+    return 0;
+#endif
+}
+
+void bench_options(ankerl::nanobench::Bench& b, const char* title, std::size_t size,
+                   std::size_t iterations)
+{
+    write_file(size);
+
+    b.minEpochIterations(iterations);
+    b.title(title).relative(true);
+    b.unit("byte").batch(size);
+
+    auto bench = [&](const char* name, lexy::file_options options) {
+        // Page faults of a single read that includes using the entire buffer.
+        auto faults = page_faults();
+        ankerl::nanobench::doNotOptimizeAway(
+            use_buffer(lexy::read_file(bm_file_path, options).buffer()));
+        faults = page_faults() - faults;
+
+        b.run(std::string("read_file, ") + name + " (" + std::to_string(faults) + " faults)",
+              [&] { return use_buffer(lexy::read_file(bm_file_path, options).buffer()); });
+
+        faults = page_faults();
+        ankerl::nanobench::doNotOptimizeAway(
+            use_buffer(lexy::map_file(bm_file_path, options).file()));
+        faults = page_faults() - faults;
+
+        b.run(std::string("map_file, ") + name + " (" + std::to_string(faults) + " faults)",
+              [&] { return use_buffer(lexy::map_file(bm_file_path, options).file()); });
+    };
+
+    bench("no hints", {});
+    bench("populate", {true, false, false});
+    bench("sequential", {false, true, false});
+    bench("huge pages", {false, false, true});
+    bench("all hints", {true, true, true});
+}
+
+std::vector<std::string> write_files(std::size_t count, std::size_t size)
+{
+    std::vector<std::string> paths;
+    for (auto i = 0u; i != count; ++i)
+    {
+        paths.push_back("bm-file-" + std::to_string(i) + ".delete-me");
+
+        std::ofstream out(paths.back(), std::ios::binary);
+        for (auto j = 0u; j != size / sizeof(j); ++j)
+            out.write(reinterpret_cast<const char*>(&j), sizeof(j));
+    }
+    return paths;
+}
+
+void bench_batch(ankerl::nanobench::Bench& b, std::size_t count, std::size_t size)
+{
+    auto paths = write_files(count, size);
+
+    std::vector<const char*> c_paths;
+    for (auto& path : paths)
+        c_paths.push_back(path.c_str());
+
+    b.minEpochIterations(10);
+    b.title(std::to_string(count) + " files of " + std::to_string(size) + " B").relative(true);
+    b.unit("file").batch(count);
+
+    b.run("read_file", [&] {
+        std::size_t sum = 0;
+        for (auto path : c_paths)
+            sum += file_lexy(path);
+        return sum;
+    });
+
+    auto max_threads = std::thread::hardware_concurrency();
+    for (auto threads = 1u; threads <= max_threads; threads *= 2)
+    {
+        b.run("read_files, " + std::to_string(threads) + " threads", [&] {
+            std::atomic<std::size_t> sum(0);
+            lexy::read_files(
+                c_paths.data(), c_paths.size(),
+                [&](std::size_t, lexy::read_file_result<>&& result) {
+                    sum += use_buffer(result.buffer());
+                },
+                threads);
+            return sum.load();
+        });
+    }
+
+    // Compares the synchronous reads above with asynchronous I/O on a single thread.
+    if (!lexy::_detail::has_async_file_io())
+        std::fputs("io_uring is not available, read_files_async() is synchronous\n", stderr);
+    for (auto depth : {16u, 64u})
+    {
+        b.run("read_files_async, depth " + std::to_string(depth), [&] {
+            std::size_t sum = 0;
+            lexy::read_files_async(
+                c_paths.data(), c_paths.size(),
+                [&](std::size_t, lexy::read_file_result<>&& result) {
+                    sum += use_buffer(result.buffer());
+                },
+                depth);
+            return sum;
+        });
+    }
+
+    for (auto& path : paths)
+        std::remove(path.c_str());
+}
+
 int main()
 {
     ankerl::nanobench::Bench b;
@@ -99,6 +223,14 @@ int main()
 
     bench_data("1 MiB", 1024 * 1024, 100);
 
+    bench_options(b, "1 MiB, file options", std::size_t(1) * 1024 * 1024, 100);
+    bench_options(b, "64 MiB, file options", std::size_t(64) * 1024 * 1024, 10);
+    bench_options(b, "1 GiB, file options", std::size_t(1024) * 1024 * 1024, 1);
+
     std::remove(bm_file_path);
+
+    bench_batch(b, 1000, 1024);
+    bench_batch(b, 1000, 16 * 1024);
+    bench_batch(b, 100, 1024 * 1024);
 }
 
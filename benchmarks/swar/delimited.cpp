@@ -57,34 +57,48 @@ std::size_t bm_delimited(ankerl::nanobench::Bench& b)
 
     b.unit("byte").batch(strs.size());
     b.run("quoted/manual/strs", [&] { return count += bm_quoted(disable_swar(strs.reader())); });
-    b.run("quoted/swar/strs", [&] { return count += bm_quoted(strs.reader()); });
+    b.run("quoted/swar/strs", [&] { return count += bm_quoted(disable_simd(strs.reader())); });
+    b.run("quoted/simd/strs", [&] { return count += bm_quoted(strs.reader()); });
     b.run("quoted-escape/manual/strs",
           [&] { return count += bm_quoted_escape(disable_swar(strs.reader())); });
-    b.run("quoted-escape/swar/strs", [&] { return count += bm_quoted_escape(strs.reader()); });
+    b.run("quoted-escape/swar/strs",
+          [&] { return count += bm_quoted_escape(disable_simd(strs.reader())); });
+    b.run("quoted-escape/simd/strs", [&] { return count += bm_quoted_escape(strs.reader()); });
 
     b.unit("byte").batch(ascii.size());
     b.run("quoted/manual/ascii", [&] { return count += bm_quoted(disable_swar(ascii.reader())); });
-    b.run("quoted/swar/ascii", [&] { return count += bm_quoted(ascii.reader()); });
+    b.run("quoted/swar/ascii", [&] { return count += bm_quoted(disable_simd(ascii.reader())); });
+    b.run("quoted/simd/ascii", [&] { return count += bm_quoted(ascii.reader()); });
     b.run("quoted-escape/manual/ascii",
           [&] { return count += bm_quoted_escape(disable_swar(ascii.reader())); });
-    b.run("quoted-escape/swar/ascii", [&] { return count += bm_quoted_escape(ascii.reader()); });
+    b.run("quoted-escape/swar/ascii",
+          [&] { return count += bm_quoted_escape(disable_simd(ascii.reader())); });
+    b.run("quoted-escape/simd/ascii", [&] { return count += bm_quoted_escape(ascii.reader()); });
 
     b.unit("byte").batch(few_unicode.size());
     b.run("quoted/manual/few_unicode",
           [&] { return count += bm_quoted(disable_swar(few_unicode.reader())); });
-    b.run("quoted/swar/few_unicode", [&] { return count += bm_quoted(few_unicode.reader()); });
+    b.run("quoted/swar/few_unicode",
+          [&] { return count += bm_quoted(disable_simd(few_unicode.reader())); });
+    b.run("quoted/simd/few_unicode", [&] { return count += bm_quoted(few_unicode.reader()); });
     b.run("quoted-escape/manual/few_unicode",
           [&] { return count += bm_quoted_escape(disable_swar(few_unicode.reader())); });
     b.run("quoted-escape/swar/few_unicode",
+          [&] { return count += bm_quoted_escape(disable_simd(few_unicode.reader())); });
+    b.run("quoted-escape/simd/few_unicode",
           [&] { return count += bm_quoted_escape(few_unicode.reader()); });
 
     b.unit("byte").batch(much_unicode.size());
     b.run("quoted/manual/much_unicode",
           [&] { return count += bm_quoted(disable_swar(much_unicode.reader())); });
-    b.run("quoted/swar/much_unicode", [&] { return count += bm_quoted(much_unicode.reader()); });
+    b.run("quoted/swar/much_unicode",
+          [&] { return count += bm_quoted(disable_simd(much_unicode.reader())); });
+    b.run("quoted/simd/much_unicode", [&] { return count += bm_quoted(much_unicode.reader()); });
     b.run("quoted-escape/manual/much_unicode",
           [&] { return count += bm_quoted_escape(disable_swar(much_unicode.reader())); });
     b.run("quoted-escape/swar/much_unicode",
+          [&] { return count += bm_quoted_escape(disable_simd(much_unicode.reader())); });
+    b.run("quoted-escape/simd/much_unicode",
           [&] { return count += bm_quoted_escape(much_unicode.reader()); });
 
     return count;
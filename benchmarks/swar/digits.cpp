@@ -3,7 +3,9 @@
 
 #include "swar.hpp"
 
+#include <cstdint>
 #include <lexy/dsl/digit.hpp>
+#include <lexy/dsl/integer.hpp>
 
 namespace
 {
@@ -61,6 +63,50 @@ LEXY_NOINLINE std::size_t bm_sep(Reader reader)
     }
     return count;
 }
+
+// Wraps a pointer, so the integer parser can't use SWAR.
+struct scalar_iterator
+{
+    const LEXY_CHAR8_T* ptr;
+
+    LEXY_CHAR8_T operator*() const
+    {
+        return *ptr;
+    }
+    scalar_iterator operator++(int)
+    {
+        return {ptr++};
+    }
+
+    friend bool operator==(scalar_iterator lhs, scalar_iterator rhs)
+    {
+        return lhs.ptr == rhs.ptr;
+    }
+    friend bool operator!=(scalar_iterator lhs, scalar_iterator rhs)
+    {
+        return lhs.ptr != rhs.ptr;
+    }
+};
+
+template <typename T, typename Iterator, typename Reader>
+LEXY_NOINLINE std::size_t bm_integer(Reader reader)
+{
+    using parser = lexy::dsl::_integer_parser<T, lexy::dsl::decimal, true>;
+
+    auto sum = std::size_t(0);
+    while (reader.peek() != Reader::encoding::eof())
+    {
+        auto begin = reader.position();
+        if (lexy::try_match_token(lexy::dsl::digits<>, reader))
+        {
+            auto result = parser::parse(Iterator{begin}, Iterator{reader.position()});
+            sum += std::size_t(result.value) + result.overflow;
+        }
+        else
+            reader.bump();
+    }
+    return sum;
+}
 } // namespace
 
 std::size_t bm_digits(ankerl::nanobench::Bench& b)
@@ -94,6 +140,25 @@ std::size_t bm_digits(ankerl::nanobench::Bench& b)
     b.run("digits/manual/sep", [&] { return count += bm_sep(disable_swar(decimal.reader())); });
     b.run("digits/swar/sep", [&] { return count += bm_sep(decimal.reader()); });
 
+    // Numeric CSV fields: small counts, prices in cents, IDs, and timestamps in nanoseconds.
+    auto fields = repeat_buffer_padded(
+        10 * 1024ull,
+        "0,17,512,129900,4294967295,10000000000042,1700000000123456789,18446744073709551615,");
+
+    b.unit("byte").batch(fields.size());
+    b.run("digits/manual/integer", [&] {
+        return count += bm_integer<std::uint64_t, scalar_iterator>(fields.reader());
+    });
+    b.run("digits/swar/integer", [&] {
+        return count += bm_integer<std::uint64_t, const LEXY_CHAR8_T*>(fields.reader());
+    });
+    b.run("digits/manual/integer32", [&] {
+        return count += bm_integer<std::uint32_t, scalar_iterator>(fields.reader());
+    });
+    b.run("digits/swar/integer32", [&] {
+        return count += bm_integer<std::uint32_t, const LEXY_CHAR8_T*>(fields.reader());
+    });
+
     return count;
 }
 
@@ -57,37 +57,53 @@ std::size_t bm_identifier(ankerl::nanobench::Bench& b)
     b.unit("byte").batch(words.size());
     b.run("identifier-ascii/manual/words",
           [&] { return count += bm_ascii(disable_swar(words.reader())); });
-    b.run("identifier-ascii/swar/words", [&] { return count += bm_ascii(words.reader()); });
+    b.run("identifier-ascii/swar/words",
+          [&] { return count += bm_ascii(disable_simd(words.reader())); });
+    b.run("identifier-ascii/simd/words", [&] { return count += bm_ascii(words.reader()); });
     b.run("identifier-unicode/manual/words",
           [&] { return count += bm_unicode(disable_swar(words.reader())); });
-    b.run("identifier-unicode/swar/words", [&] { return count += bm_unicode(words.reader()); });
+    b.run("identifier-unicode/swar/words",
+          [&] { return count += bm_unicode(disable_simd(words.reader())); });
+    b.run("identifier-unicode/simd/words", [&] { return count += bm_unicode(words.reader()); });
 
     b.unit("byte").batch(ascii.size());
     b.run("identifier-ascii/manual/ascii",
           [&] { return count += bm_ascii(disable_swar(ascii.reader())); });
-    b.run("identifier-ascii/swar/ascii", [&] { return count += bm_ascii(ascii.reader()); });
+    b.run("identifier-ascii/swar/ascii",
+          [&] { return count += bm_ascii(disable_simd(ascii.reader())); });
+    b.run("identifier-ascii/simd/ascii", [&] { return count += bm_ascii(ascii.reader()); });
     b.run("identifier-unicode/manual/ascii",
           [&] { return count += bm_unicode(disable_swar(ascii.reader())); });
-    b.run("identifier-unicode/swar/ascii", [&] { return count += bm_ascii(ascii.reader()); });
+    b.run("identifier-unicode/swar/ascii",
+          [&] { return count += bm_ascii(disable_simd(ascii.reader())); });
+    b.run("identifier-unicode/simd/ascii", [&] { return count += bm_ascii(ascii.reader()); });
 
     b.unit("byte").batch(few_unicode.size());
     b.run("identifier-ascii/manual/few_unicode",
           [&] { return count += bm_ascii(disable_swar(few_unicode.reader())); });
     b.run("identifier-ascii/swar/few_unicode",
+          [&] { return count += bm_ascii(disable_simd(few_unicode.reader())); });
+    b.run("identifier-ascii/simd/few_unicode",
           [&] { return count += bm_ascii(few_unicode.reader()); });
     b.run("identifier-unicode/manual/few_unicode",
           [&] { return count += bm_unicode(disable_swar(few_unicode.reader())); });
     b.run("identifier-unicode/swar/few_unicode",
+          [&] { return count += bm_unicode(disable_simd(few_unicode.reader())); });
+    b.run("identifier-unicode/simd/few_unicode",
           [&] { return count += bm_unicode(few_unicode.reader()); });
 
     b.unit("byte").batch(much_unicode.size());
     b.run("identifier-ascii/manual/much_unicode",
           [&] { return count += bm_ascii(disable_swar(much_unicode.reader())); });
     b.run("identifier-ascii/swar/much_unicode",
+          [&] { return count += bm_ascii(disable_simd(much_unicode.reader())); });
+    b.run("identifier-ascii/simd/much_unicode",
           [&] { return count += bm_ascii(much_unicode.reader()); });
     b.run("identifier-unicode/manual/much_unicode",
           [&] { return count += bm_unicode(disable_swar(much_unicode.reader())); });
     b.run("identifier-unicode/swar/much_unicode",
+          [&] { return count += bm_unicode(disable_simd(much_unicode.reader())); });
+    b.run("identifier-unicode/simd/much_unicode",
           [&] { return count += bm_unicode(much_unicode.reader()); });
 
     return count;
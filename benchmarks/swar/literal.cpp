@@ -48,6 +48,29 @@ LEXY_NOINLINE std::size_t bm_alphabet(Reader reader)
     }
     return count;
 }
+
+template <typename Literal, typename Reader>
+LEXY_NOINLINE std::size_t bm_long(Reader reader)
+{
+    auto count = 0u;
+    while (reader.peek() != Reader::encoding::eof())
+    {
+        if (lexy::try_match_token(Literal{}, reader))
+            ++count;
+        else
+            reader.bump();
+    }
+    return count;
+}
+
+#define LIT16 "0123456789abcdef"
+#define LIT32 LIT16 "ghijklmnopqrstuv"
+#define LIT64 LIT32 LIT32
+using lit16 = decltype(LEXY_LIT(LIT16));
+using lit32 = decltype(LEXY_LIT(LIT32));
+using lit64 = decltype(LEXY_LIT(LIT64));
+using lset32
+    = decltype(lexy::dsl::literal_set(LEXY_LIT(LIT32), LEXY_LIT("<![CDATA["), LEXY_LIT("<!--")));
 } // namespace
 
 std::size_t bm_lit(ankerl::nanobench::Bench& b)
@@ -62,15 +85,45 @@ std::size_t bm_lit(ankerl::nanobench::Bench& b)
 
     auto abcd = repeat_buffer_padded(10 * 1024ull, "abcd");
     b.minEpochIterations(10 * 1000ull);
-    b.unit("byte").batch(a.size());
-    b.run("lit/manual/abcd", [&] { return count += bm_abcd(disable_swar(a.reader())); });
-    b.run("lit/swar/abcd", [&] { return count += bm_abcd(a.reader()); });
+    b.unit("byte").batch(abcd.size());
+    b.run("lit/manual/abcd", [&] { return count += bm_abcd(disable_swar(abcd.reader())); });
+    b.run("lit/swar/abcd", [&] { return count += bm_abcd(abcd.reader()); });
 
     auto alphabet = repeat_buffer_padded(10 * 1024ull, "abcdefghijklmnopqrstuvwxyz");
     b.minEpochIterations(10 * 1000ull);
-    b.unit("byte").batch(a.size());
-    b.run("lit/manual/alphabet", [&] { return count += bm_alphabet(disable_swar(a.reader())); });
-    b.run("lit/swar/alphabet", [&] { return count += bm_alphabet(a.reader()); });
+    b.unit("byte").batch(alphabet.size());
+    b.run("lit/manual/alphabet",
+          [&] { return count += bm_alphabet(disable_swar(alphabet.reader())); });
+    b.run("lit/swar/alphabet", [&] { return count += bm_alphabet(alphabet.reader()); });
+
+    auto long16 = repeat_buffer_padded(10 * 1024ull, LIT16);
+    b.minEpochIterations(10 * 1000ull);
+    b.unit("byte").batch(long16.size());
+    b.run("lit/manual/16",
+          [&] { return count += bm_long<lit16>(disable_swar(long16.reader())); });
+    b.run("lit/swar/16", [&] { return count += bm_long<lit16>(disable_simd(long16.reader())); });
+    b.run("lit/simd/16", [&] { return count += bm_long<lit16>(long16.reader()); });
+
+    auto long32 = repeat_buffer_padded(10 * 1024ull, LIT32);
+    b.minEpochIterations(10 * 1000ull);
+    b.unit("byte").batch(long32.size());
+    b.run("lit/manual/32",
+          [&] { return count += bm_long<lit32>(disable_swar(long32.reader())); });
+    b.run("lit/swar/32", [&] { return count += bm_long<lit32>(disable_simd(long32.reader())); });
+    b.run("lit/simd/32", [&] { return count += bm_long<lit32>(long32.reader()); });
+    b.run("lit_set/manual/32",
+          [&] { return count += bm_long<lset32>(disable_swar(long32.reader())); });
+    b.run("lit_set/swar/32",
+          [&] { return count += bm_long<lset32>(disable_simd(long32.reader())); });
+    b.run("lit_set/simd/32", [&] { return count += bm_long<lset32>(long32.reader()); });
+
+    auto long64 = repeat_buffer_padded(10 * 1024ull, LIT64);
+    b.minEpochIterations(10 * 1000ull);
+    b.unit("byte").batch(long64.size());
+    b.run("lit/manual/64",
+          [&] { return count += bm_long<lit64>(disable_swar(long64.reader())); });
+    b.run("lit/swar/64", [&] { return count += bm_long<lit64>(disable_simd(long64.reader())); });
+    b.run("lit/simd/64", [&] { return count += bm_long<lit64>(long64.reader()); });
 
     return count;
 }
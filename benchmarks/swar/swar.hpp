@@ -68,6 +68,20 @@ constexpr auto disable_swar(lexy::_br<Encoding> reader)
     return swar_disabled_reader<Encoding>(reader.position());
 }
 
+template <typename Encoding>
+class simd_disabled_reader : public swar_disabled_reader<Encoding>,
+                             public lexy::_detail::swar_reader_base<simd_disabled_reader<Encoding>>
+{
+public:
+    using swar_disabled_reader<Encoding>::swar_disabled_reader;
+};
+
+template <typename Encoding>
+constexpr auto disable_simd(lexy::_br<Encoding> reader)
+{
+    return simd_disabled_reader<Encoding>(reader.position());
+}
+
 lexy::buffer<lexy::utf8_encoding> random_buffer(std::size_t size, float unicode_ratio);
 
 lexy::buffer<lexy::utf8_encoding> repeat_buffer_padded(std::size_t size, const char* str);
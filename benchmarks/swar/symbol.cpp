@@ -0,0 +1,252 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "swar.hpp"
+
+#include <cstdint>
+#include <iterator>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/symbol.hpp>
+#include <lexy/input/string_input.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Compares the two ways of matching a trie of symbols: lit_trie_matcher, which compares the input
+// against each transition of a node, and lit_trie_dfa, which looks up the next node in a table.
+template <typename LiteralSet, bool UseDfa, typename Reader>
+LEXY_NOINLINE std::size_t bm_trie(Reader reader)
+{
+    constexpr const auto& trie = LiteralSet::template _t<typename Reader::encoding>;
+
+    auto count = 0u;
+    while (reader.peek() != Reader::encoding::eof())
+    {
+        std::size_t result;
+        if constexpr (UseDfa)
+            result = lexy::_detail::lit_trie_dfa<trie>::try_match(reader);
+        else
+            result = lexy::_detail::lit_trie_matcher<trie, 0>::template _impl<>::try_match(reader);
+
+        if (result != trie.node_no_match)
+            ++count;
+        else
+            reader.bump();
+    }
+    return count;
+}
+
+// All words of length 1 to Depth over the first Fanout letters, so every node has Fanout
+// transitions.
+constexpr char bushy_char(std::size_t idx)
+{
+    return static_cast<char>('a' + idx);
+}
+constexpr std::size_t bushy_count(std::size_t fanout, std::size_t length)
+{
+    return length == 0 ? 1 : fanout * bushy_count(fanout, length - 1);
+}
+
+template <std::size_t Fanout, std::size_t Idx, std::size_t... Pos>
+constexpr auto bushy_word(lexy::_detail::index_sequence<Pos...>)
+{
+    return lexyd::_lit<char, bushy_char(Idx / bushy_count(Fanout, Pos) % Fanout)...>{};
+}
+template <std::size_t Fanout, std::size_t Length, std::size_t... Idx>
+constexpr auto bushy_words(lexy::_detail::index_sequence<Idx...>)
+{
+    return lexy::dsl::literal_set(
+        bushy_word<Fanout, Idx>(lexy::_detail::make_index_sequence<Length>{})...);
+}
+template <std::size_t Fanout, std::size_t... Length>
+constexpr auto bushy_set(lexy::_detail::index_sequence<Length...>)
+{
+    return (bushy_words<Fanout, Length + 1>(
+                lexy::_detail::make_index_sequence<bushy_count(Fanout, Length + 1)>{})
+            / ...);
+}
+template <std::size_t Fanout, std::size_t Depth>
+using bushy = decltype(bushy_set<Fanout>(lexy::_detail::make_index_sequence<Depth>{}));
+
+lexy::buffer<lexy::utf8_encoding> random_bushy_words(std::size_t size, std::size_t fanout,
+                                                     std::size_t depth)
+{
+    std::default_random_engine                 engine;
+    std::uniform_int_distribution<std::size_t> length_dist(1, depth);
+    std::uniform_int_distribution<std::size_t> char_dist(0, fanout - 1);
+
+    std::string str;
+    while (str.size() < size)
+    {
+        for (auto length = length_dist(engine); length > 0; --length)
+            str += bushy_char(char_dist(engine));
+        str += ' ';
+    }
+    return lexy::buffer<lexy::utf8_encoding>(str.data(), str.size());
+}
+
+// Keywords share few prefixes, so most of the trie are chains of single transitions.
+using sql = decltype(lexy::dsl::literal_set(
+    LEXY_LIT("select"), LEXY_LIT("from"), LEXY_LIT("where"), LEXY_LIT("group"),
+    LEXY_LIT("order"), LEXY_LIT("by"), LEXY_LIT("having"), LEXY_LIT("limit"), LEXY_LIT("offset"),
+    LEXY_LIT("insert"), LEXY_LIT("into"), LEXY_LIT("values"), LEXY_LIT("update"),
+    LEXY_LIT("set"), LEXY_LIT("delete"), LEXY_LIT("create"), LEXY_LIT("table"),
+    LEXY_LIT("index"), LEXY_LIT("view"), LEXY_LIT("drop"), LEXY_LIT("alter"), LEXY_LIT("add"),
+    LEXY_LIT("column"), LEXY_LIT("primary"), LEXY_LIT("key"), LEXY_LIT("foreign"),
+    LEXY_LIT("references"), LEXY_LIT("unique"), LEXY_LIT("not"), LEXY_LIT("null"),
+    LEXY_LIT("default"), LEXY_LIT("and"), LEXY_LIT("or"), LEXY_LIT("in"), LEXY_LIT("is"),
+    LEXY_LIT("like"), LEXY_LIT("between"), LEXY_LIT("exists"), LEXY_LIT("join"),
+    LEXY_LIT("inner"), LEXY_LIT("left"), LEXY_LIT("right"), LEXY_LIT("outer"), LEXY_LIT("on"),
+    LEXY_LIT("as"), LEXY_LIT("distinct"), LEXY_LIT("union"), LEXY_LIT("all"), LEXY_LIT("case"),
+    LEXY_LIT("when"), LEXY_LIT("then"), LEXY_LIT("else"), LEXY_LIT("end"), LEXY_LIT("asc"),
+    LEXY_LIT("desc"), LEXY_LIT("interval"), LEXY_LIT("integer"), LEXY_LIT("int"),
+    LEXY_LIT("internal"), LEXY_LIT("intersect")));
+
+lexy::buffer<lexy::utf8_encoding> random_sql_keywords(std::size_t size)
+{
+    const char* keywords[]
+        = {"select",  "from",    "where",   "group",    "order",     "by",      "having",
+           "limit",   "offset",  "insert",  "into",     "values",    "update",  "set",
+           "delete",  "create",  "table",   "index",    "view",      "drop",    "alter",
+           "add",     "column",  "primary", "key",      "foreign",   "references", "unique",
+           "not",     "null",    "default", "and",      "or",        "in",      "is",
+           "like",    "between", "exists",  "join",     "inner",     "left",    "right",
+           "outer",   "on",      "as",      "distinct", "union",     "all",     "case",
+           "when",    "then",    "else",    "end",      "asc",       "desc",    "interval",
+           "integer", "int",     "internal", "intersect"};
+    std::default_random_engine                 engine;
+    std::uniform_int_distribution<std::size_t> dist(0, std::size(keywords) - 1);
+
+    std::string str;
+    while (str.size() < size)
+    {
+        str += keywords[dist(engine)];
+        str += ' ';
+    }
+    return lexy::buffer<lexy::utf8_encoding>(str.data(), str.size());
+}
+
+template <std::size_t Fanout, std::size_t Depth>
+std::size_t bm_bushy(ankerl::nanobench::Bench& b, const char* trie_name, const char* dfa_name)
+{
+    using set = bushy<Fanout, Depth>;
+    static_assert(lexy::_detail::lit_trie_dfa<set::template _t<lexy::utf8_encoding>>::enabled
+                  == (Fanout >= lexy::_detail::lit_trie_dfa_fanout));
+
+    auto count = std::size_t(0);
+    auto input = random_bushy_words(10 * 1024ull, Fanout, Depth);
+    b.minEpochIterations(1000ull);
+    b.unit("byte").batch(input.size());
+    b.run(trie_name, [&] { return count += bm_trie<set, false>(input.reader()); });
+    b.run(dfa_name, [&] { return count += bm_trie<set, true>(input.reader()); });
+    return count;
+}
+
+// Compares the two ways of looking up an entire word in a symbol table: the trie, which reads one
+// char after the other and visits the transitions of each node, and the perfect hash.
+// The symbols are spelled as types instead of calling map() for each, as we don't need values.
+template <template <std::size_t> typename Symbol, bool PerfectHash, std::size_t... Idx>
+auto generated_symbol_table(lexy::_detail::index_sequence<Idx...>)
+    -> lexy::_symbol_table<int, lexy::_detail::lit_no_case_fold, PerfectHash, Symbol<Idx>...>;
+template <template <std::size_t> typename Symbol, bool PerfectHash, std::size_t Count>
+constexpr auto generated_symbols = decltype(generated_symbol_table<Symbol, PerfectHash>(
+    lexy::_detail::make_index_sequence<Count>{})){};
+
+// "k0000", "k0001", and so on: every node of the trie has at most ten transitions.
+template <std::size_t Idx>
+using numbered_symbol
+    = lexy::_detail::type_string<char, 'k', char('0' + Idx / 1000 % 10), char('0' + Idx / 100 % 10),
+                                 char('0' + Idx / 10 % 10), char('0' + Idx % 10)>;
+
+// Pseudo-random lowercase words with four to ten characters, like the keywords of a big grammar.
+constexpr char word_symbol_char(std::size_t idx, std::size_t pos)
+{
+    auto hash = std::uint64_t(idx) * 0x9E3779B97F4A7C15 + std::uint64_t(pos) * 0xC2B2AE3D27D4EB4F;
+    hash ^= hash >> 29;
+    return static_cast<char>('a' + hash % 26);
+}
+template <std::size_t Idx, std::size_t... Pos>
+auto word_symbol_chars(lexy::_detail::index_sequence<Pos...>)
+    -> lexy::_detail::type_string<char, word_symbol_char(Idx, Pos)...>;
+template <std::size_t Idx>
+using word_symbol
+    = decltype(word_symbol_chars<Idx>(lexy::_detail::make_index_sequence<4 + Idx % 7>{}));
+
+template <typename Table, typename Words>
+LEXY_NOINLINE std::size_t bm_lookup(const Table& table, const Words& words)
+{
+    auto count = 0u;
+    for (auto& word : words)
+        if (table.parse(word))
+            ++count;
+    return count;
+}
+
+template <template <std::size_t> typename Symbol, std::size_t Count>
+std::size_t bm_symbol_table(ankerl::nanobench::Bench& b, const char* trie_name,
+                            const char* hash_name)
+{
+    constexpr auto& trie_table = generated_symbols<Symbol, false, Count>;
+    constexpr auto& hash_table = generated_symbols<Symbol, true, Count>;
+
+    std::vector<std::string> symbols;
+    for (auto entry : trie_table)
+        symbols.push_back(entry.symbol);
+
+    // One in five words isn't a symbol, but has one as prefix.
+    std::default_random_engine                 engine;
+    std::uniform_int_distribution<std::size_t> dist(0, symbols.size() - 1);
+    std::uniform_int_distribution<int>         miss_dist(0, 4);
+
+    std::string              str;
+    std::vector<std::size_t> offsets;
+    while (str.size() < 10 * 1024ull)
+    {
+        offsets.push_back(str.size());
+        str += symbols[dist(engine)];
+        if (miss_dist(engine) == 0)
+            str += '_';
+    }
+    offsets.push_back(str.size());
+
+    auto input = lexy::buffer<lexy::utf8_encoding>(str.data(), str.size());
+    std::vector<lexy::string_input<lexy::utf8_encoding>> words;
+    for (auto i = 1u; i != offsets.size(); ++i)
+        words.emplace_back(input.data() + offsets[i - 1], input.data() + offsets[i]);
+
+    auto count = std::size_t(0);
+    b.minEpochIterations(1000ull);
+    b.unit("byte").batch(input.size());
+    b.run(trie_name, [&] { return count += bm_lookup(trie_table, words); });
+    b.run(hash_name, [&] { return count += bm_lookup(hash_table, words); });
+    return count;
+}
+} // namespace
+
+std::size_t bm_symbol(ankerl::nanobench::Bench& b)
+{
+    auto count = std::size_t(0);
+
+    auto sql_input = random_sql_keywords(10 * 1024ull);
+    b.minEpochIterations(1000ull);
+    b.unit("byte").batch(sql_input.size());
+    b.run("symbol/trie/sql", [&] { return count += bm_trie<sql, false>(sql_input.reader()); });
+    b.run("symbol/dfa/sql", [&] { return count += bm_trie<sql, true>(sql_input.reader()); });
+
+    // The DFA is selected from a fanout of lit_trie_dfa_fanout on.
+    count += bm_bushy<2, 4>(b, "symbol/trie/fanout2", "symbol/dfa/fanout2");
+    count += bm_bushy<4, 3>(b, "symbol/trie/fanout4", "symbol/dfa/fanout4");
+    count += bm_bushy<6, 2>(b, "symbol/trie/fanout6", "symbol/dfa/fanout6");
+    count += bm_bushy<8, 2>(b, "symbol/trie/fanout8", "symbol/dfa/fanout8");
+    count += bm_bushy<16, 2>(b, "symbol/trie/fanout16", "symbol/dfa/fanout16");
+
+    // The trie of many more words exceeds the default constexpr limits of the compiler.
+    count += bm_symbol_table<word_symbol, 16>(b, "symbol/trie/words16", "symbol/hash/words16");
+    count += bm_symbol_table<word_symbol, 128>(b, "symbol/trie/words128", "symbol/hash/words128");
+    count += bm_symbol_table<word_symbol, 512>(b, "symbol/trie/words512", "symbol/hash/words512");
+    count += bm_symbol_table<numbered_symbol, 1024>(b, "symbol/trie/numbered1024",
+                                                    "symbol/hash/numbered1024");
+    return count;
+}
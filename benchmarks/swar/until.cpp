@@ -32,6 +32,20 @@ LEXY_NOINLINE std::size_t bm_until_eof(Reader reader)
     }
     return count;
 }
+
+template <typename Reader>
+LEXY_NOINLINE std::size_t bm_until_comment(Reader reader)
+{
+    auto count = 0u;
+    while (reader.peek() != Reader::encoding::eof())
+    {
+        if (lexy::try_match_token(lexy::dsl::until(LEXY_LIT("*/")), reader))
+            ++count;
+        else
+            reader.bump();
+    }
+    return count;
+}
 } // namespace
 
 std::size_t bm_until(ankerl::nanobench::Bench& b)
@@ -47,44 +61,70 @@ std::size_t bm_until(ankerl::nanobench::Bench& b)
     b.minEpochIterations(100 * 1000ull);
     b.unit("byte").batch(small.size());
     b.run("until/manual/small", [&] { return count += bm_until(disable_swar(small.reader())); });
-    b.run("until/swar/small", [&] { return count += bm_until(small.reader()); });
+    b.run("until/swar/small", [&] { return count += bm_until(disable_simd(small.reader())); });
+    b.run("until/simd/small", [&] { return count += bm_until(small.reader()); });
 
     b.unit("byte").batch(ascii.size());
     b.run("until/manual/ascii", [&] { return count += bm_until(disable_swar(ascii.reader())); });
-    b.run("until/swar/ascii", [&] { return count += bm_until(ascii.reader()); });
+    b.run("until/swar/ascii", [&] { return count += bm_until(disable_simd(ascii.reader())); });
+    b.run("until/simd/ascii", [&] { return count += bm_until(ascii.reader()); });
 
     b.unit("byte").batch(few_unicode.size());
     b.run("until/manual/few_unicode",
           [&] { return count += bm_until(disable_swar(few_unicode.reader())); });
-    b.run("until/swar/few_unicode", [&] { return count += bm_until(few_unicode.reader()); });
+    b.run("until/swar/few_unicode",
+          [&] { return count += bm_until(disable_simd(few_unicode.reader())); });
+    b.run("until/simd/few_unicode", [&] { return count += bm_until(few_unicode.reader()); });
 
     b.unit("byte").batch(much_unicode.size());
     b.run("until/manual/much_unicode",
           [&] { return count += bm_until(disable_swar(much_unicode.reader())); });
-    b.run("until/swar/much_unicode", [&] { return count += bm_until(much_unicode.reader()); });
+    b.run("until/swar/much_unicode",
+          [&] { return count += bm_until(disable_simd(much_unicode.reader())); });
+    b.run("until/simd/much_unicode", [&] { return count += bm_until(much_unicode.reader()); });
 
     b.unit("byte").batch(small.size());
     b.run("until_eof/manual/small",
           [&] { return count += bm_until_eof(disable_swar(small.reader())); });
-    b.run("until_eof/swar/small", [&] { return count += bm_until_eof(small.reader()); });
+    b.run("until_eof/swar/small",
+          [&] { return count += bm_until_eof(disable_simd(small.reader())); });
+    b.run("until_eof/simd/small", [&] { return count += bm_until_eof(small.reader()); });
 
     b.unit("byte").batch(ascii.size());
     b.run("until_eof/manual/ascii",
           [&] { return count += bm_until_eof(disable_swar(ascii.reader())); });
-    b.run("until_eof/swar/ascii", [&] { return count += bm_until_eof(ascii.reader()); });
+    b.run("until_eof/swar/ascii",
+          [&] { return count += bm_until_eof(disable_simd(ascii.reader())); });
+    b.run("until_eof/simd/ascii", [&] { return count += bm_until_eof(ascii.reader()); });
 
     b.unit("byte").batch(few_unicode.size());
     b.run("until_eof/manual/few_unicode",
           [&] { return count += bm_until_eof(disable_swar(few_unicode.reader())); });
     b.run("until_eof/swar/few_unicode",
+          [&] { return count += bm_until_eof(disable_simd(few_unicode.reader())); });
+    b.run("until_eof/simd/few_unicode",
           [&] { return count += bm_until_eof(few_unicode.reader()); });
 
     b.unit("byte").batch(much_unicode.size());
     b.run("until_eof/manual/much_unicode",
           [&] { return count += bm_until_eof(disable_swar(much_unicode.reader())); });
     b.run("until_eof/swar/much_unicode",
+          [&] { return count += bm_until_eof(disable_simd(much_unicode.reader())); });
+    b.run("until_eof/simd/much_unicode",
           [&] { return count += bm_until_eof(much_unicode.reader()); });
 
+    auto comments = repeat_buffer_padded(
+        1031, "/* Returns the number of elements, i.e. size / sizeof(T). */\n"
+              "/**\n * Parses the input.\n *\n * Throws an exception on failure.\n */\n");
+
+    b.unit("byte").batch(comments.size());
+    b.run("until_comment/manual/comments",
+          [&] { return count += bm_until_comment(disable_swar(comments.reader())); });
+    b.run("until_comment/swar/comments",
+          [&] { return count += bm_until_comment(disable_simd(comments.reader())); });
+    b.run("until_comment/simd/comments",
+          [&] { return count += bm_until_comment(comments.reader()); });
+
     return count;
 }
 
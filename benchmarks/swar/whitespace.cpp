@@ -0,0 +1,108 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include "swar.hpp"
+
+#include <random>
+#include <string>
+#include <lexy/action/match.hpp>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/branch.hpp>
+#include <lexy/dsl/eof.hpp>
+#include <lexy/dsl/identifier.hpp>
+#include <lexy/dsl/loop.hpp>
+#include <lexy/dsl/newline.hpp>
+#include <lexy/dsl/until.hpp>
+#include <lexy/dsl/whitespace.hpp>
+
+namespace
+{
+namespace dsl = lexy::dsl;
+
+// Words separated by whitespace.
+template <typename Whitespace>
+struct words
+{
+    static constexpr auto word = dsl::identifier(dsl::ascii::graph).pattern();
+    static constexpr auto rule
+        = dsl::loop(dsl::whitespace(Whitespace{}) + (dsl::eof >> dsl::break_ | dsl::else_ >> word));
+};
+
+using space         = LEXY_DECAY_DECLTYPE(dsl::ascii::space);
+using space_comment = LEXY_DECAY_DECLTYPE(dsl::ascii::space
+                                          | LEXY_LIT("//") >> dsl::until(dsl::newline));
+
+template <typename>
+using match_result = bool;
+
+template <typename Production, typename Reader>
+LEXY_NOINLINE std::size_t bm_whitespace(Reader reader)
+{
+    return lexy::do_action<Production, match_result>(lexy::_mh(), lexy::no_parse_state, reader);
+}
+
+// Pretty-printed JSON-like data with random nesting and optional comments.
+lexy::buffer<lexy::utf8_encoding> pretty_buffer(std::size_t size, bool comments)
+{
+    std::default_random_engine                 engine;
+    std::uniform_int_distribution<std::size_t> depth_dist(1, 6);
+    std::uniform_int_distribution<int>         kind_dist(0, 3);
+
+    std::string str;
+    while (str.size() < size)
+    {
+        str.append(4 * depth_dist(engine), ' ');
+        switch (kind_dist(engine))
+        {
+        case 0:
+            str += "\"name\": \"lexy\",";
+            break;
+        case 1:
+            str += "\"values\": [1, 2, 3],";
+            break;
+        case 2:
+            str += "{";
+            break;
+        case 3:
+            str += "},";
+            break;
+        }
+        if (comments && kind_dist(engine) == 0)
+            str += "  // a comment";
+        str += '\n';
+    }
+    str.resize(size);
+
+    return lexy::buffer<lexy::utf8_encoding>(str.data(), str.size());
+}
+} // namespace
+
+std::size_t bm_whitespace(ankerl::nanobench::Bench& b)
+{
+    auto json      = pretty_buffer(10 * 1024ull, false);
+    auto commented = pretty_buffer(10 * 1024ull, true);
+
+    auto count = std::size_t(0);
+
+    b.minEpochIterations(100);
+
+    b.unit("byte").batch(json.size());
+    b.run("whitespace-space/manual/json",
+          [&] { return count += bm_whitespace<words<space>>(disable_swar(json.reader())); });
+    b.run("whitespace-space/swar/json",
+          [&] { return count += bm_whitespace<words<space>>(disable_simd(json.reader())); });
+    b.run("whitespace-space/simd/json",
+          [&] { return count += bm_whitespace<words<space>>(json.reader()); });
+
+    b.unit("byte").batch(commented.size());
+    b.run("whitespace-comment/manual/commented", [&] {
+        return count += bm_whitespace<words<space_comment>>(disable_swar(commented.reader()));
+    });
+    b.run("whitespace-comment/swar/commented", [&] {
+        return count += bm_whitespace<words<space_comment>>(disable_simd(commented.reader()));
+    });
+    b.run("whitespace-comment/simd/commented",
+          [&] { return count += bm_whitespace<words<space_comment>>(commented.reader()); });
+
+    return count;
+}
@@ -0,0 +1,7 @@
+// INPUT:-1.25e-3
+struct production
+{
+    static constexpr auto rule
+        // Minus sign followed by a decimal number with fraction and exponent.
+        = dsl::minus_sign + dsl::real<double>;
+};
@@ -0,0 +1,19 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+// Prints the first and follow sets of the productions of one of the other examples,
+// and every choice, optional, or loop that can't decide by looking at the next character.
+//
+// It is compiled once per example: LEXY_GRAMMAR_REPORT_EXAMPLE is the source file of the example
+// and LEXY_GRAMMAR_REPORT_PRODUCTION its entry production.
+
+// We only want the grammar, not the main function of the example.
+#define LEXY_TEST
+#include LEXY_GRAMMAR_REPORT_EXAMPLE
+
+#include <lexy_ext/grammar_report.hpp> // lexy_ext::print_grammar_report
+
+int main()
+{
+    lexy_ext::print_grammar_report<LEXY_GRAMMAR_REPORT_PRODUCTION, lexy::utf8_encoding>();
+}
@@ -1,11 +1,8 @@
 // Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
 // SPDX-License-Identifier: BSL-1.0
 
-#include <cinttypes>
-#include <cstdint>
 #include <cstdio>
 #include <map>
-#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
@@ -28,12 +25,7 @@ namespace ast
     using json_null = std::nullptr_t;
     using json_bool = bool;
 
-    struct json_number
-    {
-        std::int64_t                integer;
-        std::optional<std::string>  fraction;
-        std::optional<std::int16_t> exponent;
-    };
+    using json_number = double;
 
     using json_string = std::string;
 
@@ -65,13 +57,9 @@ namespace ast
             else
                 std::fputs("false", stdout);
         }
-        void _print(const json_number& i, int) const
+        void _print(json_number n, int) const
         {
-            std::fprintf(stdout, "%" PRId64, i.integer);
-            if (i.fraction)
-                std::fprintf(stdout, ".%s", i.fraction->c_str());
-            if (i.exponent)
-                std::fprintf(stdout, "e%" PRId16, *i.exponent);
+            std::fprintf(stdout, "%.17g", n);
         }
         void _print(const json_string& str, int) const
         {
@@ -174,35 +162,10 @@ namespace grammar
     // A json value that is a number.
     struct number : lexy::token_production
     {
-        // A signed integer parsed as int64_t.
-        struct integer : lexy::transparent_production
-        {
-            static constexpr auto rule
-                = dsl::minus_sign + dsl::integer<std::int64_t>(dsl::digits<>.no_leading_zero());
-            static constexpr auto value = lexy::as_integer<std::int64_t>;
-        };
-
-        // The fractional part of a number parsed as the string.
-        struct fraction : lexy::transparent_production
-        {
-            static constexpr auto rule  = dsl::lit_c<'.'> >> dsl::capture(dsl::digits<>);
-            static constexpr auto value = lexy::as_string<std::string>;
-        };
-
-        // The exponent of a number parsed as int64_t.
-        struct exponent : lexy::transparent_production
-        {
-            static constexpr auto rule = [] {
-                auto exp_char = dsl::lit_c<'e'> | dsl::lit_c<'E'>;
-                return exp_char >> dsl::sign + dsl::integer<std::int16_t>;
-            }();
-            static constexpr auto value = lexy::as_integer<std::int16_t>;
-        };
-
+        // dsl::real matches the JSON number syntax after the sign and converts it to a double.
         static constexpr auto rule
-            = dsl::peek(dsl::lit_c<'-'> / dsl::digit<>)
-              >> dsl::p<integer> + dsl::opt(dsl::p<fraction>) + dsl::opt(dsl::p<exponent>);
-        static constexpr auto value = lexy::construct<ast::json_number>;
+            = dsl::peek(dsl::lit_c<'-'> / dsl::digit<>) >> dsl::minus_sign + dsl::real<double>;
+        static constexpr auto value = lexy::as_real<ast::json_number>;
     };
 
     // A json value that is a string.
@@ -4,6 +4,7 @@
 #ifndef LEXY_DETAIL_CODE_POINT_HPP_INCLUDED
 #define LEXY_DETAIL_CODE_POINT_HPP_INCLUDED
 
+#include <lexy/_detail/validate_utf8.hpp>
 #include <lexy/input/base.hpp>
 
 //=== encoding ===//
@@ -138,6 +139,41 @@ struct cp_result
     typename Reader::marker end;
 };
 
+// Decodes a code point of input that is known to be well-formed UTF-8.
+// The only error is starting in the middle of a code point.
+template <typename Reader>
+constexpr cp_result<Reader> parse_validated_utf8_code_point(Reader reader)
+{
+    using uchar_t = unsigned char;
+
+    auto first = uchar_t(reader.peek());
+    if (first < 0x80)
+    {
+        reader.bump();
+        return {first, cp_error::success, reader.current()};
+    }
+    else if (first < 0xC0)
+    {
+        return {{}, cp_error::leads_with_trailing, reader.current()};
+    }
+    else if (first >= 0xF8)
+    {
+        // Well-formed UTF-8 doesn't contain those, so it's EOF.
+        return {{}, cp_error::eof, reader.current()};
+    }
+
+    auto length = first < 0xE0 ? 2 : first < 0xF0 ? 3 : 4;
+    auto result = char32_t(first & (0x7F >> length));
+    reader.bump();
+    for (auto i = 1; i != length; ++i)
+    {
+        result <<= 6;
+        result |= char32_t(uchar_t(reader.peek()) & 0b0011'1111);
+        reader.bump();
+    }
+    return {result, cp_error::success, reader.current()};
+}
+
 template <typename Reader>
 constexpr cp_result<Reader> parse_code_point(Reader reader)
 {
@@ -158,6 +194,21 @@ constexpr cp_result<Reader> parse_code_point(Reader reader)
     else if constexpr (std::is_same_v<typename Reader::encoding, lexy::utf8_encoding> //
                        || std::is_same_v<typename Reader::encoding, lexy::utf8_char_encoding>)
     {
+        if constexpr (is_ascii_only_reader<Reader>)
+        {
+            // Anything that isn't ASCII is the EOF sentinel.
+            auto cur = static_cast<unsigned char>(reader.peek());
+            if (cur >= 0x80)
+                return {{}, cp_error::eof, reader.current()};
+
+            reader.bump();
+            return {cur, cp_error::success, reader.current()};
+        }
+        else if constexpr (is_utf8_validated_reader<Reader>)
+        {
+            return parse_validated_utf8_code_point(reader);
+        }
+
         using uchar_t                = unsigned char;
         constexpr auto payload_lead1 = 0b0111'1111;
         constexpr auto payload_lead2 = 0b0001'1111;
@@ -0,0 +1,161 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_PERFECT_HASH_HPP_INCLUDED
+#define LEXY_DETAIL_PERFECT_HASH_HPP_INCLUDED
+
+#include <cstdint>
+#include <lexy/_detail/config.hpp>
+
+namespace lexy::_detail
+{
+// The hash of a string is computed one character at a time (FNV-1a),
+// so it can be computed while reading the input.
+constexpr std::uint64_t string_hash_init = 0xcbf29ce484222325;
+
+constexpr std::uint64_t string_hash_step(std::uint64_t hash, std::uint64_t c)
+{
+    return (hash ^ c) * 0x100000001b3;
+}
+
+// The final avalanche step of murmurhash3, so every bit of the result depends on every char.
+constexpr std::uint64_t string_hash_finish(std::uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccd;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+// A perfect hash function over a fixed set of keys, which are identified by an index.
+//
+// It is a variant of PTHash: every key is sorted into a bucket based on its hash,
+// and every bucket gets a pilot value, which is chosen such that the pilot moves all keys in the
+// bucket to free slots. A lookup is then a single table access.
+template <std::size_t KeyCount>
+struct perfect_hash
+{
+    static constexpr auto bucket_count = KeyCount / 2 + 1;
+    static constexpr auto slot_count   = KeyCount + KeyCount / 4 + 1;
+    static constexpr auto max_pilot    = std::uint32_t(1) << 16;
+    static constexpr auto no_key       = std::size_t(-1);
+
+    // Whether we have found pilots for all buckets.
+    bool          valid;
+    std::uint32_t pilot[bucket_count];
+    std::size_t   slot_key[slot_count];
+
+    static constexpr std::size_t _bucket(std::uint64_t hash)
+    {
+        return std::size_t((hash >> 32) % bucket_count);
+    }
+    static constexpr std::size_t _slot(std::uint64_t hash, std::uint32_t pilot)
+    {
+        // We need to mix again: otherwise, two keys whose hashes agree in the low bits could end up
+        // in the same slot regardless of the pilot.
+        return std::size_t(string_hash_finish(hash ^ pilot) % slot_count);
+    }
+
+    // Returns the index of the only key that can have the specified (finished) hash,
+    // or no_key if there is none.
+    constexpr std::size_t lookup(std::uint64_t hash) const
+    {
+        return slot_key[_slot(hash, pilot[_bucket(hash)])];
+    }
+
+    // Builds the perfect hash function for the keys with the specified hashes.
+    // Keys that have the same hash are compared using `same_key(i, j)` for i < j;
+    // if they are the same, the later key wins, otherwise we fail.
+    template <typename SameKey>
+    static LEXY_CONSTEVAL perfect_hash build(const std::uint64_t* hashes, SameKey same_key)
+    {
+        perfect_hash result{};
+        for (auto& key : result.slot_key)
+            key = no_key;
+
+        // Sort the keys by their bucket.
+        std::size_t bucket_begin[bucket_count + 1]{};
+        for (auto i = 0u; i != KeyCount; ++i)
+            ++bucket_begin[_bucket(hashes[i]) + 1];
+        for (auto b = 0u; b != bucket_count; ++b)
+            bucket_begin[b + 1] += bucket_begin[b];
+
+        std::size_t bucket_keys[KeyCount == 0 ? 1 : KeyCount]{};
+        std::size_t bucket_end[bucket_count]{};
+        for (auto b = 0u; b != bucket_count; ++b)
+            bucket_end[b] = bucket_begin[b];
+        for (auto i = 0u; i != KeyCount; ++i)
+        {
+            auto b                      = _bucket(hashes[i]);
+            bucket_keys[bucket_end[b]++] = i;
+        }
+
+        // Remove duplicate keys, as they could never be moved to different slots.
+        // Only keys within a bucket can have the same hash and buckets are small.
+        auto max_bucket_size = std::size_t(0);
+        for (auto b = 0u; b != bucket_count; ++b)
+        {
+            auto end = bucket_begin[b];
+            for (auto i = bucket_begin[b]; i != bucket_end[b]; ++i)
+            {
+                auto key = bucket_keys[i];
+
+                auto duplicate = false;
+                for (auto j = i + 1; j != bucket_end[b]; ++j)
+                    if (hashes[bucket_keys[j]] == hashes[key])
+                    {
+                        if (!same_key(key, bucket_keys[j]))
+                            return result; // A genuine hash collision; we can't handle that.
+                        duplicate = true;
+                    }
+
+                if (!duplicate)
+                    bucket_keys[end++] = key;
+            }
+
+            bucket_end[b] = end;
+            if (end - bucket_begin[b] > max_bucket_size)
+                max_bucket_size = end - bucket_begin[b];
+        }
+
+        // Find pilots for the buckets, the biggest ones first, as they're the hardest to place.
+        for (auto size = max_bucket_size; size > 0; --size)
+            for (auto b = 0u; b != bucket_count; ++b)
+            {
+                if (bucket_end[b] - bucket_begin[b] != size)
+                    continue;
+
+                auto pilot = std::uint32_t(0);
+                for (; pilot != max_pilot; ++pilot)
+                {
+                    auto free = true;
+                    for (auto i = bucket_begin[b]; free && i != bucket_end[b]; ++i)
+                    {
+                        auto slot = _slot(hashes[bucket_keys[i]], pilot);
+                        if (result.slot_key[slot] != no_key)
+                            free = false;
+                        // The keys of the bucket must not be moved to the same slot either.
+                        for (auto j = bucket_begin[b]; free && j != i; ++j)
+                            if (_slot(hashes[bucket_keys[j]], pilot) == slot)
+                                free = false;
+                    }
+                    if (free)
+                        break;
+                }
+                if (pilot == max_pilot)
+                    return result;
+
+                result.pilot[b] = pilot;
+                for (auto i = bucket_begin[b]; i != bucket_end[b]; ++i)
+                    result.slot_key[_slot(hashes[bucket_keys[i]], pilot)] = bucket_keys[i];
+            }
+
+        result.valid = true;
+        return result;
+    }
+};
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_PERFECT_HASH_HPP_INCLUDED
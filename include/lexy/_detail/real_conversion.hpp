@@ -0,0 +1,591 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_REAL_CONVERSION_HPP_INCLUDED
+#define LEXY_DETAIL_REAL_CONVERSION_HPP_INCLUDED
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <lexy/_detail/assert.hpp>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/pow5_table.hpp>
+
+// The conversion of a decimal number to a binary floating point number, correctly rounded.
+// It uses the Eisel-Lemire algorithm (https://arxiv.org/abs/2101.11408) as implemented by
+// fast_float, and falls back to a comparison using big integers if that isn't exact.
+
+//=== real_format ===//
+namespace lexy::_detail
+{
+template <typename T>
+struct real_format;
+
+template <>
+struct real_format<float>
+{
+    using bits_type = std::uint32_t;
+
+    static constexpr int mantissa_bits    = 23;
+    static constexpr int minimum_exponent = -127;
+    static constexpr int infinite_power   = 0xFF;
+
+    // Outside of that range of decimal exponents, the result is always zero or infinity.
+    static constexpr int smallest_power_of_ten = -64;
+    static constexpr int largest_power_of_ten  = 38;
+
+    // Only in that range of decimal exponents, the result can be exactly between two floats.
+    static constexpr int min_exponent_round_to_even = -17;
+    static constexpr int max_exponent_round_to_even = 10;
+
+    // The largest power of ten that can be represented exactly.
+    static constexpr int max_exact_power_of_ten = 10;
+
+    // The maximal number of significant digits that can affect rounding.
+    static constexpr std::size_t max_digits = 114;
+};
+
+template <>
+struct real_format<double>
+{
+    using bits_type = std::uint64_t;
+
+    static constexpr int mantissa_bits    = 52;
+    static constexpr int minimum_exponent = -1023;
+    static constexpr int infinite_power   = 0x7FF;
+
+    static constexpr int smallest_power_of_ten = -342;
+    static constexpr int largest_power_of_ten  = 308;
+
+    static constexpr int min_exponent_round_to_even = -4;
+    static constexpr int max_exponent_round_to_even = 23;
+
+    static constexpr int max_exact_power_of_ten = 22;
+
+    static constexpr std::size_t max_digits = 769;
+};
+
+// The biased exponent and the mantissa without the implicit bit of a positive floating point
+// number.
+struct real_bits
+{
+    std::uint64_t mantissa;
+    int           power2;
+
+    friend bool operator==(real_bits lhs, real_bits rhs)
+    {
+        return lhs.mantissa == rhs.mantissa && lhs.power2 == rhs.power2;
+    }
+    friend bool operator!=(real_bits lhs, real_bits rhs)
+    {
+        return !(lhs == rhs);
+    }
+};
+
+template <typename T>
+T real_from_bits(real_bits bits)
+{
+    using format = real_format<T>;
+    static_assert(std::numeric_limits<T>::is_iec559 && sizeof(T) == sizeof(typename format::bits_type));
+
+    auto word = static_cast<typename format::bits_type>(
+        bits.mantissa | (static_cast<std::uint64_t>(bits.power2) << format::mantissa_bits));
+
+    T result;
+    std::memcpy(&result, &word, sizeof(T));
+    return result;
+}
+} // namespace lexy::_detail
+
+//=== digit scanning ===//
+namespace lexy::_detail
+{
+template <typename CharT>
+constexpr unsigned real_digit_value(CharT c)
+{
+    return static_cast<unsigned>(c) - '0';
+}
+
+// Parses the exponent after the 'e' of a number.
+template <typename Iterator>
+constexpr std::int64_t real_scan_exponent(Iterator cur, Iterator end)
+{
+    auto negative = false;
+    if (cur != end && (*cur == '+' || *cur == '-'))
+    {
+        negative = *cur == '-';
+        ++cur;
+    }
+
+    auto result = std::int64_t(0);
+    for (; cur != end; ++cur)
+    {
+        auto digit = real_digit_value(*cur);
+        if (digit >= 10)
+            break;
+
+        // Anything bigger is out of range anyway.
+        if (result < 0x10000)
+            result = 10 * result + digit;
+    }
+    return negative ? -result : result;
+}
+
+struct real_digits
+{
+    // The decimal exponent of the last significant digit.
+    std::int64_t exponent;
+    // Whether a non-zero digit was dropped.
+    bool truncated;
+};
+
+// Calls `add_digit(digit)` for at most the first `max_digits` significant digits of the number,
+// which has the syntax of `dsl::real`.
+template <typename Iterator, typename Fn>
+constexpr real_digits real_scan_digits(Iterator cur, Iterator end, std::size_t max_digits,
+                                       Fn add_digit)
+{
+    real_digits result{0, false};
+    auto        digit_count = std::size_t(0);
+
+    for (; cur != end; ++cur)
+    {
+        auto digit = real_digit_value(*cur);
+        if (digit >= 10)
+            break;
+
+        if (digit_count == max_digits)
+        {
+            ++result.exponent;
+            result.truncated |= digit != 0;
+        }
+        else if (digit_count > 0 || digit != 0)
+        {
+            add_digit(digit);
+            ++digit_count;
+        }
+    }
+
+    if (cur != end && *cur == '.')
+    {
+        for (++cur; cur != end; ++cur)
+        {
+            auto digit = real_digit_value(*cur);
+            if (digit >= 10)
+                break;
+
+            if (digit_count == max_digits)
+            {
+                result.truncated |= digit != 0;
+            }
+            else
+            {
+                // Leading zeros aren't significant, but they still change the exponent.
+                --result.exponent;
+                if (digit_count > 0 || digit != 0)
+                {
+                    add_digit(digit);
+                    ++digit_count;
+                }
+            }
+        }
+    }
+
+    if (cur != end && (*cur == 'e' || *cur == 'E'))
+        result.exponent += real_scan_exponent(++cur, end);
+
+    return result;
+}
+} // namespace lexy::_detail
+
+//=== Eisel-Lemire ===//
+namespace lexy::_detail
+{
+struct real_uint128
+{
+    std::uint64_t high;
+    std::uint64_t low;
+};
+
+inline real_uint128 real_multiply(std::uint64_t lhs, std::uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+    __extension__ typedef unsigned __int128 uint128;
+
+    auto product = static_cast<uint128>(lhs) * rhs;
+    return {static_cast<std::uint64_t>(product >> 64), static_cast<std::uint64_t>(product)};
+#else
+    auto lhs_lo = lhs & 0xFFFF'FFFF;
+    auto lhs_hi = lhs >> 32;
+    auto rhs_lo = rhs & 0xFFFF'FFFF;
+    auto rhs_hi = rhs >> 32;
+
+    auto lo_lo = lhs_lo * rhs_lo;
+    auto hi_lo = lhs_hi * rhs_lo;
+    auto lo_hi = lhs_lo * rhs_hi;
+    auto hi_hi = lhs_hi * rhs_hi;
+
+    auto cross = (lo_lo >> 32) + (hi_lo & 0xFFFF'FFFF) + lo_hi;
+    return {hi_hi + (hi_lo >> 32) + (cross >> 32), (cross << 32) | (lo_lo & 0xFFFF'FFFF)};
+#endif
+}
+
+// Requires: value != 0.
+inline int real_leading_zeros(std::uint64_t value)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(value);
+#elif defined(_MSC_VER)
+    unsigned long bit_idx;
+    _BitScanReverse64(&bit_idx, value);
+    return 63 - int(bit_idx);
+#else
+#    error "unsupported compiler; please file an issue"
+#endif
+}
+
+// Returns the approximate value of w * 5^q, with `Precision` correct bits.
+template <int Precision>
+real_uint128 real_product_approximation(int q, std::uint64_t w)
+{
+    auto index = 2 * static_cast<std::size_t>(q - pow5_table_smallest_power);
+
+    // For small q, the first product is already exact.
+    auto product = real_multiply(w, pow5_table[index]);
+
+    constexpr auto precision_mask = std::uint64_t(0xFFFF'FFFF'FFFF'FFFF) >> Precision;
+    if ((product.high & precision_mask) == precision_mask)
+    {
+        auto low = real_multiply(w, pow5_table[index + 1]);
+        product.low += low.high;
+        if (low.high > product.low)
+            ++product.high;
+    }
+    return product;
+}
+
+// Returns floor(log2(10^q)) + 63.
+constexpr int real_binary_power(int q)
+{
+    return (((152170 + 65536) * q) >> 16) + 63;
+}
+
+// Returns w * 10^q rounded to the nearest floating point number.
+// If w has been truncated, the true value might be rounded differently.
+template <typename T>
+real_bits real_compute(std::int64_t q, std::uint64_t w)
+{
+    using format = real_format<T>;
+    if (w == 0 || q < format::smallest_power_of_ten)
+        return {0, 0};
+    else if (q > format::largest_power_of_ten)
+        return {0, format::infinite_power};
+
+    // Normalize w, then compute the product with one more bit than needed, plus one bit to
+    // detect rounding, plus one more bit as the product might not have its upper bit set.
+    auto leading_zeros = real_leading_zeros(w);
+    w <<= leading_zeros;
+    auto product = real_product_approximation<format::mantissa_bits + 3>(int(q), w);
+    // Thanks to the fixed number of digits, the product is always precise enough.
+    // See https://arxiv.org/abs/2212.06644.
+
+    auto upper_bit = int(product.high >> 63);
+    auto shift     = upper_bit + 64 - format::mantissa_bits - 3;
+
+    real_bits result;
+    result.mantissa = product.high >> shift;
+    result.power2
+        = real_binary_power(int(q)) + upper_bit - leading_zeros - format::minimum_exponent;
+
+    if (result.power2 <= 0)
+    {
+        // We have a subnormal number.
+        if (-result.power2 + 1 >= 64)
+            return {0, 0};
+
+        result.mantissa >>= -result.power2 + 1;
+        // Round up; we can't be exactly between two subnormals.
+        result.mantissa += result.mantissa & 1;
+        result.mantissa >>= 1;
+
+        // Rounding up can result in the smallest normal number.
+        result.power2 = result.mantissa < (std::uint64_t(1) << format::mantissa_bits) ? 0 : 1;
+        return result;
+    }
+
+    if (product.low <= 1 && q >= format::min_exponent_round_to_even
+        && q <= format::max_exponent_round_to_even && (result.mantissa & 3) == 1)
+    {
+        // We're exactly between two floats if we've only shifted out zeros,
+        // then we round down to even.
+        if ((result.mantissa << shift) == product.high)
+            result.mantissa &= ~std::uint64_t(1);
+    }
+
+    result.mantissa += result.mantissa & 1;
+    result.mantissa >>= 1;
+    if (result.mantissa >= (std::uint64_t(2) << format::mantissa_bits))
+    {
+        // Rounding up has overflown the mantissa.
+        result.mantissa = std::uint64_t(1) << format::mantissa_bits;
+        ++result.power2;
+    }
+    result.mantissa &= ~(std::uint64_t(1) << format::mantissa_bits);
+
+    if (result.power2 >= format::infinite_power)
+        return {0, format::infinite_power};
+    return result;
+}
+} // namespace lexy::_detail
+
+//=== slow path ===//
+namespace lexy::_detail
+{
+// An unsigned integer big enough to hold all values of the slow path.
+class real_bigint
+{
+public:
+    explicit real_bigint(std::uint64_t value) : _limbs{}, _size(0)
+    {
+        for (; value != 0; value >>= 32)
+            _limbs[_size++] = static_cast<std::uint32_t>(value);
+    }
+
+    void multiply(std::uint32_t factor)
+    {
+        auto carry = std::uint64_t(0);
+        for (auto i = std::size_t(0); i != _size; ++i)
+        {
+            carry += std::uint64_t(_limbs[i]) * factor;
+            _limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        push(carry);
+    }
+
+    void multiply_pow5(std::size_t exponent)
+    {
+        constexpr std::uint32_t pow5[] = {1,     5,      25,      125,      625,      3125,     15625,
+                                          78125, 390625, 1953125, 9765625, 48828125, 244140625,
+                                          1220703125};
+        for (; exponent >= 13; exponent -= 13)
+            multiply(pow5[13]);
+        multiply(pow5[exponent]);
+    }
+
+    void add(std::uint32_t value)
+    {
+        auto carry = std::uint64_t(value);
+        for (auto i = std::size_t(0); i != _size && carry != 0; ++i)
+        {
+            carry += _limbs[i];
+            _limbs[i] = static_cast<std::uint32_t>(carry);
+            carry >>= 32;
+        }
+        // We only have a carry left if we've propagated it through all limbs.
+        push(carry);
+    }
+
+    void shift_left(std::size_t bits)
+    {
+        auto limbs = bits / 32;
+        bits %= 32;
+        if (_size == 0)
+            return;
+
+        LEXY_PRECONDITION(_size + limbs < capacity);
+        _limbs[_size + limbs] = 0;
+        for (auto i = _size; i != 0; --i)
+        {
+            auto value = std::uint64_t(_limbs[i - 1]) << bits;
+            _limbs[i + limbs] |= static_cast<std::uint32_t>(value >> 32);
+            _limbs[i - 1 + limbs] = static_cast<std::uint32_t>(value);
+        }
+        for (auto i = std::size_t(0); i != limbs; ++i)
+            _limbs[i] = 0;
+
+        _size += limbs + 1;
+        if (_limbs[_size - 1] == 0)
+            --_size;
+    }
+
+    friend int compare(const real_bigint& lhs, const real_bigint& rhs)
+    {
+        if (lhs._size != rhs._size)
+            return lhs._size < rhs._size ? -1 : 1;
+
+        for (auto i = lhs._size; i != 0; --i)
+            if (lhs._limbs[i - 1] != rhs._limbs[i - 1])
+                return lhs._limbs[i - 1] < rhs._limbs[i - 1] ? -1 : 1;
+        return 0;
+    }
+
+private:
+    void push(std::uint64_t carry)
+    {
+        if (carry != 0)
+        {
+            LEXY_PRECONDITION(_size < capacity);
+            _limbs[_size++] = static_cast<std::uint32_t>(carry);
+        }
+    }
+
+    // Enough for all significant digits of a double and the halfway point shifted to them.
+    static constexpr std::size_t capacity = 4096 / 32;
+
+    std::uint32_t _limbs[capacity];
+    std::size_t   _size;
+};
+
+// Returns the correctly rounded value of the number, if `lower` is either that or the float
+// below it.
+template <typename T, typename Iterator>
+real_bits real_compute_slow(Iterator begin, Iterator end, real_bits lower)
+{
+    using format = real_format<T>;
+
+    // The significant digits as a big integer, in chunks of nine digits.
+    auto digits      = real_bigint(0);
+    auto chunk       = std::uint32_t(0);
+    auto chunk_size  = 0u;
+    auto decimal     = real_scan_digits(begin, end, format::max_digits, [&](unsigned digit) {
+        chunk = chunk * 10 + digit;
+        if (++chunk_size == 9)
+        {
+            digits.multiply(1'000'000'000);
+            digits.add(chunk);
+            chunk      = 0;
+            chunk_size = 0;
+        }
+    });
+    constexpr std::uint32_t pow10[] = {1, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000,
+                                       100'000'000};
+    digits.multiply(pow10[chunk_size]);
+    digits.add(chunk);
+
+    // The point halfway between lower and the next float is halfway * 2^halfway_exponent.
+    auto significand = lower.mantissa;
+    auto exponent    = lower.power2;
+    if (exponent == 0)
+        exponent = 1;
+    else
+        significand |= std::uint64_t(1) << format::mantissa_bits;
+    auto halfway          = real_bigint(2 * significand + 1);
+    auto halfway_exponent = std::int64_t(exponent + format::minimum_exponent)
+                            - format::mantissa_bits - 1;
+
+    // Compare digits * 10^decimal.exponent with the halfway point:
+    // we move the power of five and the difference in powers of two to one side.
+    if (decimal.exponent >= 0)
+        digits.multiply_pow5(static_cast<std::size_t>(decimal.exponent));
+    else
+        halfway.multiply_pow5(static_cast<std::size_t>(-decimal.exponent));
+
+    auto shift = decimal.exponent - halfway_exponent;
+    if (shift >= 0)
+        digits.shift_left(static_cast<std::size_t>(shift));
+    else
+        halfway.shift_left(static_cast<std::size_t>(-shift));
+
+    auto order = compare(digits, halfway);
+    if (order == 0 && decimal.truncated)
+        // We've dropped some digits, so we're actually above it.
+        order = 1;
+
+    if (order > 0 || (order == 0 && (lower.mantissa & 1) != 0))
+    {
+        // Round up to the next float, which might overflow into the exponent.
+        ++lower.mantissa;
+        if (lower.mantissa == std::uint64_t(1) << format::mantissa_bits)
+        {
+            lower.mantissa = 0;
+            ++lower.power2;
+        }
+    }
+    return lower;
+}
+} // namespace lexy::_detail
+
+//=== parse_real ===//
+namespace lexy::_detail
+{
+// We can only compute with exactly representable values if there is no excess precision.
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+constexpr bool real_has_fast_path = true;
+#else
+constexpr bool real_has_fast_path = false;
+#endif
+
+// Converts the number, which has the syntax of `dsl::real`, into a float or double.
+template <typename T, typename Iterator>
+T parse_real(Iterator begin, Iterator end)
+{
+    using format = real_format<T>;
+
+    // Parse all digits into the mantissa, ignoring overflow for now.
+    auto mantissa    = std::uint64_t(0);
+    auto digit_count = std::size_t(0);
+    auto exponent    = std::int64_t(0);
+
+    auto cur = begin;
+    for (; cur != end; ++cur, ++digit_count)
+    {
+        auto digit = real_digit_value(*cur);
+        if (digit >= 10)
+            break;
+        mantissa = 10 * mantissa + digit;
+    }
+    if (cur != end && *cur == '.')
+    {
+        for (++cur; cur != end; ++cur, ++digit_count, --exponent)
+        {
+            auto digit = real_digit_value(*cur);
+            if (digit >= 10)
+                break;
+            mantissa = 10 * mantissa + digit;
+        }
+    }
+    if (cur != end && (*cur == 'e' || *cur == 'E'))
+        exponent += real_scan_exponent(++cur, end);
+
+    // If we had more than 19 digits, the mantissa might have overflown.
+    // Then we need to parse it again, but only use the first 19 significant digits.
+    auto truncated = false;
+    if (digit_count > 19)
+    {
+        mantissa     = 0;
+        auto decimal = real_scan_digits(begin, end, 19,
+                                        [&](unsigned digit) { mantissa = 10 * mantissa + digit; });
+        exponent     = decimal.exponent;
+        truncated    = decimal.truncated;
+    }
+
+    if constexpr (real_has_fast_path)
+    {
+        // If both the mantissa and the power of ten are exactly representable,
+        // a single floating point operation is correctly rounded.
+        constexpr double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        if (!truncated && mantissa <= (std::uint64_t(2) << format::mantissa_bits)
+            && exponent >= -format::max_exact_power_of_ten
+            && exponent <= format::max_exact_power_of_ten)
+        {
+            auto value = static_cast<T>(mantissa);
+            if (exponent < 0)
+                return value / static_cast<T>(pow10[-exponent]);
+            else
+                return value * static_cast<T>(pow10[exponent]);
+        }
+    }
+
+    auto bits = real_compute<T>(exponent, mantissa);
+    if (truncated && bits != real_compute<T>(exponent, mantissa + 1))
+        // The digits we've dropped can change the rounding, so we need to consider all of them.
+        bits = real_compute_slow<T>(begin, end, bits);
+    return real_from_bits<T>(bits);
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_REAL_CONVERSION_HPP_INCLUDED
@@ -0,0 +1,356 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_SIMD_HPP_INCLUDED
+#define LEXY_DETAIL_SIMD_HPP_INCLUDED
+
+#include <cstdint>
+#include <lexy/_detail/config.hpp>
+
+//=== instruction sets ===//
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#    define LEXY_IS_X86 1
+#else
+#    define LEXY_IS_X86 0
+#endif
+
+#ifndef LEXY_HAS_SSE2
+#    if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#        define LEXY_HAS_SSE2 1
+#    else
+#        define LEXY_HAS_SSE2 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_SSSE3
+#    if defined(__SSSE3__)
+#        define LEXY_HAS_SSSE3 1
+#    else
+#        define LEXY_HAS_SSSE3 0
+#    endif
+#endif
+
+#ifndef LEXY_HAS_AVX2
+#    if defined(__AVX2__)
+#        define LEXY_HAS_AVX2 1
+#    else
+#        define LEXY_HAS_AVX2 0
+#    endif
+#endif
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+#if LEXY_HAS_AVX2
+#    include <immintrin.h>
+#elif LEXY_HAS_SSSE3
+#    include <tmmintrin.h>
+#elif LEXY_HAS_SSE2
+#    include <emmintrin.h>
+#endif
+
+// Whether readers and rules use SIMD in addition to SWAR.
+#ifndef LEXY_HAS_SIMD
+#    define LEXY_HAS_SIMD LEXY_HAS_SSE2
+#endif
+
+// Whether SIMD can match arbitrary char classes; requires a byte shuffle.
+#if LEXY_HAS_SIMD && (LEXY_HAS_SSSE3 || LEXY_HAS_AVX2)
+#    define LEXY_HAS_SIMD_SHUFFLE 1
+#else
+#    define LEXY_HAS_SIMD_SHUFFLE 0
+#endif
+
+// Whether the kernels of lexy_simd are available, which select the instruction set at runtime.
+// It changes the definition of inline functions, so it must be the same in every translation unit
+// of a program: lexy_simd defines it publicly, and everything that links lexy_file links it as well.
+// Declarations and class layouts don't depend on it.
+#ifndef LEXY_HAS_SIMD_DISPATCH
+#    define LEXY_HAS_SIMD_DISPATCH 0
+#endif
+
+// Whether rules call the kernels of lexy_simd instead of the inline SIMD code.
+// If we're allowed to use AVX2 anyway, there is nothing better to dispatch to.
+#if LEXY_HAS_SIMD_DISPATCH && !LEXY_HAS_AVX2
+#    define LEXY_USE_SIMD_DISPATCH 1
+#else
+#    define LEXY_USE_SIMD_DISPATCH 0
+#endif
+
+//=== simd_int ===//
+namespace lexy::_detail
+{
+// The number of bytes in a SIMD register, or zero if SIMD isn't used.
+constexpr std::size_t simd_width = !LEXY_HAS_SIMD ? 0 : LEXY_HAS_AVX2 ? 32 : 16;
+
+// The number of bytes that are read at once by the widest SIMD code, including the kernels.
+// It determines the padding of buffers, so it must be the same in every translation unit:
+// it can't depend on the instruction set flags or whether lexy_simd is linked.
+constexpr std::size_t simd_max_width = LEXY_IS_X86 ? 32 : simd_width;
+
+// The number of chars that need to be readable after the EOF sentinel, so SIMD can be used.
+// We only use SIMD for single byte encodings.
+template <typename CharT>
+constexpr std::size_t simd_padding = sizeof(CharT) == 1 ? simd_max_width : 0;
+
+// A lookup table for a set of ASCII characters, indexed by the low and high nibble of a char.
+// A char `c` is in the set if `lo[c & 0xF] & hi[c >> 4]` is non-zero.
+struct simd_char_table
+{
+    unsigned char lo[16];
+    unsigned char hi[16];
+};
+
+struct simd_pack_result
+{
+    unsigned char value[simd_width == 0 ? 1 : simd_width];
+    // One bit per byte of value that is part of the pack.
+    std::uint32_t mask;
+    std::size_t   count;
+};
+
+// Returns the bytes of the specified chars to load into a SIMD register.
+// If more are provided than fit, will only take the first couple ones.
+template <std::size_t SkipFirstNChars = 0, typename... CharT>
+constexpr simd_pack_result simd_pack(CharT... cs)
+{
+    static_assert(((sizeof(CharT) == 1) && ...), "SIMD is only used for single byte encodings");
+    simd_pack_result result{};
+
+    const unsigned char chars[] = {static_cast<unsigned char>(cs)..., 0};
+    for (auto i = SkipFirstNChars; i < sizeof...(CharT) && result.count != simd_width; ++i)
+    {
+        result.value[result.count] = chars[i];
+        result.mask |= std::uint32_t(1) << result.count;
+        ++result.count;
+    }
+
+    return result;
+}
+
+#if LEXY_HAS_SIMD
+#    if LEXY_HAS_AVX2
+using simd_int = __m256i;
+
+inline simd_int simd_load(const void* ptr)
+{
+    return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+}
+inline simd_int simd_fill(unsigned char c)
+{
+    return _mm256_set1_epi8(static_cast<char>(c));
+}
+// Returns a bit mask with one bit per byte that is set if the byte is equal to c.
+inline std::uint32_t simd_eq_mask(simd_int v, simd_int c)
+{
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, c)));
+}
+inline simd_int simd_min(simd_int lhs, simd_int rhs)
+{
+    return _mm256_min_epu8(lhs, rhs);
+}
+inline simd_int simd_or(simd_int lhs, simd_int rhs)
+{
+    return _mm256_or_si256(lhs, rhs);
+}
+// Returns a bit mask with one bit per byte that is set if the high bit of the byte is set.
+inline std::uint32_t simd_high_mask(simd_int v)
+{
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(v));
+}
+#    else
+using simd_int = __m128i;
+
+inline simd_int simd_load(const void* ptr)
+{
+    return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+}
+inline simd_int simd_fill(unsigned char c)
+{
+    return _mm_set1_epi8(static_cast<char>(c));
+}
+inline std::uint32_t simd_eq_mask(simd_int v, simd_int c)
+{
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, c)));
+}
+inline simd_int simd_min(simd_int lhs, simd_int rhs)
+{
+    return _mm_min_epu8(lhs, rhs);
+}
+inline simd_int simd_or(simd_int lhs, simd_int rhs)
+{
+    return _mm_or_si128(lhs, rhs);
+}
+inline std::uint32_t simd_high_mask(simd_int v)
+{
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+}
+#    endif
+
+// The mask returned by simd_eq_mask() if all bytes are equal.
+constexpr std::uint32_t simd_full_mask = simd_width == 32 ? 0xFFFF'FFFF : 0xFFFF;
+
+// Returns true if v contains the specified char.
+template <typename CharT, CharT C>
+bool simd_has_char(simd_int v)
+{
+    return simd_eq_mask(v, simd_fill(static_cast<unsigned char>(C))) != 0;
+}
+
+// Returns true if v contains only the specified char.
+template <typename CharT, CharT C>
+bool simd_all_char(simd_int v)
+{
+    return simd_eq_mask(v, simd_fill(static_cast<unsigned char>(C))) == simd_full_mask;
+}
+
+// Returns true if v has a char less than N.
+template <typename CharT, CharT N>
+bool simd_has_char_less(simd_int v)
+{
+    static_assert(N > 0);
+    // v[i] < N iff min(v[i], N - 1) == v[i].
+    auto max = simd_fill(static_cast<unsigned char>(N - 1));
+    return simd_eq_mask(simd_min(v, max), v) != 0;
+}
+
+// Returns the index of the first byte whose bit is set in the mask.
+// Requires: mask != 0.
+inline std::size_t simd_find_first_set(std::uint32_t mask)
+{
+#    if defined(__GNUC__)
+    auto bit_idx = __builtin_ctz(mask);
+#    elif defined(_MSC_VER)
+    unsigned long bit_idx;
+    _BitScanForward(&bit_idx, mask);
+#    else
+#        error "unsupported compiler; please file an issue"
+#    endif
+    return static_cast<std::size_t>(bit_idx);
+}
+
+#    if LEXY_HAS_SIMD_SHUFFLE
+// Returns a bit mask with one bit per byte that is set if the char is not in the table.
+inline std::uint32_t simd_table_mismatch_mask(simd_int v, const simd_char_table& table)
+{
+#        if LEXY_HAS_AVX2
+    // The shuffle works on each 128 bit lane separately, so we need the table in both.
+    auto lo_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(table.lo)));
+    auto hi_table = _mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(table.hi)));
+
+    auto nibble_mask = _mm256_set1_epi8(0x0F);
+    auto lo          = _mm256_and_si256(v, nibble_mask);
+    auto hi          = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask);
+
+    auto bits = _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo),
+                                 _mm256_shuffle_epi8(hi_table, hi));
+    return static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(bits, _mm256_setzero_si256())));
+#        else
+    auto lo_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo));
+    auto hi_table = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi));
+
+    auto nibble_mask = _mm_set1_epi8(0x0F);
+    auto lo          = _mm_and_si128(v, nibble_mask);
+    auto hi          = _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask);
+
+    auto bits = _mm_and_si128(_mm_shuffle_epi8(lo_table, lo), _mm_shuffle_epi8(hi_table, hi));
+    return static_cast<std::uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(bits, _mm_setzero_si128())));
+#        endif
+}
+
+// Returns true if all chars of v are in the table.
+inline bool simd_match_table(simd_int v, const simd_char_table& table)
+{
+    return simd_table_mismatch_mask(v, table) == 0;
+}
+#    endif
+#endif
+} // namespace lexy::_detail
+
+//=== simd dispatch ===//
+namespace lexy::_detail
+{
+// The kernels are implemented in lexy_simd; they're only called if LEXY_HAS_SIMD_DISPATCH is set.
+// On the first call, they select the best implementation for the CPU; the SWAR one is the
+// fallback.
+
+// Returns a pointer to the first char that is not in the table.
+// Requires that the input is terminated by a char that is not in the table (e.g. EOF) followed
+// by `simd_max_width` readable bytes.
+const unsigned char* simd_find_class_end(const unsigned char*  ptr,
+                                         const simd_char_table& table) noexcept;
+
+// Returns a pointer to the first char that is equal to `a` or `b`.
+// Requires that one of them occurs before the end of the input, followed by `simd_max_width`
+// readable bytes.
+const unsigned char* simd_find_either(const unsigned char* ptr, unsigned char a,
+                                      unsigned char b) noexcept;
+
+// Returns the number of occurrences of `c` in the range.
+std::size_t simd_count_char(const unsigned char* begin, const unsigned char* end,
+                            unsigned char c) noexcept;
+} // namespace lexy::_detail
+
+//=== simd_reader_base ===//
+namespace lexy::_detail
+{
+struct _simd_base
+{};
+template <typename Reader>
+constexpr auto is_simd_reader = std::is_base_of_v<_simd_base, Reader>;
+
+// A reader can use SIMD if it has a sentinel and at least `simd_padding` chars after it.
+template <typename Derived, bool Enabled>
+class simd_reader_base
+{};
+
+template <typename Derived>
+class simd_reader_base<Derived, true> : _simd_base
+{
+public:
+#if LEXY_HAS_SIMD
+    simd_int peek_simd() const
+    {
+        return simd_load(static_cast<const Derived&>(*this).position());
+    }
+
+    void bump_simd()
+    {
+        auto ptr = static_cast<Derived&>(*this).position();
+        ptr += simd_width;
+        static_cast<Derived&>(*this).reset({ptr});
+    }
+
+    // Bumps only the specified number of chars, which must be at most `simd_width`.
+    void bump_simd(std::size_t count)
+    {
+        auto ptr = static_cast<Derived&>(*this).position();
+        ptr += count;
+        static_cast<Derived&>(*this).reset({ptr});
+    }
+#endif
+
+    // The position as a pointer for the kernels.
+    const unsigned char* simd_position() const
+    {
+        return reinterpret_cast<const unsigned char*>(
+            static_cast<const Derived&>(*this).position());
+    }
+
+    // Moves the reader to a position returned by a kernel.
+    void bump_simd_to(const unsigned char* pos)
+    {
+        auto ptr = static_cast<Derived&>(*this).position();
+        ptr += pos - simd_position();
+        static_cast<Derived&>(*this).reset({ptr});
+    }
+};
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_SIMD_HPP_INCLUDED
+
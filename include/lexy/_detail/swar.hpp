@@ -8,7 +8,6 @@
 #include <cstdint>
 #include <cstring>
 #include <lexy/_detail/config.hpp>
-#include <lexy/input/base.hpp>
 
 #if defined(_MSC_VER)
 #    include <intrin.h>
@@ -190,32 +189,43 @@ constexpr bool swar_has_char(swar_int v)
 
 namespace lexy::_detail
 {
+// The char that fills the SWAR padding after the input.
+// If char_type == int_type, it is the EOF sentinel.
+// Otherwise, it can also be a valid char, so SWAR loops can only use it as a hint that EOF might
+// have been reached and need to check in more detail.
+template <typename Encoding>
+constexpr auto swar_eof = static_cast<typename Encoding::char_type>(Encoding::eof());
+
 struct _swar_base
 {};
 template <typename Reader>
 constexpr auto is_swar_reader = std::is_base_of_v<_swar_base, Reader>;
 
+// Loads the `swar_length<CharT>` chars starting at ptr.
+template <typename CharT>
+swar_int swar_load(const CharT* ptr)
+{
+    swar_int result;
+#if LEXY_IS_LITTLE_ENDIAN
+    std::memcpy(&result, ptr, sizeof(swar_int));
+#else
+    auto dst    = reinterpret_cast<char*>(&result);
+    auto length = sizeof(swar_int) / sizeof(CharT);
+    for (auto i = 0u; i != length; ++i)
+    {
+        std::memcpy(dst + i, ptr + length - i - 1, sizeof(CharT));
+    }
+#endif
+    return result;
+}
+
 template <typename Derived>
 class swar_reader_base : _swar_base
 {
 public:
     swar_int peek_swar() const
     {
-        auto ptr = static_cast<const Derived&>(*this).position();
-
-        swar_int result;
-#if LEXY_IS_LITTLE_ENDIAN
-        std::memcpy(&result, ptr, sizeof(swar_int));
-#else
-        using char_type = typename Derived::encoding::char_type;
-        auto dst        = reinterpret_cast<char*>(&result);
-        auto length     = sizeof(swar_int) / sizeof(char_type);
-        for (auto i = 0u; i != length; ++i)
-        {
-            std::memcpy(dst + i, ptr + length - i - 1, sizeof(char_type));
-        }
-#endif
-        return result;
+        return swar_load(static_cast<const Derived&>(*this).position());
     }
 
     void bump_swar()
@@ -0,0 +1,277 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_TRANSCODE_HPP_INCLUDED
+#define LEXY_DETAIL_TRANSCODE_HPP_INCLUDED
+
+#include <cstring>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/simd.hpp>
+
+//=== byte swap ===//
+namespace lexy::_detail
+{
+// Loads a code unit from unaligned memory, reversing its bytes if `Swap` is true.
+template <typename CharT, bool Swap>
+CharT load_code_unit(const unsigned char* memory) noexcept
+{
+    CharT result;
+    if constexpr (Swap)
+    {
+        unsigned char bytes[sizeof(CharT)];
+        for (auto i = 0u; i != sizeof(CharT); ++i)
+            bytes[i] = memory[sizeof(CharT) - 1 - i];
+        std::memcpy(&result, bytes, sizeof(CharT));
+    }
+    else
+    {
+        std::memcpy(&result, memory, sizeof(CharT));
+    }
+    return result;
+}
+
+#if LEXY_HAS_SSE2
+// Reverses the bytes of each code unit in the vector.
+template <typename CharT>
+__m128i byte_swap(__m128i v) noexcept
+{
+#    if LEXY_HAS_SSSE3
+    if constexpr (sizeof(CharT) == 2)
+        return _mm_shuffle_epi8(v, _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15,
+                                                 14));
+    else
+        return _mm_shuffle_epi8(v, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13,
+                                                 12));
+#    else
+    // Swap the bytes of each 16 bit lane.
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    if constexpr (sizeof(CharT) == 4)
+    {
+        // Swap the 16 bit lanes of each 32 bit lane.
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+    return v;
+#    endif
+}
+#endif
+
+#if LEXY_HAS_AVX2
+template <typename CharT>
+__m256i byte_swap(__m256i v) noexcept
+{
+    // The shuffle works on each 128 bit lane separately, so the mask is repeated.
+    if constexpr (sizeof(CharT) == 2)
+        return _mm256_shuffle_epi8(v, _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13,
+                                                       12, 15, 14, 1, 0, 3, 2, 5, 4, 7, 6, 9, 8,
+                                                       11, 10, 13, 12, 15, 14));
+    else
+        return _mm256_shuffle_epi8(v, _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15,
+                                                       14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4, 11, 10,
+                                                       9, 8, 15, 14, 13, 12));
+}
+#endif
+
+// Copies `count` code units from `src` to `dest`, reversing the bytes of each one.
+template <typename CharT>
+void copy_byte_swapped(CharT* dest, const unsigned char* src, std::size_t count) noexcept
+{
+    static_assert(sizeof(CharT) == 2 || sizeof(CharT) == 4);
+
+    auto i = std::size_t(0);
+#if LEXY_HAS_AVX2
+    constexpr auto avx_length = sizeof(__m256i) / sizeof(CharT);
+    for (; count - i >= avx_length; i += avx_length)
+    {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * sizeof(CharT)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), byte_swap<CharT>(v));
+    }
+#endif
+#if LEXY_HAS_SSE2
+    constexpr auto sse_length = sizeof(__m128i) / sizeof(CharT);
+    for (; count - i >= sse_length; i += sse_length)
+    {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * sizeof(CharT)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), byte_swap<CharT>(v));
+    }
+#endif
+
+    for (; i != count; ++i)
+        dest[i] = load_code_unit<CharT, true>(src + i * sizeof(CharT));
+}
+} // namespace lexy::_detail
+
+//=== UTF-16 to UTF-8 ===//
+namespace lexy::_detail
+{
+// Decodes the code point starting at code unit `i`, advancing `i` past it.
+// A surrogate that isn't part of a valid pair is replaced by U+FFFD and counted in `invalid`.
+// Both are encoded using three UTF-8 code units, so the length doesn't depend on it.
+template <bool Swap>
+char32_t decode_utf16(const unsigned char* src, std::size_t count, std::size_t& i,
+                      std::size_t& invalid) noexcept
+{
+    auto lead = load_code_unit<char16_t, Swap>(src + 2 * i);
+    ++i;
+
+    if (lead < 0xD800 || lead > 0xDFFF)
+        return lead;
+
+    if (lead <= 0xDBFF && i != count)
+    {
+        auto trail = load_code_unit<char16_t, Swap>(src + 2 * i);
+        if (trail >= 0xDC00 && trail <= 0xDFFF)
+        {
+            ++i;
+            return char32_t(0x10000) + (char32_t(lead - 0xD800) << 10)
+                   + char32_t(trail - 0xDC00);
+        }
+    }
+
+    ++invalid;
+    return 0xFFFD;
+}
+
+constexpr std::size_t utf8_length(char32_t cp) noexcept
+{
+    if (cp <= 0x7F)
+        return 1;
+    else if (cp <= 0x7FF)
+        return 2;
+    else if (cp <= 0xFFFF)
+        return 3;
+    else
+        return 4;
+}
+
+// Encodes the code point as UTF-8.
+template <typename CharT>
+CharT* encode_utf8(CharT* dest, char32_t cp) noexcept
+{
+    if (cp <= 0x7F)
+    {
+        *dest++ = CharT(cp);
+    }
+    else if (cp <= 0x7FF)
+    {
+        *dest++ = CharT(0xC0 | (cp >> 6));
+        *dest++ = CharT(0x80 | (cp & 0x3F));
+    }
+    else if (cp <= 0xFFFF)
+    {
+        *dest++ = CharT(0xE0 | (cp >> 12));
+        *dest++ = CharT(0x80 | ((cp >> 6) & 0x3F));
+        *dest++ = CharT(0x80 | (cp & 0x3F));
+    }
+    else
+    {
+        *dest++ = CharT(0xF0 | (cp >> 18));
+        *dest++ = CharT(0x80 | ((cp >> 12) & 0x3F));
+        *dest++ = CharT(0x80 | ((cp >> 6) & 0x3F));
+        *dest++ = CharT(0x80 | (cp & 0x3F));
+    }
+    return dest;
+}
+
+#if LEXY_HAS_SSE2
+// Loads eight UTF-16 code units in native endianness.
+template <bool Swap>
+__m128i load_utf16_block(const unsigned char* src) noexcept
+{
+    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    if constexpr (Swap)
+        v = byte_swap<char16_t>(v);
+    return v;
+}
+
+// Returns a bit mask of the code units where `(unit & mask) == value`; two bits per code unit.
+inline unsigned utf16_block_match(__m128i v, short mask, short value) noexcept
+{
+    auto masked = _mm_and_si128(v, _mm_set1_epi16(mask));
+    return unsigned(_mm_movemask_epi8(_mm_cmpeq_epi16(masked, _mm_set1_epi16(value))));
+}
+
+inline std::size_t utf16_block_count(unsigned mask) noexcept
+{
+    auto result = std::size_t(0);
+    for (; mask != 0; mask &= mask - 1)
+        ++result;
+    return result / 2;
+}
+#endif
+
+// Returns the number of UTF-8 code units necessary to encode the `count` UTF-16 code units.
+// `invalid` is set to the number of surrogates that aren't part of a valid pair.
+template <bool Swap>
+std::size_t utf8_length_of_utf16(const unsigned char* src, std::size_t count,
+                                 std::size_t& invalid) noexcept
+{
+    invalid = 0;
+
+    auto result = std::size_t(0);
+    auto i      = std::size_t(0);
+#if LEXY_HAS_SSE2
+    while (count - i >= 8)
+    {
+        auto v = load_utf16_block<Swap>(src + 2 * i);
+
+        // We check the entire block for surrogates at once, which are rare.
+        // Without them, we can determine the length of each code unit independently.
+        auto surrogates = utf16_block_match(v, short(0xF800), short(0xD800));
+        if (surrogates == 0)
+        {
+            auto one_byte = utf16_block_count(utf16_block_match(v, short(0xFF80), 0));
+            auto two_byte = utf16_block_count(utf16_block_match(v, short(0xF800), 0)) - one_byte;
+            result += one_byte + 2 * two_byte + 3 * (8 - one_byte - two_byte);
+            i += 8;
+        }
+        else
+        {
+            // Handle the block one code point at a time; a pair might extend past it.
+            for (auto block_end = i + 8; i < block_end;)
+                result += utf8_length(decode_utf16<Swap>(src, count, i, invalid));
+        }
+    }
+#endif
+
+    while (i != count)
+        result += utf8_length(decode_utf16<Swap>(src, count, i, invalid));
+    return result;
+}
+
+// Transcodes the `count` UTF-16 code units to UTF-8.
+// `dest` must have space for `utf8_length_of_utf16()` code units.
+template <bool Swap, typename CharT>
+CharT* transcode_utf16_to_utf8(CharT* dest, const unsigned char* src, std::size_t count) noexcept
+{
+    // They have already been counted by `utf8_length_of_utf16()`.
+    auto invalid = std::size_t(0);
+
+    auto i = std::size_t(0);
+#if LEXY_HAS_SSE2
+    while (count - i >= 8)
+    {
+        auto v = load_utf16_block<Swap>(src + 2 * i);
+
+        if (utf16_block_match(v, short(0xFF80), 0) == 0xFFFF)
+        {
+            // All code units are ASCII, so we just need to narrow them.
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dest), _mm_packus_epi16(v, v));
+            dest += 8;
+            i += 8;
+        }
+        else
+        {
+            for (auto block_end = i + 8; i < block_end;)
+                dest = encode_utf8(dest, decode_utf16<Swap>(src, count, i, invalid));
+        }
+    }
+#endif
+
+    while (i != count)
+        dest = encode_utf8(dest, decode_utf16<Swap>(src, count, i, invalid));
+    return dest;
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_TRANSCODE_HPP_INCLUDED
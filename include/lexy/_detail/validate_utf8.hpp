@@ -0,0 +1,389 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DETAIL_VALIDATE_UTF8_HPP_INCLUDED
+#define LEXY_DETAIL_VALIDATE_UTF8_HPP_INCLUDED
+
+#include <cstring>
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/simd.hpp>
+#include <lexy/_detail/swar.hpp>
+
+//=== reader tags ===//
+namespace lexy::_detail
+{
+// Base class of readers whose input is known to be well-formed UTF-8.
+// Rules can then decode code points without validating them.
+struct utf8_validated_reader_base
+{};
+template <typename Reader>
+constexpr auto is_utf8_validated_reader = std::is_base_of_v<utf8_validated_reader_base, Reader>;
+
+// Base class of readers whose input is known to contain only ASCII characters.
+// Rules can then skip decoding multi-byte code points entirely.
+struct ascii_only_reader_base
+{};
+template <typename Reader>
+constexpr auto is_ascii_only_reader = std::is_base_of_v<ascii_only_reader_base, Reader>;
+} // namespace lexy::_detail
+
+//=== ASCII check ===//
+namespace lexy::_detail
+{
+// Returns true if [data, data + size) contains only ASCII characters.
+inline bool is_ascii(const unsigned char* data, std::size_t size) noexcept
+{
+    auto ptr = data;
+    auto end = data + size;
+
+#if LEXY_HAS_SIMD
+    // We check four blocks at once, so we only need to branch once for them.
+    for (; std::size_t(end - ptr) >= 4 * simd_width; ptr += 4 * simd_width)
+    {
+        auto high = simd_or(simd_or(simd_load(ptr), simd_load(ptr + simd_width)),
+                            simd_or(simd_load(ptr + 2 * simd_width),
+                                    simd_load(ptr + 3 * simd_width)));
+        if (simd_high_mask(high) != 0)
+            return false;
+    }
+    for (; std::size_t(end - ptr) >= simd_width; ptr += simd_width)
+        if (simd_high_mask(simd_load(ptr)) != 0)
+            return false;
+#endif
+
+    auto swar_high = swar_int(0);
+    for (; std::size_t(end - ptr) >= swar_length<unsigned char>; ptr += swar_length<unsigned char>)
+        swar_high |= swar_load(ptr);
+    if ((swar_high & swar_fill(static_cast<unsigned char>(0x80))) != 0)
+        return false;
+
+    for (; ptr != end; ++ptr)
+        if (*ptr >= 0x80)
+            return false;
+    return true;
+}
+} // namespace lexy::_detail
+
+//=== scalar validation ===//
+namespace lexy::_detail
+{
+// Returns true if [ptr, end) is well-formed UTF-8.
+inline bool validate_utf8_scalar(const unsigned char* ptr, const unsigned char* end) noexcept
+{
+    while (ptr != end)
+    {
+        // Skip ASCII characters quickly.
+        while (std::size_t(end - ptr) >= swar_length<unsigned char>
+               && (swar_load(ptr) & swar_fill(static_cast<unsigned char>(0x80))) == 0)
+            ptr += swar_length<unsigned char>;
+        if (ptr == end)
+            break;
+
+        auto first = *ptr;
+        if (first < 0x80)
+        {
+            ++ptr;
+            continue;
+        }
+
+        std::size_t length;
+        if (first < 0xC2)
+            // Trailing code unit or overlong two byte sequence.
+            return false;
+        else if (first < 0xE0)
+            length = 2;
+        else if (first < 0xF0)
+            length = 3;
+        else if (first < 0xF5)
+            length = 4;
+        else
+            // Out of range.
+            return false;
+
+        if (std::size_t(end - ptr) < length)
+            return false;
+        for (auto i = 1u; i != length; ++i)
+            if ((ptr[i] & 0xC0) != 0x80)
+                return false;
+
+        auto second = ptr[1];
+        if (first == 0xE0 && second < 0xA0)
+            // Overlong three byte sequence.
+            return false;
+        else if (first == 0xED && second >= 0xA0)
+            // Surrogate.
+            return false;
+        else if (first == 0xF0 && second < 0x90)
+            // Overlong four byte sequence.
+            return false;
+        else if (first == 0xF4 && second >= 0x90)
+            // Out of range.
+            return false;
+
+        ptr += length;
+    }
+
+    return true;
+}
+} // namespace lexy::_detail
+
+//=== SIMD validation ===//
+#if LEXY_HAS_SIMD_SHUFFLE
+namespace lexy::_detail
+{
+// The lookup algorithm of "Validating UTF-8 In Less Than One Instruction Per Byte"
+// by John Keiser and Daniel Lemire.
+// Every error is detected by looking at two consecutive code units, except for the number of
+// trailing code units of three and four byte sequences.
+// Each lookup table maps a nibble to the set of errors it is compatible with; a pair of code
+// units is an error if all three nibbles agree on one.
+constexpr unsigned char _utf8_too_short      = 1 << 0; // lead followed by lead or ASCII
+constexpr unsigned char _utf8_too_long       = 1 << 1; // ASCII followed by trailing
+constexpr unsigned char _utf8_overlong_3     = 1 << 2; // E0 followed by 80..9F
+constexpr unsigned char _utf8_too_large      = 1 << 3; // F4 followed by 90..BF, or F5..FF
+constexpr unsigned char _utf8_surrogate      = 1 << 4; // ED followed by A0..BF
+constexpr unsigned char _utf8_overlong_2     = 1 << 5; // C0 or C1
+constexpr unsigned char _utf8_too_large_1000 = 1 << 6; // F5..FF followed by 80..8F
+constexpr unsigned char _utf8_overlong_4     = 1 << 6; // F0 followed by 80..8F
+constexpr unsigned char _utf8_two_conts      = 1 << 7; // trailing followed by trailing
+constexpr unsigned char _utf8_carry = _utf8_too_short | _utf8_too_long | _utf8_two_conts;
+
+// Indexed by the high nibble of the first code unit.
+constexpr unsigned char _utf8_byte_1_high[16] = {
+    // 0_______ (ASCII)
+    _utf8_too_long,
+    _utf8_too_long,
+    _utf8_too_long,
+    _utf8_too_long,
+    _utf8_too_long,
+    _utf8_too_long,
+    _utf8_too_long,
+    _utf8_too_long,
+    // 10______ (trailing)
+    _utf8_two_conts,
+    _utf8_two_conts,
+    _utf8_two_conts,
+    _utf8_two_conts,
+    // 1100____ (two byte lead)
+    _utf8_too_short | _utf8_overlong_2,
+    // 1101____ (two byte lead)
+    _utf8_too_short,
+    // 1110____ (three byte lead)
+    _utf8_too_short | _utf8_overlong_3 | _utf8_surrogate,
+    // 1111____ (four byte lead)
+    _utf8_too_short | _utf8_too_large | _utf8_too_large_1000 | _utf8_overlong_4,
+};
+// Indexed by the low nibble of the first code unit.
+constexpr unsigned char _utf8_byte_1_low[16] = {
+    // ____0000
+    _utf8_carry | _utf8_overlong_3 | _utf8_overlong_2 | _utf8_overlong_4,
+    // ____0001
+    _utf8_carry | _utf8_overlong_2,
+    // ____001_
+    _utf8_carry,
+    _utf8_carry,
+    // ____0100
+    _utf8_carry | _utf8_too_large,
+    // ____0101 to ____1100
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    // ____1101
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000 | _utf8_surrogate,
+    // ____111_
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+    _utf8_carry | _utf8_too_large | _utf8_too_large_1000,
+};
+// Indexed by the high nibble of the second code unit.
+constexpr unsigned char _utf8_byte_2_high[16] = {
+    // 0_______ (ASCII)
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+    // 1000____
+    _utf8_too_long | _utf8_overlong_2 | _utf8_two_conts | _utf8_overlong_3 | _utf8_too_large_1000
+        | _utf8_overlong_4,
+    // 1001____
+    _utf8_too_long | _utf8_overlong_2 | _utf8_two_conts | _utf8_overlong_3 | _utf8_too_large,
+    // 101_____
+    _utf8_too_long | _utf8_overlong_2 | _utf8_two_conts | _utf8_surrogate | _utf8_too_large,
+    _utf8_too_long | _utf8_overlong_2 | _utf8_two_conts | _utf8_surrogate | _utf8_too_large,
+    // 11______ (lead)
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+    _utf8_too_short,
+};
+
+// Subtracted from the last three code units of a block:
+// the result is non-zero if they start a sequence that continues in the next block.
+constexpr unsigned char _utf8_max_value[32]
+    = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+       0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+       0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xF0 - 1, 0xE0 - 1, 0xC0 - 1};
+
+#    if LEXY_HAS_AVX2
+inline simd_int _utf8_table(const unsigned char (&table)[16])
+{
+    // The shuffle works on each 128 bit lane separately, so we need the table in both.
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(table)));
+}
+inline simd_int _utf8_lookup(simd_int table, simd_int nibbles)
+{
+    return _mm256_shuffle_epi8(table, nibbles);
+}
+inline simd_int _utf8_high_nibbles(simd_int v)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(v, 4), _mm256_set1_epi8(0x0F));
+}
+inline simd_int _utf8_low_nibbles(simd_int v)
+{
+    return _mm256_and_si256(v, _mm256_set1_epi8(0x0F));
+}
+// The code units of `cur`, shifted to the right by N, with the last N of `prev` in front.
+template <int N>
+simd_int _utf8_prev(simd_int cur, simd_int prev)
+{
+    return _mm256_alignr_epi8(cur, _mm256_permute2x128_si256(prev, cur, 0x21), 16 - N);
+}
+// A mask of all code units that are at least 0xE0 in prev2 or 0xF0 in prev3 anded with 0x80.
+inline simd_int _utf8_must_be_2_3_continuation(simd_int prev2, simd_int prev3)
+{
+    auto is_third  = _mm256_subs_epu8(prev2, _mm256_set1_epi8(char(0xE0 - 1)));
+    auto is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(char(0xF0 - 1)));
+    auto must      = _mm256_cmpgt_epi8(_mm256_or_si256(is_third, is_fourth),
+                                       _mm256_setzero_si256());
+    return _mm256_and_si256(must, _mm256_set1_epi8(char(0x80)));
+}
+inline simd_int _utf8_and(simd_int lhs, simd_int rhs)
+{
+    return _mm256_and_si256(lhs, rhs);
+}
+inline simd_int _utf8_xor(simd_int lhs, simd_int rhs)
+{
+    return _mm256_xor_si256(lhs, rhs);
+}
+inline simd_int _utf8_incomplete(simd_int v)
+{
+    return _mm256_subs_epu8(v, simd_load(_utf8_max_value));
+}
+#    else
+inline simd_int _utf8_table(const unsigned char (&table)[16])
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+}
+inline simd_int _utf8_lookup(simd_int table, simd_int nibbles)
+{
+    return _mm_shuffle_epi8(table, nibbles);
+}
+inline simd_int _utf8_high_nibbles(simd_int v)
+{
+    return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+}
+inline simd_int _utf8_low_nibbles(simd_int v)
+{
+    return _mm_and_si128(v, _mm_set1_epi8(0x0F));
+}
+template <int N>
+simd_int _utf8_prev(simd_int cur, simd_int prev)
+{
+    return _mm_alignr_epi8(cur, prev, 16 - N);
+}
+inline simd_int _utf8_must_be_2_3_continuation(simd_int prev2, simd_int prev3)
+{
+    auto is_third  = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 1)));
+    auto is_fourth = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 1)));
+    auto must      = _mm_cmpgt_epi8(_mm_or_si128(is_third, is_fourth), _mm_setzero_si128());
+    return _mm_and_si128(must, _mm_set1_epi8(char(0x80)));
+}
+inline simd_int _utf8_and(simd_int lhs, simd_int rhs)
+{
+    return _mm_and_si128(lhs, rhs);
+}
+inline simd_int _utf8_xor(simd_int lhs, simd_int rhs)
+{
+    return _mm_xor_si128(lhs, rhs);
+}
+inline simd_int _utf8_incomplete(simd_int v)
+{
+    return _mm_subs_epu8(v, simd_load(_utf8_max_value + 16));
+}
+#    endif
+
+// Returns true if [ptr, end) is well-formed UTF-8.
+inline bool validate_utf8_simd(const unsigned char* ptr, const unsigned char* end) noexcept
+{
+    auto byte_1_high = _utf8_table(_utf8_byte_1_high);
+    auto byte_1_low  = _utf8_table(_utf8_byte_1_low);
+    auto byte_2_high = _utf8_table(_utf8_byte_2_high);
+
+    auto error           = simd_fill(0);
+    auto prev            = simd_fill(0);
+    auto prev_incomplete = simd_fill(0);
+    auto check_block     = [&](simd_int cur) {
+        if (simd_high_mask(cur) == 0)
+        {
+            // An ASCII block is only an error if the previous block ended in the middle of a
+            // code point.
+            error = simd_or(error, prev_incomplete);
+            return;
+        }
+
+        auto prev1         = _utf8_prev<1>(cur, prev);
+        auto special_cases = _utf8_and(_utf8_and(_utf8_lookup(byte_1_high,
+                                                              _utf8_high_nibbles(prev1)),
+                                                 _utf8_lookup(byte_1_low,
+                                                              _utf8_low_nibbles(prev1))),
+                                       _utf8_lookup(byte_2_high, _utf8_high_nibbles(cur)));
+
+        // Trailing code units of three and four byte sequences are expected to be a
+        // `_utf8_two_conts` error; there is an error if they're not or if we didn't expect one.
+        auto must_be_2_3 = _utf8_must_be_2_3_continuation(_utf8_prev<2>(cur, prev),
+                                                          _utf8_prev<3>(cur, prev));
+        error            = simd_or(error, _utf8_xor(must_be_2_3, special_cases));
+
+        prev_incomplete = _utf8_incomplete(cur);
+        prev            = cur;
+    };
+
+    for (; std::size_t(end - ptr) >= simd_width; ptr += simd_width)
+        check_block(simd_load(ptr));
+
+    if (ptr != end)
+    {
+        // The remaining code units are padded with ASCII.
+        unsigned char block[simd_width] = {};
+        std::memcpy(block, ptr, std::size_t(end - ptr));
+        check_block(simd_load(block));
+    }
+
+    error = simd_or(error, prev_incomplete);
+    return simd_eq_mask(error, simd_fill(0)) == simd_full_mask;
+}
+} // namespace lexy::_detail
+#endif
+
+namespace lexy::_detail
+{
+// Returns true if [data, data + size) is well-formed UTF-8.
+inline bool validate_utf8(const unsigned char* data, std::size_t size) noexcept
+{
+#if LEXY_HAS_SIMD_SHUFFLE
+    return validate_utf8_simd(data, data + size);
+#else
+    return validate_utf8_scalar(data, data + size);
+#endif
+}
+} // namespace lexy::_detail
+
+#endif // LEXY_DETAIL_VALIDATE_UTF8_HPP_INCLUDED
@@ -5,6 +5,7 @@
 #define LEXY_ACTION_PARSE_HPP_INCLUDED
 
 #include <lexy/_detail/invoke.hpp>
+#include <lexy/_detail/validate_utf8.hpp>
 #include <lexy/action/base.hpp>
 #include <lexy/action/validate.hpp>
 #include <lexy/callback/base.hpp>
@@ -157,10 +158,17 @@ struct parse_action
 
     template <typename Production>
     constexpr auto operator()(Production, const Input& input) const
+    {
+        auto reader = input.reader();
+        return _parse<Production>(input, reader);
+    }
+
+    // Parses the input using a reader that has the same iterators as the one of the input.
+    template <typename Production, typename Reader>
+    constexpr auto _parse(const Input& input, Reader& reader) const
     {
         _detail::any_holder input_holder(&input);
         _detail::any_holder sink(_get_error_sink(*_callback));
-        auto                reader = input.reader();
         return lexy::do_action<Production, result_type>(handler(input_holder, sink), _state,
                                                         reader);
     }
@@ -187,5 +195,107 @@ constexpr auto parse(const Input& input, const State& state, const ErrorCallback
 }
 } // namespace lexy
 
+namespace lexy
+{
+template <typename Production, typename State, typename Input, typename ErrorCallback>
+auto _parse_ascii_dispatch(const parse_action<State, Input, ErrorCallback>& action,
+                           const Input&                                     input)
+{
+    static_assert(std::is_same_v<typename Input::encoding, lexy::utf8_encoding>
+                      || std::is_same_v<typename Input::encoding, lexy::utf8_char_encoding>,
+                  "ASCII dispatch requires UTF-8 input");
+
+    auto data = reinterpret_cast<const unsigned char*>(input.data());
+    if (_detail::is_ascii(data, input.size()))
+    {
+        // Errors and lexemes of the ASCII reader convert to the ones of the input, as the
+        // iterators are the same, so the result type doesn't change.
+        // `_ascii_reader()` is found via ADL for the inputs that support it.
+        auto reader = _ascii_reader(input.reader());
+        return action.template _parse<Production>(input, reader);
+    }
+    else
+    {
+        return action(Production{}, input);
+    }
+}
+
+/// Parses the production into a value, invoking the callback on error.
+/// If the UTF-8 input contains only ASCII characters, it uses a grammar instantiation that
+/// doesn't need to decode multi-byte code points.
+template <typename Production, typename Input, typename ErrorCallback>
+auto parse_ascii_dispatch(const Input& input, const ErrorCallback& callback)
+{
+    return _parse_ascii_dispatch<Production>(parse_action<void, Input, ErrorCallback>(callback),
+                                             input);
+}
+
+template <typename Production, typename Input, typename State, typename ErrorCallback>
+auto parse_ascii_dispatch(const Input& input, State& state, const ErrorCallback& callback)
+{
+    return _parse_ascii_dispatch<Production>(parse_action<State, Input, ErrorCallback>(state,
+                                                                                       callback),
+                                             input);
+}
+template <typename Production, typename Input, typename State, typename ErrorCallback>
+auto parse_ascii_dispatch(const Input& input, const State& state, const ErrorCallback& callback)
+{
+    return _parse_ascii_dispatch<Production>(parse_action<const State, Input, ErrorCallback>(
+                                                 state, callback),
+                                             input);
+}
+} // namespace lexy
+
+namespace lexy
+{
+template <typename Production, typename State, typename Input, typename ErrorCallback>
+auto _parse_validated_utf8(const parse_action<State, Input, ErrorCallback>& action,
+                           const Input&                                     input)
+{
+    static_assert(std::is_same_v<typename Input::encoding, lexy::utf8_encoding>
+                      || std::is_same_v<typename Input::encoding, lexy::utf8_char_encoding>,
+                  "UTF-8 validation requires UTF-8 input");
+
+    auto data = reinterpret_cast<const unsigned char*>(input.data());
+    if (_detail::validate_utf8(data, input.size()))
+    {
+        // As for `_parse_ascii_dispatch()`, the result type doesn't change.
+        // `_utf8_validated_reader()` is found via ADL for the inputs that support it.
+        auto reader = _utf8_validated_reader(input.reader());
+        return action.template _parse<Production>(input, reader);
+    }
+    else
+    {
+        // Parse it normally, so the ill-formed code units are reported.
+        return action(Production{}, input);
+    }
+}
+
+/// Parses the production into a value, invoking the callback on error.
+/// If the input is well-formed UTF-8, it uses a grammar instantiation that decodes code points
+/// without validating them.
+template <typename Production, typename Input, typename ErrorCallback>
+auto parse_validated_utf8(const Input& input, const ErrorCallback& callback)
+{
+    return _parse_validated_utf8<Production>(parse_action<void, Input, ErrorCallback>(callback),
+                                             input);
+}
+
+template <typename Production, typename Input, typename State, typename ErrorCallback>
+auto parse_validated_utf8(const Input& input, State& state, const ErrorCallback& callback)
+{
+    return _parse_validated_utf8<Production>(parse_action<State, Input, ErrorCallback>(state,
+                                                                                       callback),
+                                             input);
+}
+template <typename Production, typename Input, typename State, typename ErrorCallback>
+auto parse_validated_utf8(const Input& input, const State& state, const ErrorCallback& callback)
+{
+    return _parse_validated_utf8<Production>(parse_action<const State, Input, ErrorCallback>(
+                                                 state, callback),
+                                             input);
+}
+} // namespace lexy
+
 #endif // LEXY_ACTION_PARSE_HPP_INCLUDED
 
@@ -44,6 +44,7 @@
 #include <lexy/dsl/position.hpp>
 #include <lexy/dsl/production.hpp>
 #include <lexy/dsl/punctuator.hpp>
+#include <lexy/dsl/real.hpp>
 #include <lexy/dsl/recover.hpp>
 #include <lexy/dsl/repeat.hpp>
 #include <lexy/dsl/return.hpp>
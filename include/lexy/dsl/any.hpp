@@ -24,7 +24,8 @@ struct _any : token_base<_any, unconditional_branch_base>
             using encoding = typename Reader::encoding;
             if constexpr (lexy::_detail::is_swar_reader<Reader>)
             {
-                while (!lexy::_detail::swar_has_char<typename encoding::char_type, encoding::eof()>(
+                while (!lexy::_detail::swar_has_char<typename encoding::char_type,
+                                                     lexy::_detail::swar_eof<encoding>>(
                     reader.peek_swar()))
                     reader.bump_swar();
             }
@@ -5,6 +5,7 @@
 #define LEXY_DSL_BASE_HPP_INCLUDED
 
 #include <lexy/_detail/config.hpp>
+#include <lexy/_detail/detect.hpp>
 #include <lexy/_detail/lazy_init.hpp>
 #include <lexy/grammar.hpp>
 #include <lexy/input/base.hpp>
@@ -269,5 +270,131 @@ LEXY_FORCE_INLINE constexpr auto try_match_token(TokenRule, Reader& reader)
 }
 } // namespace lexy
 
+//=== first set ===//
+namespace lexy::_detail
+{
+// The code units a branch can start with, so we know which branches can't match the input.
+// It is only computed for encodings whose code units are bytes.
+struct first_set
+{
+    // If false, we don't know anything:
+    // the branch can start with any code unit or might not consume anything at all.
+    bool known;
+    bool contains[256];
+
+    constexpr first_set() : known(true), contains{} {}
+
+    static constexpr first_set unknown()
+    {
+        first_set result;
+        result.known = false;
+        return result;
+    }
+
+    constexpr void insert(unsigned char c)
+    {
+        contains[c] = true;
+    }
+    constexpr void insert(const first_set& other)
+    {
+        known = known && other.known;
+        for (auto i = 0; i != 256; ++i)
+            contains[i] = contains[i] || other.contains[i];
+    }
+
+    // Inserts all code units that are case folded to one of the code units in the set.
+    constexpr void insert_case_folded()
+    {
+        for (auto c = 'a'; c <= 'z'; ++c)
+        {
+            auto lower = static_cast<unsigned char>(c);
+            auto upper = static_cast<unsigned char>(c - 'a' + 'A');
+            contains[lower] = contains[upper] = contains[lower] || contains[upper];
+        }
+        // Non-ASCII characters can be folded to ASCII ones (e.g. KELVIN SIGN to 'k').
+        for (auto i = 0x80; i != 256; ++i)
+            contains[i] = true;
+    }
+
+    constexpr bool overlaps(const first_set& other) const
+    {
+        if (!known || !other.known)
+            return true;
+
+        for (auto i = 0; i != 256; ++i)
+            if (contains[i] && other.contains[i])
+                return true;
+        return false;
+    }
+};
+
+template <typename Rule, typename Encoding>
+using _detect_branch_first_set = decltype(Rule::template branch_first_set<Encoding>());
+
+// Rules that aren't tokens can provide it by implementing
+// `template <typename Encoding> static LEXY_CONSTEVAL first_set branch_first_set()`.
+template <typename Rule, typename Encoding>
+LEXY_CONSTEVAL first_set first_set_of()
+{
+    if constexpr (sizeof(typename Encoding::char_type) != 1)
+    {
+        return first_set::unknown();
+    }
+    else if constexpr (lexy::is_char_class_rule<Rule>)
+    {
+        first_set result;
+        Rule::char_class_ascii().visit(
+            [&](int c) { result.insert(static_cast<unsigned char>(c)); });
+        if constexpr (!std::is_same_v<decltype(Rule::char_class_match_cp(char32_t())),
+                                      std::false_type>)
+        {
+            for (auto i = 0x80; i != 256; ++i)
+                result.insert(static_cast<unsigned char>(i));
+        }
+        return result;
+    }
+    else if constexpr (lexy::is_literal_set_rule<Rule>)
+    {
+        constexpr const auto& trie = Rule::as_lset::template _t<Encoding>;
+        if (trie.node_value[0] != trie.node_no_match)
+            // It matches the empty string.
+            return first_set::unknown();
+
+        first_set result;
+        for (auto i = 0u; i != trie.node_count - 1; ++i)
+            if (trie.transition_from[i] == 0)
+                result.insert(static_cast<unsigned char>(trie.transition_char[i]));
+
+        using trie_type = LEXY_DECAY_DECLTYPE(trie);
+        if constexpr (!std::is_same_v<typename trie_type::template reader<first_set>, first_set>)
+            result.insert_case_folded();
+        return result;
+    }
+    else if constexpr (lexy::is_literal_rule<Rule>)
+    {
+        if constexpr (Rule::lit_max_char_count == 0)
+        {
+            return first_set::unknown();
+        }
+        else
+        {
+            first_set result;
+            result.insert(static_cast<unsigned char>(Rule::template lit_first_char<Encoding>()));
+            if constexpr (!std::is_void_v<typename Rule::lit_case_folding>)
+                result.insert_case_folded();
+            return result;
+        }
+    }
+    else if constexpr (lexy::_detail::is_detected<_detect_branch_first_set, Rule, Encoding>)
+    {
+        return Rule::template branch_first_set<Encoding>();
+    }
+    else
+    {
+        return first_set::unknown();
+    }
+}
+} // namespace lexy::_detail
+
 #endif // LEXY_DSL_BASE_HPP_INCLUDED
 
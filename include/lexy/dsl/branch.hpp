@@ -24,6 +24,12 @@ struct _br : _copy_base<Condition>
 
     template <typename NextParser>
     using p = lexy::parser_for<_seq_impl<Condition, R...>, NextParser>;
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Condition, Encoding>();
+    }
 };
 
 //=== operator>> ===//
@@ -5,6 +5,7 @@
 #define LEXY_DSL_CHAR_CLASS_HPP_INCLUDED
 
 #include <lexy/_detail/code_point.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/_detail/swar.hpp>
 #include <lexy/dsl/base.hpp>
 #include <lexy/dsl/token.hpp>
@@ -133,6 +134,44 @@ constexpr auto compress_ascii_set()
 
 namespace lexy::_detail
 {
+constexpr simd_char_table make_simd_char_table(const ascii_set& set)
+{
+    simd_char_table result{};
+    for (auto c = 0; c != 128; ++c)
+        if (set.contains[c])
+            result.lo[c & 0xF] = static_cast<unsigned char>(result.lo[c & 0xF] | (1 << (c >> 4)));
+
+    // Chars with the high bit set are not ASCII, so their entry stays zero.
+    for (auto hi = 0; hi != 8; ++hi)
+        result.hi[hi] = static_cast<unsigned char>(1 << hi);
+
+    return result;
+}
+
+template <typename CharClass>
+constexpr auto simd_char_table_of = make_simd_char_table(CharClass::char_class_ascii());
+
+// The table of the char class without the specified chars, which need special handling.
+template <typename CharClass, typename CharT, CharT... Excluded>
+constexpr auto simd_char_table_except = [] {
+    auto set = CharClass::char_class_ascii();
+    for (auto c : {static_cast<unsigned char>(Excluded)...})
+        if (c < 128)
+            set.contains[c] = false;
+    return make_simd_char_table(set);
+}();
+
+#if LEXY_HAS_SIMD_SHUFFLE
+
+// Returns true if v contains only ASCII characters from the char class.
+// Like `char_class_match_swar()`, it can return false even though all characters match.
+template <typename CharClass>
+bool char_class_match_simd(simd_int v)
+{
+    return simd_match_table(v, simd_char_table_of<CharClass>);
+}
+#endif
+
 template <const auto& CompressedAsciiSet,
           typename = make_index_sequence<CompressedAsciiSet.range_count()>,
           typename = make_index_sequence<CompressedAsciiSet.single_count()>>
@@ -225,6 +264,11 @@ struct char_class_base : token_base<Derived>, _char_class_base
             {
                 return false;
             }
+            else if constexpr (lexy::_detail::is_ascii_only_reader<Reader>)
+            {
+                // There are no other code points in the input.
+                return false;
+            }
             else if constexpr (lexy::is_unicode_encoding<typename Reader::encoding>)
             {
                 static_assert(Derived::char_class_unicode(),
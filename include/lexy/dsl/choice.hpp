@@ -30,6 +30,53 @@ struct _chc
 {
     static constexpr auto _any_unconditional = (lexy::is_unconditional_branch_rule<R> || ...);
 
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        lexy::_detail::first_set result;
+        (result.insert(lexy::_detail::first_set_of<R, Encoding>()), ...);
+        return result;
+    }
+
+    // If the branches start with different code units, the next code unit determines the only
+    // branch that can match, and we don't need to try the others.
+    // An unconditional branch is taken if that branch doesn't match; later ones are never taken.
+    struct _dispatch_table
+    {
+        bool          enabled;
+        unsigned char branch[256];
+        std::size_t   fallback; // the first unconditional branch or sizeof...(R)
+    };
+    template <typename Encoding>
+    static LEXY_CONSTEVAL _dispatch_table _build_dispatch_table()
+    {
+        constexpr bool           unconditional[] = {lexy::is_unconditional_branch_rule<R>...};
+        lexy::_detail::first_set sets[]          = {lexy::_detail::first_set_of<R, Encoding>()...};
+
+        _dispatch_table result{};
+        result.fallback = 0;
+        while (result.fallback != sizeof...(R) && !unconditional[result.fallback])
+            ++result.fallback;
+
+        // It's not worth it if there is only one branch we could take.
+        result.enabled = result.fallback > 1 && sizeof...(R) < 256;
+        for (auto i = 0u; i != result.fallback; ++i)
+            for (auto j = 0u; j != i; ++j)
+                if (sets[i].overlaps(sets[j]))
+                    result.enabled = false;
+
+        for (auto c = 0; c != 256; ++c)
+        {
+            result.branch[c] = static_cast<unsigned char>(sizeof...(R));
+            for (auto i = 0u; i != result.fallback; ++i)
+                if (sets[i].contains[c])
+                    result.branch[c] = static_cast<unsigned char>(i);
+        }
+        return result;
+    }
+    template <typename Encoding>
+    static constexpr _dispatch_table _dispatch = _build_dispatch_table<Encoding>();
+
     template <typename Reader, typename Indices = lexy::_detail::make_index_sequence<sizeof...(R)>>
     struct bp;
     template <typename Reader, std::size_t... Idx>
@@ -90,8 +137,11 @@ struct _chc
         }
     };
 
-    template <typename NextParser>
-    struct p
+    template <typename NextParser,
+              typename Indices = lexy::_detail::make_index_sequence<sizeof...(R)>>
+    struct p;
+    template <typename NextParser, std::size_t... Idx>
+    struct p<NextParser, lexy::_detail::index_sequence<Idx...>>
     {
         template <typename Context, typename Reader, typename... Args>
         LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
@@ -110,8 +160,23 @@ struct _chc
                 return true;
             };
 
-            // Try to parse each branch in order.
-            auto found_branch = (try_r(lexy::branch_parser_for<R, Reader>{}) || ...);
+            auto found_branch = false;
+            if constexpr (_dispatch<typename Reader::encoding>.enabled)
+            {
+                // Only try the branch that can start with the next code unit, if there is one,
+                // and the unconditional branch. EOF is converted to a code unit as well, but only
+                // the unconditional branch can match it.
+                constexpr auto& table = _dispatch<typename Reader::encoding>;
+                auto            idx   = table.branch[static_cast<unsigned char>(reader.peek())];
+                found_branch = (((idx == Idx || Idx == table.fallback)
+                                 && try_r(lexy::branch_parser_for<R, Reader>{}))
+                                || ...);
+            }
+            else
+            {
+                // Try to parse each branch in order.
+                found_branch = (try_r(lexy::branch_parser_for<R, Reader>{}) || ...);
+            }
             if constexpr (_any_unconditional)
             {
                 LEXY_ASSERT(found_branch,
@@ -66,13 +66,55 @@ struct _del_chars
             using char_type = typename encoding::char_type;
             using lexy::_detail::swar_has_char;
 
+#if LEXY_USE_SIMD_DISPATCH
+            if constexpr (lexy::_detail::is_simd_reader<Reader>)
+            {
+                // The kernel stops at the first char that isn't in the table, so we exclude the
+                // chars that start the closing delimiter or an escape sequence.
+                // EOF isn't ASCII, so it's never in the table.
+                constexpr auto& table = lexy::_detail::simd_char_table_except<
+                    CharClass, char_type, Close::template lit_first_char<encoding>(),
+                    Escs::template esc_first_char<encoding>()...>;
+                reader.bump_simd_to(
+                    lexy::_detail::simd_find_class_end(reader.simd_position(), table));
+            }
+#elif LEXY_HAS_SIMD_SHUFFLE
+            if constexpr (lexy::_detail::is_simd_reader<Reader>)
+            {
+                using lexy::_detail::simd_has_char;
+
+                // Same as the SWAR loop below, but for an entire SIMD register.
+                while (true)
+                {
+                    auto cur = reader.peek_simd();
+                    if (simd_has_char<char_type, lexy::_detail::swar_eof<encoding>>(cur)
+                        || simd_has_char<char_type, Close::template lit_first_char<encoding>()>(
+                            cur))
+                        break;
+
+                    if constexpr (sizeof...(Escs) > 0)
+                    {
+                        if ((simd_has_char<char_type, Escs::template esc_first_char<encoding>()>(
+                                 cur)
+                             || ...))
+                            break;
+                    }
+
+                    if (!lexy::_detail::char_class_match_simd<CharClass>(cur))
+                        break;
+
+                    reader.bump_simd();
+                }
+            }
+#endif
+
             while (true)
             {
                 auto cur = reader.peek_swar();
 
                 // If we have an EOF or the initial character of the closing delimiter, we exit as
                 // we have no more content.
-                if (swar_has_char<char_type, encoding::eof()>(cur)
+                if (swar_has_char<char_type, lexy::_detail::swar_eof<encoding>>(cur)
                     || swar_has_char<char_type, Close::template lit_first_char<encoding>()>(cur))
                     break;
 
@@ -108,7 +150,8 @@ struct _del_chars
             reader.bump();
         }
         else if constexpr (!std::is_same_v<decltype(CharClass::char_class_match_cp(char32_t())),
-                                           std::false_type>)
+                                           std::false_type>
+                           && !lexy::_detail::is_ascii_only_reader<Reader>)
         {
             if constexpr (lexy::is_unicode_encoding<encoding>)
             {
@@ -151,7 +194,7 @@ struct _del_chars
                 }
             }
         }
-        // It doesn't match Unicode characters.
+        // It doesn't match Unicode characters or there are none.
         else
         {
             // We can just discard the invalid ASCII character.
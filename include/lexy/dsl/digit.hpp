@@ -120,6 +120,27 @@ struct _d<10> : char_class_base<_d<10>>
 
         return (c & mask) == expected && ((c + offset) & mask) == expected;
     }
+
+    // Returns the value of the eight single byte digits in c; the first one is most significant.
+    static constexpr std::uint_least32_t swar_value(lexy::_detail::swar_int c)
+    {
+        using lexy::_detail::swar_int;
+        static_assert(sizeof(swar_int) == 8);
+
+        // Convert the chars to digits, then combine adjacent digits:
+        // afterwards, every other byte contains the value of two digits.
+        c -= lexy::_detail::swar_fill(char(0x30));
+        c = c * 10 + (c >> 8);
+
+        // Multiply the first and third pair by 10^6 and 10^2, and the second and fourth pair by
+        // 10^4 and 1; the sum ends up in the upper half.
+        constexpr auto mask = swar_int(0x0000'00FF'0000'00FF);
+        constexpr auto mul1 = swar_int(100) + (swar_int(1'000'000) << 32);
+        constexpr auto mul2 = swar_int(1) + (swar_int(10'000) << 32);
+        c                   = ((c & mask) * mul1 + ((c >> 16) & mask) * mul2) >> 32;
+
+        return static_cast<std::uint_least32_t>(c);
+    }
 };
 using decimal = _d<10>;
 
@@ -401,6 +422,12 @@ struct _digits_st : token_base<_digits_st<Base, Sep>>
             }
         }
     };
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Base, Encoding>();
+    }
 };
 
 template <typename Base, typename Sep>
@@ -433,6 +460,12 @@ struct _digits_s : token_base<_digits_s<Base, Sep>>
     {
         return _digits_st<Base, Sep>{};
     }
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Base, Encoding>();
+    }
 };
 
 template <typename Base>
@@ -493,6 +526,12 @@ struct _digits_t : token_base<_digits_t<Base>>
         static_assert(lexy::is_token_rule<Token>);
         return _digits_st<Base, Token>{};
     }
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Base, Encoding>();
+    }
 };
 
 template <typename Base>
@@ -532,6 +571,12 @@ struct _digits : token_base<_digits<Base>>
     {
         return _digits_t<Base>{};
     }
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Base, Encoding>();
+    }
 };
 
 /// Matches a non-empty list of digits.
@@ -594,6 +639,12 @@ struct _ndigits_s : token_base<_ndigits_s<N, Base, Sep>>
             context.on(_ev::error{}, err);
         }
     };
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Base, Encoding>();
+    }
 };
 
 template <std::size_t N, typename Base>
@@ -633,6 +684,12 @@ struct _ndigits : token_base<_ndigits<N, Base>>
         static_assert(lexy::is_token_rule<Token>);
         return _ndigits_s<N, Base, Token>{};
     }
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Base, Encoding>();
+    }
 };
 
 /// Matches exactly N digits.
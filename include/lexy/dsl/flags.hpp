@@ -51,7 +51,11 @@ struct _flags : rule_base
                 if (!bp.template finish<lexy::pattern_parser<_enum_type>>(context, reader))
                     return false;
 
-                auto flag = _int_type(bp.value());
+                static_assert(
+                    std::is_same_v<LEXY_DECAY_DECLTYPE(bp.value(context.control_block)),
+                                   _enum_type>,
+                    "symbol table must map to the enum type of the default value");
+                auto flag = _int_type(bp.value(context.control_block));
                 if ((result & flag) == flag)
                 {
                     using tag = lexy::_detail::type_or<DuplicateError, lexy::duplicate_flag>;
@@ -82,18 +86,24 @@ struct _flags : rule_base
 template <auto Default, const auto& Table, typename Token, typename Tag>
 constexpr auto flags(_sym<Table, Token, Tag> flag_rule)
 {
-    using table_type = LEXY_DECAY_DECLTYPE(Table);
-    using enum_type  = LEXY_DECAY_DECLTYPE(Default);
-    static_assert(std::is_same_v<enum_type, typename table_type::mapped_type>);
+    // The mapped type of a runtime symbol table is only known once we parse,
+    // so we check that it is the enum type there.
+    using enum_type = LEXY_DECAY_DECLTYPE(Default);
     static_assert(std::is_enum_v<enum_type>);
 
     return _flags<decltype(flag_rule), Default>{};
 }
+
+template <typename Table>
+using _detect_mapped_type = typename Table::mapped_type;
+
 template <const auto& Table, typename Token, typename Tag>
 constexpr auto flags(_sym<Table, Token, Tag> flag_rule)
 {
     using table_type = LEXY_DECAY_DECLTYPE(Table);
-    using enum_type  = typename table_type::mapped_type;
+    static_assert(lexy::_detail::is_detected<_detect_mapped_type, table_type>,
+                  "a runtime symbol table requires that the default value is specified");
+    using enum_type = typename table_type::mapped_type;
     static_assert(std::is_enum_v<enum_type>);
 
     return _flags<decltype(flag_rule), enum_type{}>{};
@@ -51,6 +51,21 @@ struct _idp : token_base<_idp<Leading, Trailing>>
             // Match zero or more trailing characters.
             while (true)
             {
+#if LEXY_USE_SIMD_DISPATCH
+                if constexpr (lexy::_detail::is_simd_reader<Reader>)
+                {
+                    // Let the kernel that was selected for the CPU consume as much as possible.
+                    reader.bump_simd_to(lexy::_detail::simd_find_class_end(
+                        reader.simd_position(), lexy::_detail::simd_char_table_of<Trailing>));
+                }
+#elif LEXY_HAS_SIMD_SHUFFLE
+                if constexpr (lexy::_detail::is_simd_reader<Reader>)
+                {
+                    // If we have a SIMD reader, consume even more at once.
+                    while (lexy::_detail::char_class_match_simd<Trailing>(reader.peek_simd()))
+                        reader.bump_simd();
+                }
+#endif
                 if constexpr (lexy::_detail::is_swar_reader<Reader>)
                 {
                     // If we have a swar reader, consume as much as possible at once.
@@ -73,6 +88,12 @@ struct _idp : token_base<_idp<Leading, Trailing>>
             Leading::template char_class_report_error<Reader>(context, reader.position());
         }
     };
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Leading, Encoding>();
+    }
 };
 
 template <typename Set>
@@ -272,6 +293,12 @@ struct _id : branch_base
         return _idp<Leading, Trailing>{};
     }
 
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<_idp<Leading, Trailing>, Encoding>();
+    }
+
     /// Matches the initial char set of an identifier.
     constexpr auto leading_pattern() const
     {
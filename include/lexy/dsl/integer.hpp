@@ -234,6 +234,32 @@ constexpr bool _ndigits_can_overflow()
     return N >= max_digit_count;
 }
 
+// Whether the integer parser can convert eight decimal digits at once using SWAR.
+// It needs contiguous single byte chars and a builtin integer type; as the fast path isn't
+// constexpr, we also need to detect constant evaluation.
+template <typename T, typename Base, typename Iterator>
+constexpr bool _int_has_swar
+    = LEXY_HAS_IS_CONSTANT_EVALUATED && std::is_same_v<Base, decimal>
+      && std::is_pointer_v<Iterator> && sizeof(*LEXY_DECLVAL(Iterator)) == 1
+      && std::is_integral_v<typename lexy::integer_traits<T>::type>;
+
+// If the next eight chars are all digits, advances cur past them and stores their value.
+template <typename Iterator>
+constexpr bool _int_swar_digits(Iterator& cur, Iterator end, std::uint_least32_t& value)
+{
+    if (end - cur < 8 || LEXY_IS_CONSTANT_EVALUATED())
+        return false;
+
+    using char_type = LEXY_DECAY_DECLTYPE(*cur);
+    auto c          = lexy::_detail::swar_load(cur);
+    if (!decimal::swar_matches<char_type>(c))
+        return false;
+
+    value = decimal::swar_value(c);
+    cur += 8;
+    return true;
+}
+
 // Parses T in the Base without checking for overflow.
 template <typename T, typename Base>
 struct _unbounded_integer_parser
@@ -255,6 +281,14 @@ struct _unbounded_integer_parser
         typename traits::type value(0);
 
         // Just parse digits until we've run out of digits.
+        if constexpr (_int_has_swar<T, Base, Iterator>)
+        {
+            // Start with blocks of eight digits, the remaining ones are handled below.
+            std::uint_least32_t digits;
+            while (_int_swar_digits(cur, end, digits))
+                traits::template add_digit_unchecked<100'000'000>(value, digits);
+        }
+
         while (cur != end)
         {
             auto digit = Base::digit_value(*cur++);
@@ -306,9 +340,22 @@ struct _bounded_integer_parser
         // At this point, we've parsed exactly one non-zero digit, so we can assign.
         auto value = typename traits::type(first_digit);
 
+        auto digit_count = std::size_t(1);
+        if constexpr (_int_has_swar<T, Base, Iterator> && max_digit_count > 9)
+        {
+            // Add eight digits at once, as long as none of them is the last one that can
+            // overflow; then the overflow check below remains exact.
+            std::uint_least32_t digits;
+            while (digit_count + 8 < max_digit_count && _int_swar_digits(cur, end, digits))
+            {
+                traits::template add_digit_unchecked<100'000'000>(value, digits);
+                digit_count += 8;
+            }
+        }
+
         // Handle at most the number of remaining digits.
         // Due to the fixed loop count, it is most likely unrolled.
-        for (std::size_t digit_count = 1; digit_count < max_digit_count; ++digit_count)
+        for (; digit_count < max_digit_count; ++digit_count)
         {
             // Find the next digit.
             auto digit = 0u;
@@ -386,6 +433,10 @@ struct _integer_parser_digits<T, _ndigits_s<N, Base, Sep>>
 template <typename T, typename Digits>
 using _integer_parser_for = typename _integer_parser_digits<T, Digits>::type;
 
+// Whether the parser doesn't need to convert anything as the value is discarded by the context.
+template <typename IntParser, typename Context>
+constexpr bool _int_skip_conversion = false;
+
 template <typename Token, typename IntParser, typename Tag>
 struct _int : _copy_base<Token>
 {
@@ -397,6 +448,14 @@ struct _int : _copy_base<Token>
                                            typename Reader::iterator begin,
                                            typename Reader::iterator end, Args&&... args)
         {
+            if constexpr (_int_skip_conversion<IntParser, Context>)
+            {
+                using value_type = LEXY_DECAY_DECLTYPE(IntParser::parse(begin, end).value);
+                return lexy::whitespace_parser<Context, NextParser>::parse(context, reader,
+                                                                           LEXY_FWD(args)...,
+                                                                           value_type());
+            }
+
             auto [value, overflow] = IntParser::parse(begin, end);
             if (overflow)
             {
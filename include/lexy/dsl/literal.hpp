@@ -8,6 +8,7 @@
 #include <lexy/_detail/integer_sequence.hpp>
 #include <lexy/_detail/iterator.hpp>
 #include <lexy/_detail/nttp_string.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/_detail/swar.hpp>
 #include <lexy/dsl/base.hpp>
 #include <lexy/dsl/token.hpp>
@@ -15,6 +16,12 @@
 //=== lit_matcher ===//
 namespace lexy::_detail
 {
+// If at least that many chars of a literal remain, they are compared using SIMD.
+constexpr std::size_t simd_literal_length = 16;
+
+template <typename CharType, std::size_t CurCharIndex, typename CharT, CharT... Cs>
+constexpr auto simd_literal_pack = simd_pack<CurCharIndex>(transcode_char<CharType>(Cs)...);
+
 template <std::size_t CurCharIndex, typename CharT, CharT... Cs, typename Reader>
 constexpr auto match_literal(Reader& reader)
 {
@@ -25,8 +32,33 @@ constexpr auto match_literal(Reader& reader)
         (void)reader;
         return std::true_type{};
     }
+#if LEXY_HAS_SIMD
+    // Same as below, but we compare up to a whole SIMD register at once.
+    // We only do that after the first SWAR comparison succeeded, as most attempts to match a
+    // literal fail early and SWAR is cheaper for that.
+    else if constexpr (is_simd_reader<Reader> && CurCharIndex > 0
+                       && sizeof...(Cs) - CurCharIndex >= simd_literal_length
+                       && std::is_same_v<char_type, typename Reader::encoding::int_type>)
+    {
+        constexpr const auto& pack = simd_literal_pack<char_type, CurCharIndex, CharT, Cs...>;
+
+        auto equal = simd_eq_mask(reader.peek_simd(), simd_load(pack.value)) & pack.mask;
+        if (equal == pack.mask)
+        {
+            reader.bump_simd(pack.count);
+            return bool(match_literal<CurCharIndex + pack.count, CharT, Cs...>(reader));
+        }
+        else
+        {
+            reader.bump_simd(simd_find_first_set(equal ^ pack.mask));
+            return false;
+        }
+    }
+#endif
     // We only use SWAR if the reader supports it and we have enough to fill at least one.
-    else if constexpr (is_swar_reader<Reader> && sizeof...(Cs) >= swar_length<char_type>)
+    // We also need an EOF sentinel, otherwise the literal could match the padding.
+    else if constexpr (is_swar_reader<Reader> && sizeof...(Cs) >= swar_length<char_type>
+                       && std::is_same_v<char_type, typename Reader::encoding::int_type>)
     {
         // Try and pack as many characters into a swar as possible, starting at the current
         // index.
@@ -148,6 +180,32 @@ struct lit_trie
 
         return result;
     }
+
+    // The chars of the path starting at node that only goes through nodes with a single transition
+    // and no value, as well as the node where it ends.
+    LEXY_CONSTEVAL auto node_chain(std::size_t node) const
+    {
+        struct
+        {
+            std::size_t length;
+            char_type   chars[max_transition_count];
+            std::size_t end;
+        } result{};
+
+        result.end = node;
+        while (result.end == node || node_value[result.end] == node_no_match)
+        {
+            auto transitions = node_transitions(result.end);
+            if (transitions.length != 1)
+                break;
+
+            auto trans                    = transitions.index[0];
+            result.chars[result.length++] = transition_char[trans];
+            result.end                    = transition_to[trans];
+        }
+
+        return result;
+    }
 };
 
 template <typename... CharClasses>
@@ -236,6 +294,146 @@ template <std::size_t CharClassIdx, typename... CharClasses>
 using _node_char_class
     = _node_char_class_impl<CharClassIdx, (CharClassIdx < sizeof...(CharClasses)), CharClasses...>;
 
+// A node of the trie with at least that many transitions is wide.
+constexpr std::size_t lit_trie_dfa_fanout = 6;
+
+// The trie lowered into a table of transitions, indexed by node and the class of the next byte,
+// which is walked by a loop.
+// It is used instead of lit_trie_matcher if most transitions after the first char leave a wide
+// node: the comparisons at such nodes are mispredicted a lot, while the table has only one branch.
+// If only the root is wide, the compiler turns the comparisons into a jump table,
+// and long chains of single transitions are matched faster by lit_trie_matcher as well.
+template <const auto& Trie>
+struct lit_trie_dfa;
+template <typename Encoding, template <typename> typename CaseFolding, std::size_t N,
+          typename... CharClasses, const lit_trie<Encoding, CaseFolding, N, CharClasses...>& Trie>
+struct lit_trie_dfa<Trie>
+{
+    using char_type = typename Encoding::char_type;
+
+    static LEXY_CONSTEVAL bool _is_bushy()
+    {
+        std::size_t fanout[Trie.node_count]{};
+        for (auto i = 0u; i != Trie.node_count - 1; ++i)
+            ++fanout[Trie.transition_from[i]];
+
+        auto inner_count = std::size_t(0);
+        auto wide_count  = std::size_t(0);
+        for (auto i = 0u; i != Trie.node_count - 1; ++i)
+        {
+            auto from = Trie.transition_from[i];
+            if (from == 0)
+                continue;
+
+            ++inner_count;
+            if (fanout[from] >= lit_trie_dfa_fanout)
+                ++wide_count;
+        }
+        return inner_count > 0 && 2 * wide_count >= inner_count;
+    }
+
+    // Whether we want to use the DFA for the trie.
+    static constexpr bool enabled = sizeof(char_type) == 1 && _is_bushy();
+
+    // Bytes that don't appear in a transition have class 0, all others are numbered.
+    static LEXY_CONSTEVAL auto _byte_classes()
+    {
+        struct
+        {
+            std::uint16_t of[256];
+            std::size_t   count;
+        } result{};
+
+        result.count = 1;
+        for (auto i = 0u; i != Trie.node_count - 1; ++i)
+        {
+            auto& cls = result.of[static_cast<unsigned char>(Trie.transition_char[i])];
+            if (cls == 0)
+                cls = static_cast<std::uint16_t>(result.count++);
+        }
+        return result;
+    }
+    static constexpr auto byte_classes = _byte_classes();
+
+    // An entry of the table is the offset of the row of the target node, shifted by one,
+    // and whether the target node has a value in the lowest bit.
+    // The root node is never the target of a transition, so 0 means no transition.
+    static constexpr auto _table_size = Trie.node_count * byte_classes.count;
+    using entry_type                  = std::conditional_t<
+        (2 * _table_size <= 0xFF), std::uint8_t,
+        std::conditional_t<(2 * _table_size <= 0xFFFF), std::uint16_t, std::uint32_t>>;
+
+    static LEXY_CONSTEVAL auto _transitions()
+    {
+        struct
+        {
+            entry_type next[_table_size];
+        } result{};
+
+        for (auto i = 0u; i != Trie.node_count - 1; ++i)
+        {
+            auto from  = Trie.transition_from[i];
+            auto to    = Trie.transition_to[i];
+            auto cls   = byte_classes.of[static_cast<unsigned char>(Trie.transition_char[i])];
+            auto entry = 2 * to * byte_classes.count + (Trie.node_value[to] != Trie.node_no_match);
+            result.next[from * byte_classes.count + cls] = static_cast<entry_type>(entry);
+        }
+        return result;
+    }
+    static constexpr auto transitions = _transitions();
+
+    template <std::size_t... Idx, typename Reader>
+    static constexpr bool _match_char_class(std::size_t char_class, const Reader& reader,
+                                            index_sequence<Idx...>)
+    {
+        return ((char_class == Idx && _node_char_class<Idx, CharClasses...>::match(reader)) || ...);
+    }
+
+    template <typename Reader>
+    static constexpr void _accept(std::size_t node, const Reader& reader, std::size_t& result,
+                                  typename Reader::marker& result_end)
+    {
+        if (_match_char_class(Trie.node_char_class[node], reader,
+                              index_sequence_for<CharClasses...>{}))
+            return;
+
+        result     = Trie.node_value[node];
+        result_end = reader.current();
+    }
+
+    template <typename Reader>
+    static constexpr std::size_t try_match(Reader& reader)
+    {
+        using encoding = typename Reader::encoding;
+        static_assert(sizeof(typename encoding::char_type) == 1);
+
+        // We remember the longest match while walking along the input as far as possible.
+        auto result     = Trie.node_no_match;
+        auto result_end = reader.current();
+        if constexpr (Trie.node_value[0] != Trie.node_no_match)
+            _accept(0, reader, result, result_end);
+
+        for (auto row = std::size_t(0);;)
+        {
+            auto c = reader.peek();
+            if (c == encoding::eof())
+                break;
+
+            auto entry = transitions.next[row + byte_classes.of[static_cast<unsigned char>(c)]];
+            if (entry == 0)
+                break;
+            reader.bump();
+
+            row = std::size_t(entry >> 1);
+            if ((entry & 1) != 0)
+                _accept(row / byte_classes.count, reader, result, result_end);
+        }
+
+        reader.reset(result_end);
+        return result;
+    }
+};
+
 template <const auto& Trie, std::size_t CurNode>
 struct lit_trie_matcher;
 template <typename Encoding, template <typename> typename CaseFolding, std::size_t N,
@@ -260,11 +458,20 @@ struct lit_trie_matcher<Trie, CurNode>
     }
 
     static constexpr auto transitions = Trie.node_transitions(CurNode);
+    static constexpr auto chain       = Trie.node_chain(CurNode);
 
-    template <typename Indices = make_index_sequence<transitions.length>>
+    // Whether we match a long chain of nodes with a single transition like a literal,
+    // instead of one node at a time.
+    template <typename Reader, typename Enc = typename Reader::encoding>
+    static constexpr bool _match_chain
+        = is_swar_reader<Reader> && chain.length >= swar_length<typename Enc::char_type>
+          && std::is_same_v<typename Enc::char_type, typename Enc::int_type>;
+
+    template <typename Indices      = make_index_sequence<transitions.length>,
+              typename ChainIndices = make_index_sequence<chain.length>>
     struct _impl;
-    template <std::size_t... Idx>
-    struct _impl<index_sequence<Idx...>>
+    template <std::size_t... Idx, std::size_t... ChainIdx>
+    struct _impl<index_sequence<Idx...>, index_sequence<ChainIdx...>>
     {
         template <typename Reader>
         LEXY_FORCE_INLINE static constexpr std::size_t try_match(Reader& reader)
@@ -273,12 +480,20 @@ struct lit_trie_matcher<Trie, CurNode>
 
             if constexpr (sizeof...(Idx) > 0)
             {
-                auto cur      = reader.current();
-                auto cur_char = reader.peek();
-
+                auto cur        = reader.current();
                 auto next_value = Trie.node_no_match;
-                (void)(_try_transition<transitions.index[Idx]>(next_value, reader, cur_char)
-                       || ...);
+                if constexpr (_match_chain<Reader>)
+                {
+                    using char_type = typename Reader::encoding::char_type;
+                    if (match_literal<0, char_type, chain.chars[ChainIdx]...>(reader))
+                        next_value = lit_trie_matcher<Trie, chain.end>::try_match(reader);
+                }
+                else
+                {
+                    auto cur_char = reader.peek();
+                    (void)(_try_transition<transitions.index[Idx]>(next_value, reader, cur_char)
+                           || ...);
+                }
                 if (next_value != Trie.node_no_match)
                     // We prefer a longer match.
                     return next_value;
@@ -307,7 +522,20 @@ struct lit_trie_matcher<Trie, CurNode>
     LEXY_FORCE_INLINE static constexpr std::size_t try_match(Reader& _reader)
     {
         static_assert(lexy::is_char_encoding<typename Reader::encoding>);
-        if constexpr (std::is_same_v<CaseFolding<Reader>, Reader>)
+        if constexpr (CurNode == 0 && lit_trie_dfa<Trie>::enabled)
+        {
+            // We have a wide trie, so walk the table instead.
+            if constexpr (std::is_same_v<CaseFolding<Reader>, Reader>)
+                return lit_trie_dfa<Trie>::try_match(_reader);
+            else
+            {
+                CaseFolding<Reader> reader{_reader};
+                auto                result = lit_trie_dfa<Trie>::try_match(reader);
+                _reader.reset(reader.current());
+                return result;
+            }
+        }
+        else if constexpr (std::is_same_v<CaseFolding<Reader>, Reader>)
         {
             return _impl<>::try_match(_reader);
         }
@@ -322,6 +550,145 @@ struct lit_trie_matcher<Trie, CurNode>
 };
 } // namespace lexy::_detail
 
+//=== lit_trie_skip ===//
+namespace lexy::_detail
+{
+// The chars a match of the trie can start with, including the EOF sentinel.
+template <const auto& Trie>
+struct _lit_trie_first_chars
+{
+    using _trie     = LEXY_DECAY_DECLTYPE(Trie);
+    using encoding  = typename _trie::encoding;
+    using char_type = typename encoding::char_type;
+
+    static constexpr auto _transitions = Trie.node_transitions(0);
+
+    static LEXY_CONSTEVAL auto _get()
+    {
+        struct
+        {
+            std::size_t length;
+            char_type   chars[_transitions.length + 1];
+        } result{};
+
+        // A trie never has two transitions with the same char from one node.
+        for (auto i = 0u; i != _transitions.length; ++i)
+        {
+            auto c = Trie.transition_char[_transitions.index[i]];
+            if (c != swar_eof<encoding>)
+                result.chars[result.length++] = c;
+        }
+        result.chars[result.length++] = swar_eof<encoding>;
+
+        return result;
+    }
+    static constexpr auto value = _get();
+
+    // A table of all ASCII chars that are *not* a first char; all other chars stop the search.
+    static LEXY_CONSTEVAL simd_char_table _get_other_table()
+    {
+        bool is_first[128] = {};
+        for (auto i = 0u; i != value.length; ++i)
+            if (static_cast<unsigned char>(value.chars[i]) < 128)
+                is_first[static_cast<unsigned char>(value.chars[i])] = true;
+
+        simd_char_table result{};
+        for (auto c = 0; c != 128; ++c)
+            if (!is_first[c])
+                result.lo[c & 0xF]
+                    = static_cast<unsigned char>(result.lo[c & 0xF] | (1 << (c >> 4)));
+        for (auto hi = 0; hi != 8; ++hi)
+            result.hi[hi] = static_cast<unsigned char>(1 << hi);
+        return result;
+    }
+    static constexpr auto other_table = _get_other_table();
+
+    // We can't skip anything if the trie matches the empty string, and we'd need to consider all
+    // case variants of the first chars if it is case folded.
+    static constexpr bool can_skip
+        = Trie.node_value[0] == Trie.node_no_match
+          && std::is_same_v<typename _trie::template reader<lexy::_pr8>, lexy::_pr8>;
+};
+
+template <const auto& Trie, typename Indices
+                            = make_index_sequence<_lit_trie_first_chars<Trie>::value.length>>
+struct lit_trie_skipper;
+template <const auto& Trie, std::size_t... Idx>
+struct lit_trie_skipper<Trie, index_sequence<Idx...>>
+{
+    using _first = _lit_trie_first_chars<Trie>;
+    using _char  = typename _first::char_type;
+
+    // Up to that many chars, we compare with each of them instead of using a lookup table.
+    static constexpr auto _max_compare_count = 4;
+
+    // Advances the reader to the next position where the trie might match, or EOF.
+    // Chars that can't start a match are skipped using SIMD or SWAR, the position it stops at
+    // needs to be checked with the actual trie.
+    template <typename Reader>
+    static constexpr void skip([[maybe_unused]] Reader& reader)
+    {
+        static_assert(std::is_same_v<typename Reader::encoding, typename _first::encoding>);
+        if constexpr (!_first::can_skip || !is_swar_reader<Reader>)
+        {
+            // We can't do anything.
+        }
+#if LEXY_USE_SIMD_DISPATCH
+        else if constexpr (is_simd_reader<Reader>)
+        {
+            if constexpr (sizeof...(Idx) <= 2)
+            {
+                constexpr auto& chars = _first::value.chars;
+                reader.bump_simd_to(
+                    simd_find_either(reader.simd_position(), static_cast<unsigned char>(chars[0]),
+                                     static_cast<unsigned char>(chars[sizeof...(Idx) - 1])));
+            }
+            else
+            {
+                // EOF is not in the table, so the search stops there.
+                reader.bump_simd_to(
+                    simd_find_class_end(reader.simd_position(), _first::other_table));
+            }
+        }
+#elif LEXY_HAS_SIMD
+        else if constexpr (is_simd_reader<Reader>)
+        {
+            while (true)
+            {
+                auto          cur = reader.peek_simd();
+                std::uint32_t mask;
+#    if LEXY_HAS_SIMD_SHUFFLE
+                if constexpr (sizeof...(Idx) > _max_compare_count)
+                    mask = simd_table_mismatch_mask(cur, _first::other_table);
+                else
+#    endif
+                    mask = (simd_eq_mask(cur, simd_fill(static_cast<unsigned char>(
+                                                  _first::value.chars[Idx])))
+                            | ...);
+
+                if (mask != 0)
+                {
+                    reader.bump_simd(simd_find_first_set(mask));
+                    break;
+                }
+                reader.bump_simd();
+            }
+        }
+#endif
+        else if constexpr (sizeof...(Idx) <= _max_compare_count)
+        {
+            while (true)
+            {
+                auto cur = reader.peek_swar();
+                if ((swar_has_char<_char, _first::value.chars[Idx]>(cur) || ...))
+                    break;
+                reader.bump_swar();
+            }
+        }
+    }
+};
+} // namespace lexy::_detail
+
 //=== lit ===//
 namespace lexyd
 {
@@ -488,7 +855,8 @@ constexpr auto token_kind_of<lexy::dsl::_lcp<Cp...>> = lexy::literal_token_kind;
 //=== lit_set ===//
 namespace lexy
 {
-template <typename T, template <typename> typename CaseFolding, typename... Strings>
+template <typename T, template <typename> typename CaseFolding, bool PerfectHash,
+          typename... Strings>
 class _symbol_table;
 
 struct expected_literal_set
@@ -598,8 +966,9 @@ constexpr auto literal_set(Literals...)
 }
 
 /// Matches one of the symbols in the symbol table.
-template <typename T, template <typename> typename CaseFolding, typename... Strings>
-constexpr auto literal_set(const lexy::_symbol_table<T, CaseFolding, Strings...>)
+template <typename T, template <typename> typename CaseFolding, bool PerfectHash,
+          typename... Strings>
+constexpr auto literal_set(const lexy::_symbol_table<T, CaseFolding, PerfectHash, Strings...>)
 {
     return _lset<decltype(_make_lit_rule<CaseFolding>(Strings{}))...>{};
 }
@@ -87,6 +87,12 @@ struct _peek : branch_base
         }
     };
 
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Rule, Encoding>();
+    }
+
     template <typename Error>
     static constexpr _peek<Rule, Error> error = {};
 };
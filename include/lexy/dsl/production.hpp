@@ -120,6 +120,12 @@ struct _prd
             }
         }
     };
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<lexy::production_rule<Production>, Encoding>();
+    }
 };
 
 /// Parses the production.
@@ -0,0 +1,106 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_DSL_REAL_HPP_INCLUDED
+#define LEXY_DSL_REAL_HPP_INCLUDED
+
+#include <lexy/_detail/real_conversion.hpp>
+#include <lexy/action/base.hpp>
+#include <lexy/dsl/base.hpp>
+#include <lexy/dsl/digit.hpp>
+#include <lexy/dsl/integer.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/token.hpp>
+
+namespace lexyd
+{
+template <typename Reader>
+constexpr bool _match_real(Reader& reader)
+{
+    // The integer part doesn't have leading zeros, so a zero is all of it.
+    if (!lexy::try_match_token(lit_c<'0'>, reader) && !_match_digits<decimal>(reader))
+        return false;
+
+    // The fraction needs at least one digit after the period.
+    if (lexy::try_match_token(lit_c<'.'>, reader) && !_match_digits<decimal>(reader))
+        return false;
+
+    // The exponent has an optional sign and needs at least one digit.
+    if (lexy::try_match_token(lit_c<'e'>, reader) || lexy::try_match_token(lit_c<'E'>, reader))
+    {
+        if (!lexy::try_match_token(lit_c<'+'>, reader))
+            lexy::try_match_token(lit_c<'-'>, reader);
+
+        if (!_match_digits<decimal>(reader))
+            return false;
+    }
+
+    return true;
+}
+
+struct _real_t : token_base<_real_t>
+{
+    template <typename Reader>
+    struct tp
+    {
+        typename Reader::marker end;
+
+        constexpr explicit tp(const Reader& reader) : end(reader.current()) {}
+
+        constexpr bool try_parse(Reader reader)
+        {
+            auto result = _match_real(reader);
+            end         = reader.current();
+            return result;
+        }
+
+        template <typename Context>
+        constexpr void report_error(Context& context, const Reader&)
+        {
+            auto err = lexy::error<Reader, lexy::expected_char_class>(end.position(),
+                                                                      decimal::char_class_name());
+            context.on(_ev::error{}, err);
+        }
+    };
+};
+
+template <typename T>
+struct _real_parser
+{
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "only float and double are supported");
+
+    using base = decimal;
+
+    struct result_type
+    {
+        T               value;
+        std::false_type overflow;
+    };
+
+    template <typename Iterator>
+    static result_type parse(Iterator cur, Iterator end)
+    {
+        // Values that are out of range are rounded to infinity or zero, so we never overflow.
+        return {lexy::_detail::parse_real<T>(cur, end), {}};
+    }
+};
+
+// The conversion never fails, so we don't need it when validating.
+template <typename T, typename Context>
+constexpr bool _int_skip_conversion<_real_parser<T>, Context>
+    = std::is_same_v<decltype(LEXY_DECLVAL(Context&).value_callback()),
+                     lexy::_detail::void_value_callback>;
+
+/// Parses a decimal number with optional fraction and exponent into a floating point type.
+template <typename T>
+constexpr auto real = _int<_real_t, _real_parser<T>, void>{};
+} // namespace lexyd
+
+namespace lexy
+{
+template <>
+constexpr auto token_kind_of<lexy::dsl::_real_t> = lexy::digits_token_kind;
+} // namespace lexy
+
+#endif // LEXY_DSL_REAL_HPP_INCLUDED
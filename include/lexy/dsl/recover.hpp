@@ -79,6 +79,8 @@ struct _find : _recovery_base
             context.on(_ev::recovery_start{}, begin);
             while (true)
             {
+                lexy::_detail::lit_trie_skipper<trie>::skip(reader);
+
                 auto end    = reader.current(); // *before* we've consumed Token/Limit
                 auto result = matcher::try_match(reader);
                 if (result == 0)
@@ -4,6 +4,9 @@
 #ifndef LEXY_DSL_SYMBOL_HPP_INCLUDED
 #define LEXY_DSL_SYMBOL_HPP_INCLUDED
 
+#include <lexy/_detail/memory_resource.hpp>
+#include <lexy/_detail/perfect_hash.hpp>
+#include <lexy/_detail/tuple.hpp>
 #include <lexy/dsl/base.hpp>
 #include <lexy/dsl/capture.hpp>
 #include <lexy/dsl/literal.hpp>
@@ -14,7 +17,8 @@ namespace lexy
 {
 #define LEXY_SYMBOL(Str) LEXY_NTTP_STRING(::lexy::_detail::type_string, Str)
 
-template <typename T, template <typename> typename CaseFolding, typename... Strings>
+template <typename T, template <typename> typename CaseFolding, bool PerfectHash,
+          typename... Strings>
 class _symbol_table
 {
     static auto _char_type()
@@ -22,7 +26,15 @@ class _symbol_table
         if constexpr (sizeof...(Strings) == 0)
             return;
         else
-            return std::common_type_t<typename Strings::char_type...>{};
+        {
+            // std::common_type_t is recursive and would limit the number of symbols,
+            // so we only use it if the symbols have different char types.
+            using first = typename _detail::_nth_type<0, Strings...>::type::char_type;
+            if constexpr ((std::is_same_v<first, typename Strings::char_type> && ...))
+                return first{};
+            else
+                return std::common_type_t<typename Strings::char_type...>{};
+        }
     }
 
 public:
@@ -42,14 +54,20 @@ public:
     template <typename CaseFoldingDSL>
     LEXY_CONSTEVAL auto case_folding(CaseFoldingDSL) const
     {
-        return _symbol_table<T, CaseFoldingDSL::template case_folding,
+        return _symbol_table<T, CaseFoldingDSL::template case_folding, PerfectHash,
+                             Strings...>(_detail::make_index_sequence<size()>{}, *this);
+    }
+
+    LEXY_CONSTEVAL auto perfect_hash() const
+    {
+        return _symbol_table<T, CaseFolding, true,
                              Strings...>(_detail::make_index_sequence<size()>{}, *this);
     }
 
     template <typename SymbolString, typename... Args>
     LEXY_CONSTEVAL auto map(Args&&... args) const
     {
-        using next_table = _symbol_table<T, CaseFolding, Strings..., SymbolString>;
+        using next_table = _symbol_table<T, CaseFolding, PerfectHash, Strings..., SymbolString>;
         if constexpr (empty())
             return next_table(_detail::make_index_sequence<0>{}, nullptr, LEXY_FWD(args)...);
         else
@@ -192,11 +210,27 @@ public:
     constexpr key_index parse(const Input& input) const
     {
         auto reader = input.reader();
-        auto result = try_parse(reader);
-        if (reader.peek() == decltype(reader)::encoding::eof())
-            return result;
+        if constexpr (PerfectHash)
+        {
+            using reader_t = decltype(reader);
+            if constexpr (std::is_same_v<CaseFolding<reader_t>, reader_t>)
+            {
+                return _lookup(reader);
+            }
+            else
+            {
+                CaseFolding<reader_t> folded{reader};
+                return _lookup(folded);
+            }
+        }
         else
-            return key_index();
+        {
+            auto result = try_parse(reader);
+            if (reader.peek() == decltype(reader)::encoding::eof())
+                return result;
+            else
+                return key_index();
+        }
     }
 
     constexpr const T& operator[](key_index idx) const noexcept
@@ -205,6 +239,9 @@ public:
         return _data[idx._value];
     }
 
+    // Whether parse() uses a perfect hash instead of the trie.
+    static constexpr bool _perfect_hash = PerfectHash;
+
 private:
     static constexpr auto _max_char_count = (0 + ... + Strings::size);
 
@@ -222,26 +259,542 @@ private:
     static constexpr lexy::_detail::lit_trie<Encoding, CaseFolding, _max_char_count> _trie
         = _build_trie<Encoding>();
 
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto _build_hash()
+    {
+        using char_type                      = typename Encoding::char_type;
+        constexpr const char_type* strings[] = {Strings::template c_str<char_type>...};
+        constexpr std::size_t      sizes[]   = {Strings::size...};
+
+        std::uint64_t hashes[size()]{};
+        for (auto i = 0u; i != size(); ++i)
+        {
+            auto hash = _detail::string_hash_init;
+            for (auto j = 0u; j != sizes[i]; ++j)
+                hash = _detail::string_hash_step(hash, static_cast<std::uint64_t>(
+                                                           Encoding::to_int_type(strings[i][j])));
+            hashes[i] = _detail::string_hash_finish(hash);
+        }
+
+        return _detail::perfect_hash<size()>::build(hashes, [&](std::size_t i, std::size_t j) {
+            if (sizes[i] != sizes[j])
+                return false;
+            for (auto k = 0u; k != sizes[i]; ++k)
+                if (strings[i][k] != strings[j][k])
+                    return false;
+            return true;
+        });
+    }
+    template <typename Encoding>
+    static constexpr _detail::perfect_hash<size()> _hash = _build_hash<Encoding>();
+
+    // Local constexpr arrays would be copied onto the stack on every lookup.
+    template <typename CharT>
+    static constexpr const CharT* _strings[] = {Strings::template c_str<CharT>...};
+    static constexpr std::size_t _sizes[empty() ? 1 : size()] = {Strings::size...};
+
+    // Looks up the remaining input of the reader: one hash and one comparison.
+    template <typename Reader>
+    static constexpr key_index _lookup(Reader& reader)
+    {
+        static_assert(!empty(), "symbol table must not be empty");
+        using encoding  = typename Reader::encoding;
+        using char_type = typename encoding::char_type;
+        static_assert(_hash<encoding>.valid, "cannot build a perfect hash for the symbol table");
+
+        auto begin  = reader.current();
+        auto hash   = _detail::string_hash_init;
+        auto length = std::size_t(0);
+        for (auto c = reader.peek(); c != encoding::eof(); c = reader.peek())
+        {
+            hash = _detail::string_hash_step(hash, static_cast<std::uint64_t>(c));
+            ++length;
+            reader.bump();
+        }
+
+        auto idx = _hash<encoding>.lookup(_detail::string_hash_finish(hash));
+        if (idx == _detail::perfect_hash<size()>::no_key || _sizes[idx] != length)
+            return key_index();
+
+        reader.reset(begin);
+        for (auto i = 0u; i != length; ++i)
+        {
+            if (reader.peek() != encoding::to_int_type(_strings<char_type>[idx][i]))
+                return key_index();
+            reader.bump();
+        }
+        return key_index(idx);
+    }
+
     template <std::size_t... Idx, typename... Args>
     constexpr explicit _symbol_table(lexy::_detail::index_sequence<Idx...>, const T* data,
                                      Args&&... args)
     // New data is appended at the end.
     : _data{data[Idx]..., T(LEXY_FWD(args)...)}
     {}
-    template <std::size_t... Idx, template <typename> typename OtherCaseFolding>
-    constexpr explicit _symbol_table(lexy::_detail::index_sequence<Idx...>,
-                                     const _symbol_table<T, OtherCaseFolding, Strings...>& table)
+    template <std::size_t... Idx, template <typename> typename OtherCaseFolding,
+              bool OtherPerfectHash>
+    constexpr explicit _symbol_table(
+        lexy::_detail::index_sequence<Idx...>,
+        const _symbol_table<T, OtherCaseFolding, OtherPerfectHash, Strings...>& table)
     : _data{table._data[Idx]...}
     {}
 
     std::conditional_t<empty(), char, T> _data[empty() ? 1 : size()];
 
-    template <typename, template <typename> typename, typename...>
+    template <typename, template <typename> typename, bool, typename...>
     friend class _symbol_table;
 };
 
 template <typename T>
-constexpr auto symbol_table = _symbol_table<T, _detail::lit_no_case_fold>{};
+constexpr auto symbol_table = _symbol_table<T, _detail::lit_no_case_fold, false>{};
+} // namespace lexy
+
+namespace lexy
+{
+struct _runtime_symbol_key_index
+{
+    std::size_t _value;
+
+    constexpr _runtime_symbol_key_index() noexcept : _value(std::size_t(-1)) {}
+    constexpr explicit _runtime_symbol_key_index(std::size_t idx) noexcept : _value(idx) {}
+
+    constexpr explicit operator bool() const noexcept
+    {
+        return _value != std::size_t(-1);
+    }
+
+    friend constexpr bool operator==(_runtime_symbol_key_index lhs,
+                                     _runtime_symbol_key_index rhs) noexcept
+    {
+        return lhs._value == rhs._value;
+    }
+    friend constexpr bool operator!=(_runtime_symbol_key_index lhs,
+                                     _runtime_symbol_key_index rhs) noexcept
+    {
+        return lhs._value != rhs._value;
+    }
+};
+
+/// A symbol table whose mappings are only known at runtime.
+/// It is built once and then stored as a flat hash table in a single allocation.
+template <typename T, typename Encoding = default_encoding, typename MemoryResource = void>
+class runtime_symbol_table
+{
+    static_assert(lexy::is_char_encoding<Encoding>);
+
+public:
+    using encoding    = Encoding;
+    using char_type   = typename encoding::char_type;
+    using key_type    = char_type;
+    using mapped_type = T;
+
+    struct value_type
+    {
+        const char_type*   symbol;
+        const mapped_type& value;
+    };
+
+    //=== constructors ===//
+    constexpr runtime_symbol_table() noexcept
+    : runtime_symbol_table(_detail::get_memory_resource<MemoryResource>())
+    {}
+    constexpr explicit runtime_symbol_table(MemoryResource* resource) noexcept
+    : _resource(resource), _memory(nullptr), _slots(nullptr), _slot_mask(0), _entries(nullptr),
+      _values(nullptr), _chars(nullptr), _size(0), _capacity(0), _char_count(0),
+      _length_mask(0), _max_length(0)
+    {}
+
+    /// Builds the table from a range of pairs of symbol and value.
+    /// The symbol is a string view: something with `.data()` and `.size()`;
+    /// if its character type is not the one of the encoding, it must only contain ASCII characters.
+    /// If a symbol is given multiple times, the last value wins.
+    /// The range is traversed twice, so it can't be a single-pass range like an input stream.
+    template <typename Mappings>
+    explicit runtime_symbol_table(const Mappings& mappings,
+                                  MemoryResource* resource
+                                  = _detail::get_memory_resource<MemoryResource>())
+    : runtime_symbol_table(resource)
+    {
+        for (const auto& [symbol, value] : mappings)
+        {
+            ++_capacity;
+            _char_count += symbol.size() + 1;
+            (void)value;
+        }
+        if (_capacity == 0)
+            return;
+
+        // We need at most 50% load, so probing ends quickly.
+        auto slot_count = std::size_t(1);
+        while (slot_count < 2 * _capacity)
+            slot_count *= 2;
+        _slot_mask = slot_count - 1;
+
+        _memory = _resource->allocate(_layout().size, _layout().alignment);
+        _slots  = static_cast<_slot*>(static_cast<void*>(_memory_at(_layout().slots)));
+        _entries
+            = static_cast<_entry*>(static_cast<void*>(_memory_at(_layout().entries)));
+        _values = static_cast<T*>(static_cast<void*>(_memory_at(_layout().values)));
+        _chars  = static_cast<char_type*>(static_cast<void*>(_memory_at(_layout().chars)));
+
+        for (auto i = 0u; i != slot_count; ++i)
+            ::new (static_cast<void*>(_slots + i)) _slot{0, _no_index};
+
+        auto offset = std::size_t(0);
+        for (const auto& [symbol, value] : mappings)
+        {
+            auto hash   = _detail::string_hash_init;
+            auto length = std::size_t(symbol.size());
+            for (auto i = 0u; i != length; ++i)
+            {
+                auto c             = _transcode(symbol.data()[i]);
+                _chars[offset + i] = c;
+                hash = _detail::string_hash_step(hash,
+                                                 static_cast<std::uint64_t>(
+                                                     encoding::to_int_type(c)));
+            }
+            _chars[offset + length] = char_type();
+
+            ::new (static_cast<void*>(_entries + _size)) _entry{offset, length};
+            if (auto existing = _insert(_detail::string_hash_finish(hash), _size);
+                existing != _size)
+            {
+                // We already have the symbol, so only update its value;
+                // the characters we've just written will be overwritten by the next symbol.
+                _values[existing] = value;
+                continue;
+            }
+
+            ::new (static_cast<void*>(_values + _size)) T(value);
+            ++_size;
+            offset += length + 1;
+
+            _length_mask |= _length_bit(length);
+            if (length > _max_length)
+                _max_length = length;
+        }
+    }
+
+    runtime_symbol_table(const runtime_symbol_table&)            = delete;
+    runtime_symbol_table& operator=(const runtime_symbol_table&) = delete;
+
+    runtime_symbol_table(runtime_symbol_table&& other) noexcept
+    : _resource(other._resource), _memory(other._memory), _slots(other._slots),
+      _slot_mask(other._slot_mask), _entries(other._entries), _values(other._values),
+      _chars(other._chars), _size(other._size), _capacity(other._capacity),
+      _char_count(other._char_count), _length_mask(other._length_mask),
+      _max_length(other._max_length)
+    {
+        other._memory = nullptr;
+        other._size   = 0;
+    }
+
+    runtime_symbol_table& operator=(runtime_symbol_table&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        _free();
+        _resource    = other._resource;
+        _memory      = other._memory;
+        _slots       = other._slots;
+        _slot_mask   = other._slot_mask;
+        _entries     = other._entries;
+        _values      = other._values;
+        _chars       = other._chars;
+        _size        = other._size;
+        _capacity    = other._capacity;
+        _char_count  = other._char_count;
+        _length_mask = other._length_mask;
+        _max_length  = other._max_length;
+
+        other._memory = nullptr;
+        other._size   = 0;
+        return *this;
+    }
+
+    ~runtime_symbol_table() noexcept
+    {
+        _free();
+    }
+
+    //=== access ===//
+    constexpr bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    class iterator
+    : public lexy::_detail::bidirectional_iterator_base<iterator, value_type, value_type, void>
+    {
+    public:
+        constexpr iterator() noexcept : _table(nullptr), _idx(0) {}
+
+        constexpr value_type deref() const noexcept
+        {
+            LEXY_PRECONDITION(_table && _idx < _table->_size);
+            return value_type{_table->_chars + _table->_entries[_idx].offset,
+                              _table->_values[_idx]};
+        }
+
+        constexpr void increment() noexcept
+        {
+            LEXY_PRECONDITION(_idx != _table->_size);
+            ++_idx;
+        }
+        constexpr void decrement() noexcept
+        {
+            LEXY_PRECONDITION(_idx != 0);
+            --_idx;
+        }
+
+        constexpr bool equal(iterator rhs) const noexcept
+        {
+            LEXY_PRECONDITION(_table == rhs._table);
+            return _idx == rhs._idx;
+        }
+
+    private:
+        constexpr iterator(const runtime_symbol_table* table, std::size_t idx) noexcept
+        : _table(table), _idx(idx)
+        {}
+
+        const runtime_symbol_table* _table;
+        std::size_t                 _idx;
+
+        friend runtime_symbol_table;
+    };
+
+    constexpr iterator begin() const noexcept
+    {
+        return iterator(this, 0);
+    }
+    constexpr iterator end() const noexcept
+    {
+        return iterator(this, _size);
+    }
+
+    using key_index = _runtime_symbol_key_index;
+
+    template <typename Reader>
+    constexpr key_index try_parse(Reader& reader) const
+    {
+        static_assert(std::is_same_v<typename Reader::encoding, encoding>);
+        if (empty())
+            return key_index();
+
+        // We hash incrementally and look for a symbol at every length that has one,
+        // remembering the longest one.
+        auto result     = key_index();
+        auto result_end = reader.current();
+
+        auto begin  = reader.current();
+        auto hash   = _detail::string_hash_init;
+        auto length = std::size_t(0);
+        while (true)
+        {
+            if ((_length_mask & _length_bit(length)) != 0)
+            {
+                auto cur = reader.current();
+                reader.reset(begin);
+                if (auto idx = _find(_detail::string_hash_finish(hash), reader, length);
+                    idx != _no_index)
+                {
+                    result     = key_index(idx);
+                    result_end = cur;
+                }
+                reader.reset(cur);
+            }
+
+            auto c = reader.peek();
+            if (length == _max_length || c == encoding::eof())
+                break;
+
+            hash = _detail::string_hash_step(hash, static_cast<std::uint64_t>(c));
+            ++length;
+            reader.bump();
+        }
+
+        reader.reset(result_end);
+        return result;
+    }
+
+    template <typename Input>
+    constexpr key_index parse(const Input& input) const
+    {
+        auto reader = input.reader();
+        static_assert(std::is_same_v<typename decltype(reader)::encoding, encoding>);
+
+        auto begin  = reader.current();
+        auto hash   = _detail::string_hash_init;
+        auto length = std::size_t(0);
+        for (auto c = reader.peek(); c != encoding::eof(); c = reader.peek())
+        {
+            if (length == _max_length)
+                return key_index();
+
+            hash = _detail::string_hash_step(hash, static_cast<std::uint64_t>(c));
+            ++length;
+            reader.bump();
+        }
+        if (empty() || (_length_mask & _length_bit(length)) == 0)
+            return key_index();
+
+        reader.reset(begin);
+        auto idx = _find(_detail::string_hash_finish(hash), reader, length);
+        return idx == _no_index ? key_index() : key_index(idx);
+    }
+
+    constexpr const T& operator[](key_index idx) const noexcept
+    {
+        LEXY_PRECONDITION(idx && idx._value < _size);
+        return _values[idx._value];
+    }
+
+private:
+    static constexpr auto _no_index = std::size_t(-1);
+
+    struct _slot
+    {
+        std::uint64_t hash;
+        std::size_t   index; // _no_index if the slot is empty
+    };
+    struct _entry
+    {
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    template <typename CharT>
+    static constexpr char_type _transcode(CharT c) noexcept
+    {
+        if constexpr (std::is_same_v<CharT, char_type>)
+            return c;
+        else
+        {
+            LEXY_PRECONDITION(_detail::is_ascii(c));
+            return static_cast<char_type>(c);
+        }
+    }
+
+    // One bit per symbol length; all lengths >= 63 share the last one.
+    static constexpr std::uint64_t _length_bit(std::size_t length) noexcept
+    {
+        return std::uint64_t(1) << (length < 63 ? length : 63);
+    }
+
+    // Inserts the symbol with the specified index, unless it already has one, whose index is
+    // returned then.
+    std::size_t _insert(std::uint64_t hash, std::size_t index) noexcept
+    {
+        for (auto slot = std::size_t(hash) & _slot_mask;; slot = (slot + 1) & _slot_mask)
+        {
+            auto& cur = _slots[slot];
+            if (cur.index == _no_index)
+            {
+                cur = _slot{hash, index};
+                return index;
+            }
+            else if (cur.hash == hash && _same_symbol(_entries[cur.index], _entries[index]))
+                return cur.index;
+        }
+    }
+
+    bool _same_symbol(_entry lhs, _entry rhs) const noexcept
+    {
+        if (lhs.length != rhs.length)
+            return false;
+        for (auto i = 0u; i != lhs.length; ++i)
+            if (_chars[lhs.offset + i] != _chars[rhs.offset + i])
+                return false;
+        return true;
+    }
+
+    // Returns the index of the symbol of the specified length that the reader begins with.
+    template <typename Reader>
+    constexpr std::size_t _find(std::uint64_t hash, Reader& reader, std::size_t length) const
+    {
+        for (auto slot = std::size_t(hash) & _slot_mask;; slot = (slot + 1) & _slot_mask)
+        {
+            auto cur = _slots[slot];
+            if (cur.index == _no_index)
+                return _no_index;
+            else if (cur.hash != hash || _entries[cur.index].length != length)
+                continue;
+
+            auto begin  = reader.current();
+            auto symbol = _chars + _entries[cur.index].offset;
+            auto i      = std::size_t(0);
+            for (; i != length; ++i)
+            {
+                if (reader.peek() != encoding::to_int_type(symbol[i]))
+                    break;
+                reader.bump();
+            }
+            if (i == length)
+                return cur.index;
+            reader.reset(begin);
+        }
+    }
+
+    struct _layout_t
+    {
+        std::size_t slots, entries, values, chars, size, alignment;
+    };
+    _layout_t _layout() const noexcept
+    {
+        auto align = [](std::size_t offset, std::size_t alignment) {
+            return (offset + alignment - 1) / alignment * alignment;
+        };
+
+        _layout_t result{};
+        result.slots   = 0;
+        result.entries = align(result.slots + (_slot_mask + 1) * sizeof(_slot), alignof(_entry));
+        result.values  = align(result.entries + _capacity * sizeof(_entry), alignof(T));
+        result.chars   = align(result.values + _capacity * sizeof(T), alignof(char_type));
+        result.size    = result.chars + _char_count * sizeof(char_type);
+
+        result.alignment = alignof(_slot);
+        if (alignof(T) > result.alignment)
+            result.alignment = alignof(T);
+        return result;
+    }
+    unsigned char* _memory_at(std::size_t offset) const noexcept
+    {
+        return static_cast<unsigned char*>(_memory) + offset;
+    }
+
+    void _free() noexcept
+    {
+        if (_memory == nullptr)
+            return;
+
+        for (auto i = 0u; i != _size; ++i)
+            _values[i].~T();
+        _resource->deallocate(_memory, _layout().size, _layout().alignment);
+        _memory   = nullptr;
+        _size     = 0;
+        _capacity = 0;
+    }
+
+    LEXY_EMPTY_MEMBER _detail::memory_resource_ptr<MemoryResource> _resource;
+    void*                                                          _memory;
+
+    _slot*        _slots;
+    std::size_t   _slot_mask;
+    _entry*       _entries;
+    T*            _values;
+    char_type*    _chars;
+    std::size_t   _size, _capacity, _char_count;
+    std::uint64_t _length_mask;
+    std::size_t   _max_length;
+};
 } // namespace lexy
 
 namespace lexy
@@ -262,6 +815,38 @@ struct _idp;
 template <typename Leading, typename Trailing, typename... Reserved>
 struct _id;
 
+// How the rules access the symbol table: `Table` is either the table itself,
+// or a function that returns a runtime symbol table given the parse state.
+template <const auto& Table, typename = LEXY_DECAY_DECLTYPE(Table)>
+struct _sym_table
+{
+    using key_index = lexy::_runtime_symbol_key_index;
+    // It is a hash table, so parsing the entire token and looking it up is cheaper.
+    static constexpr bool prefer_parse = true;
+
+    template <typename ControlBlock>
+    static constexpr const auto& get(const ControlBlock* cb)
+    {
+        static_assert(!std::is_void_v<typename ControlBlock::state_type>,
+                      "a runtime symbol table requires that a state is passed to lexy::parse()");
+        return Table(*cb->parse_state);
+    }
+};
+template <const auto& Table, typename T, template <typename> typename CaseFolding, bool PerfectHash,
+          typename... Strings>
+struct _sym_table<Table, lexy::_symbol_table<T, CaseFolding, PerfectHash, Strings...>>
+{
+    using key_index =
+        typename lexy::_symbol_table<T, CaseFolding, PerfectHash, Strings...>::key_index;
+    static constexpr bool prefer_parse = PerfectHash;
+
+    template <typename ControlBlock>
+    static constexpr const auto& get(const ControlBlock*)
+    {
+        return Table;
+    }
+};
+
 template <const auto& Table, typename Token, typename Tag>
 struct _sym : branch_base
 {
@@ -270,15 +855,16 @@ struct _sym : branch_base
     {
         static_assert(lexy::is_char_encoding<typename Reader::encoding>);
         typename Reader::marker end;
-        typename LEXY_DECAY_DECLTYPE(Table)::key_index symbol;
+        typename _sym_table<Table>::key_index symbol;
 
-        constexpr auto value() const
+        template <typename ControlBlock>
+        constexpr auto value(const ControlBlock* cb) const
         {
-            return Table[symbol];
+            return _sym_table<Table>::get(cb)[symbol];
         }
 
         template <typename ControlBlock>
-        constexpr bool try_parse(ControlBlock&, const Reader& reader)
+        constexpr bool try_parse(const ControlBlock* cb, const Reader& reader)
         {
             // Try and parse the token.
             lexy::token_parser_for<Token, Reader> parser(reader);
@@ -288,7 +874,7 @@ struct _sym : branch_base
 
             // Check whether this is a symbol.
             auto content = lexy::partial_input(reader, end.position());
-            symbol       = Table.parse(content);
+            symbol       = _sym_table<Table>::get(cb).parse(content);
 
             // Only succeed if it is a symbol.
             return static_cast<bool>(symbol);
@@ -307,7 +893,8 @@ struct _sym : branch_base
 
             // And continue parsing with the symbol value after whitespace skipping.
             using continuation = lexy::whitespace_parser<Context, NextParser>;
-            return continuation::parse(context, reader, LEXY_FWD(args)..., Table[symbol]);
+            auto& table        = _sym_table<Table>::get(context.control_block);
+            return continuation::parse(context, reader, LEXY_FWD(args)..., table[symbol]);
         }
     };
 
@@ -322,8 +909,9 @@ struct _sym : branch_base
                                                lexy::lexeme<Reader> lexeme)
             {
                 // Check whether the captured lexeme is a symbol.
-                auto content = lexy::partial_input(reader, lexeme.begin(), lexeme.end());
-                auto symbol  = Table.parse(content);
+                auto& table   = _sym_table<Table>::get(context.control_block);
+                auto  content = lexy::partial_input(reader, lexeme.begin(), lexeme.end());
+                auto  symbol  = table.parse(content);
                 if (!symbol)
                 {
                     // Unknown symbol.
@@ -334,7 +922,7 @@ struct _sym : branch_base
                 }
 
                 // Continue parsing with the symbol value.
-                return NextParser::parse(context, reader, LEXY_FWD(args)..., Table[symbol]);
+                return NextParser::parse(context, reader, LEXY_FWD(args)..., table[symbol]);
             }
         };
 
@@ -356,6 +944,9 @@ struct _sym : branch_base
 // Optimization for identifiers: instead of parsing an entire identifier (which requires checking
 // every character against the char class), parse a symbol and check whether the next character
 // would continue the identifier. This is the same optimization that is done for keywords.
+//
+// If the table uses a perfect hash, we can't parse a symbol directly, so we parse the identifier
+// and hash it instead.
 template <const auto& Table, typename L, typename T, typename Tag>
 struct _sym<Table, _idp<L, T>, Tag> : branch_base
 {
@@ -363,24 +954,41 @@ struct _sym<Table, _idp<L, T>, Tag> : branch_base
     struct bp
     {
         static_assert(lexy::is_char_encoding<typename Reader::encoding>);
-        typename LEXY_DECAY_DECLTYPE(Table)::key_index symbol;
+        typename _sym_table<Table>::key_index symbol;
         typename Reader::marker end;
 
-        constexpr auto value() const
+        template <typename ControlBlock>
+        constexpr auto value(const ControlBlock* cb) const
         {
-            return Table[symbol];
+            return _sym_table<Table>::get(cb)[symbol];
         }
 
-        constexpr bool try_parse(const void*, Reader reader)
+        template <typename ControlBlock>
+        constexpr bool try_parse(const ControlBlock* cb, Reader reader)
         {
-            // Try to parse a symbol.
-            symbol = Table.try_parse(reader);
-            if (!symbol)
-                return false;
-            end = reader.current();
+            auto& table = _sym_table<Table>::get(cb);
+            if constexpr (_sym_table<Table>::prefer_parse)
+            {
+                // Parse the identifier and check whether it is a symbol.
+                auto begin = reader.position();
+                if (!lexy::try_match_token(_idp<L, T>{}, reader))
+                    return false;
+                end = reader.current();
+
+                symbol = table.parse(lexy::partial_input(reader, begin, end.position()));
+                return static_cast<bool>(symbol);
+            }
+            else
+            {
+                // Try to parse a symbol.
+                symbol = table.try_parse(reader);
+                if (!symbol)
+                    return false;
+                end = reader.current();
 
-            // We had a symbol, but it must not be the prefix of a valid identifier.
-            return !lexy::try_match_token(T{}, reader);
+                // We had a symbol, but it must not be the prefix of a valid identifier.
+                return !lexy::try_match_token(T{}, reader);
+            }
         }
 
         template <typename Context>
@@ -396,7 +1004,8 @@ struct _sym<Table, _idp<L, T>, Tag> : branch_base
 
             // And continue parsing with the symbol value after whitespace skipping.
             using continuation = lexy::whitespace_parser<Context, NextParser>;
-            return continuation::parse(context, reader, LEXY_FWD(args)..., Table[symbol]);
+            auto& table        = _sym_table<Table>::get(context.control_block);
+            return continuation::parse(context, reader, LEXY_FWD(args)..., table[symbol]);
         }
     };
 
@@ -407,37 +1016,61 @@ struct _sym<Table, _idp<L, T>, Tag> : branch_base
         LEXY_PARSER_FUNC static bool parse(Context& context, Reader& reader, Args&&... args)
         {
             static_assert(lexy::is_char_encoding<typename Reader::encoding>);
-            auto begin = reader.position();
+            auto  begin = reader.position();
+            auto& table = _sym_table<Table>::get(context.control_block);
 
-            // Try to parse a symbol that is not the prefix of an identifier.
-            auto symbol_reader = reader;
-            auto symbol        = Table.try_parse(symbol_reader);
-            if (!symbol || lexy::try_match_token(T{}, symbol_reader))
+            if constexpr (_sym_table<Table>::prefer_parse)
             {
-                // Unknown symbol or not an identifier.
-                // Parse the identifier pattern normally, and see if that fails.
-                using id_parser = lexy::parser_for<_idp<L, T>, lexy::pattern_parser<>>;
-                if (!id_parser::parse(context, reader))
-                    // It did fail, so it reported an error and we're done here.
+                // Parse the identifier pattern, and see if that fails.
+                if (!_idp<L, T>::token_parse(context, reader))
                     return false;
 
-                // We're having a valid identifier but unknown symbol.
-                using tag = lexy::_detail::type_or<Tag, lexy::unknown_symbol>;
-                auto err  = lexy::error<Reader, tag>(begin, reader.position());
-                context.on(_ev::error{}, err);
+                auto symbol = table.parse(lexy::partial_input(reader, begin, reader.position()));
+                if (!symbol)
+                {
+                    // We're having a valid identifier but unknown symbol.
+                    using tag = lexy::_detail::type_or<Tag, lexy::unknown_symbol>;
+                    auto err  = lexy::error<Reader, tag>(begin, reader.position());
+                    context.on(_ev::error{}, err);
+                    return false;
+                }
 
-                return false;
+                // And continue parsing with the symbol value after whitespace skipping.
+                using continuation = lexy::whitespace_parser<Context, NextParser>;
+                return continuation::parse(context, reader, LEXY_FWD(args)..., table[symbol]);
             }
             else
             {
-                // We need to consume and report the identifier pattern.
-                auto end = symbol_reader.current();
-                context.on(_ev::token{}, _idp<L, T>{}, begin, end.position());
-                reader.reset(end);
+                // Try to parse a symbol that is not the prefix of an identifier.
+                auto symbol_reader = reader;
+                auto symbol        = table.try_parse(symbol_reader);
+                if (!symbol || lexy::try_match_token(T{}, symbol_reader))
+                {
+                    // Unknown symbol or not an identifier.
+                    // Parse the identifier pattern normally, and see if that fails.
+                    using id_parser = lexy::parser_for<_idp<L, T>, lexy::pattern_parser<>>;
+                    if (!id_parser::parse(context, reader))
+                        // It did fail, so it reported an error and we're done here.
+                        return false;
+
+                    // We're having a valid identifier but unknown symbol.
+                    using tag = lexy::_detail::type_or<Tag, lexy::unknown_symbol>;
+                    auto err  = lexy::error<Reader, tag>(begin, reader.position());
+                    context.on(_ev::error{}, err);
 
-                // And continue parsing with the symbol value after whitespace skipping.
-                using continuation = lexy::whitespace_parser<Context, NextParser>;
-                return continuation::parse(context, reader, LEXY_FWD(args)..., Table[symbol]);
+                    return false;
+                }
+                else
+                {
+                    // We need to consume and report the identifier pattern.
+                    auto end = symbol_reader.current();
+                    context.on(_ev::token{}, _idp<L, T>{}, begin, end.position());
+                    reader.reset(end);
+
+                    // And continue parsing with the symbol value after whitespace skipping.
+                    using continuation = lexy::whitespace_parser<Context, NextParser>;
+                    return continuation::parse(context, reader, LEXY_FWD(args)..., table[symbol]);
+                }
             }
         }
     };
@@ -454,18 +1087,20 @@ struct _sym<Table, void, Tag> : branch_base
     struct bp
     {
         static_assert(lexy::is_char_encoding<typename Reader::encoding>);
-        typename LEXY_DECAY_DECLTYPE(Table)::key_index symbol;
+        typename _sym_table<Table>::key_index symbol;
         typename Reader::marker end;
 
-        constexpr auto value() const
+        template <typename ControlBlock>
+        constexpr auto value(const ControlBlock* cb) const
         {
-            return Table[symbol];
+            return _sym_table<Table>::get(cb)[symbol];
         }
 
-        constexpr bool try_parse(const void*, Reader reader)
+        template <typename ControlBlock>
+        constexpr bool try_parse(const ControlBlock* cb, Reader reader)
         {
             // Try to parse a symbol.
-            symbol = Table.try_parse(reader);
+            symbol = _sym_table<Table>::get(cb).try_parse(reader);
             end    = reader.current();
 
             // Only succeed if it is a symbol.
@@ -486,7 +1121,8 @@ struct _sym<Table, void, Tag> : branch_base
 
             // And continue parsing with the symbol value after whitespace skipping.
             using continuation = lexy::whitespace_parser<Context, NextParser>;
-            return continuation::parse(context, reader, LEXY_FWD(args)..., Table[symbol]);
+            auto& table        = _sym_table<Table>::get(context.control_block);
+            return continuation::parse(context, reader, LEXY_FWD(args)..., table[symbol]);
         }
     };
 
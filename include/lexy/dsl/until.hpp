@@ -4,28 +4,69 @@
 #ifndef LEXY_DSL_UNTIL_HPP_INCLUDED
 #define LEXY_DSL_UNTIL_HPP_INCLUDED
 
+#include <lexy/_detail/simd.hpp>
 #include <lexy/_detail/swar.hpp>
 #include <lexy/dsl/base.hpp>
+#include <lexy/dsl/literal.hpp>
 #include <lexy/dsl/token.hpp>
 
 namespace lexyd
 {
 struct _nl;
 
+template <typename Condition>
+constexpr auto _until_lset()
+{
+    if constexpr (lexy::is_literal_set_rule<Condition>)
+        return typename Condition::as_lset{};
+    else
+        return _lset<Condition>{};
+}
+
 template <typename Condition, typename Reader>
 constexpr void _until_swar([[maybe_unused]] Reader& reader)
 {
-    if constexpr (std::is_same_v<Condition, _nl> //
-                  && lexy::_detail::is_swar_reader<Reader>)
+    if constexpr (lexy::is_literal_rule<Condition> || lexy::is_literal_set_rule<Condition>)
+    {
+        // We skip to the next char that can start the literal.
+        using lset                 = decltype(_until_lset<Condition>());
+        constexpr const auto& trie = lset::template _t<typename Reader::encoding>;
+        lexy::_detail::lit_trie_skipper<trie>::skip(reader);
+    }
+    else if constexpr (std::is_same_v<Condition, _nl> //
+                       && lexy::_detail::is_swar_reader<Reader>)
     {
         // We use SWAR to skip characters until we have one that is <= 0xF or EOF.
         // Then we need to inspect it in more detail.
-        using char_type = typename Reader::encoding::char_type;
+        using encoding  = typename Reader::encoding;
+        using char_type = typename encoding::char_type;
+
+#if LEXY_USE_SIMD_DISPATCH
+        if constexpr (lexy::_detail::is_simd_reader<Reader>)
+        {
+            // Every newline ends in '\n', so we can search for that (or EOF) directly.
+            reader.bump_simd_to(lexy::_detail::simd_find_either(
+                reader.simd_position(), '\n',
+                static_cast<unsigned char>(lexy::_detail::swar_eof<encoding>)));
+        }
+#elif LEXY_HAS_SIMD
+        if constexpr (lexy::_detail::is_simd_reader<Reader>)
+        {
+            while (true)
+            {
+                auto cur = reader.peek_simd();
+                if (lexy::_detail::simd_has_char<char_type, lexy::_detail::swar_eof<encoding>>(cur)
+                    || lexy::_detail::simd_has_char_less<char_type, 0xF>(cur))
+                    break;
+                reader.bump_simd();
+            }
+        }
+#endif
 
         while (true)
         {
             auto cur = reader.peek_swar();
-            if (lexy::_detail::swar_has_char<char_type, Reader::encoding::eof()>(cur)
+            if (lexy::_detail::swar_has_char<char_type, lexy::_detail::swar_eof<encoding>>(cur)
                 || lexy::_detail::swar_has_char_less<char_type, 0xF>(cur))
                 break;
             reader.bump_swar();
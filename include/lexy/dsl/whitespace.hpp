@@ -4,10 +4,14 @@
 #ifndef LEXY_DSL_WHITESPACE_HPP_INCLUDED
 #define LEXY_DSL_WHITESPACE_HPP_INCLUDED
 
+#include <lexy/_detail/simd.hpp>
 #include <lexy/_detail/swar.hpp>
+#include <lexy/_detail/tuple.hpp>
 #include <lexy/action/base.hpp>
 #include <lexy/dsl/base.hpp>
+#include <lexy/dsl/char_class.hpp>
 #include <lexy/dsl/choice.hpp>
+#include <lexy/dsl/if.hpp>
 #include <lexy/dsl/loop.hpp>
 #include <lexy/dsl/token.hpp>
 
@@ -33,6 +37,18 @@ template <typename Rule>
 struct ws_production<lexyd::_wsr<Rule>> : ws_production<Rule>
 {};
 
+// Parse this production to skip whitespace once, instead of in a loop.
+template <typename WhitespaceRule>
+struct ws_once_production
+{
+    static constexpr auto name                = "<whitespace>";
+    static constexpr auto max_recursion_depth = 0;
+    static constexpr auto rule                = lexy::dsl::if_(WhitespaceRule{});
+};
+template <typename Rule>
+struct ws_once_production<lexyd::_wsr<Rule>> : ws_once_production<Rule>
+{};
+
 // A special handler for parsing whitespace.
 // It only forwards error events and ignores all others.
 template <typename Handler>
@@ -53,6 +69,9 @@ public:
         template <typename Rule>
         constexpr event_handler(ws_production<Rule>)
         {}
+        template <typename Rule>
+        constexpr event_handler(ws_once_production<Rule>)
+        {}
         template <typename Production>
         constexpr event_handler(Production)
         {
@@ -99,35 +118,136 @@ ws_handler(Context& context) -> ws_handler<typename Context::handler_type>;
 template <typename>
 using ws_result = bool;
 
-template <typename WhitespaceRule>
-constexpr bool space_is_definitely_whitespace()
+// The char class of the whitespace rule whose runs can be skipped at once, or void.
+// It is either the whitespace rule itself, or a char class of a choice.
+template <typename WhitespaceRule, typename Encoding, typename = void>
+struct _ws_char_class
 {
-    if constexpr (lexy::is_char_class_rule<WhitespaceRule>)
-        return WhitespaceRule::char_class_ascii().contains[int(' ')];
-    else
-        return false;
+    using type = void;
+};
+template <typename WhitespaceRule, typename Encoding>
+struct _ws_char_class<WhitespaceRule, Encoding,
+                      std::enable_if_t<lexy::is_char_class_rule<WhitespaceRule>>>
+{
+    using type = WhitespaceRule;
+};
+template <typename... R, typename Encoding>
+struct _ws_char_class<lexyd::_chc<R...>, Encoding>
+{
+    // The choice tries the alternatives in order, so we can only skip the char class if none of
+    // the earlier alternatives can start with one of its characters.
+    static LEXY_CONSTEVAL std::size_t _index()
+    {
+        constexpr bool      char_class[] = {lexy::is_char_class_rule<R>...};
+        constexpr first_set sets[]       = {first_set_of<R, Encoding>()...};
+
+        first_set earlier;
+        for (auto i = 0u; i != sizeof...(R); ++i)
+        {
+            if (char_class[i] && (i == 0 || !sets[i].overlaps(earlier)))
+                return i;
+            earlier.insert(sets[i]);
+        }
+        return sizeof...(R);
+    }
+
+    // If there is none, we select the trailing void.
+    using type = typename _nth_type<_index(), R..., void>::type;
+};
+template <typename Rule, typename Encoding>
+struct _ws_char_class<lexyd::_wsr<Rule>, Encoding> : _ws_char_class<Rule, Encoding>
+{};
+
+template <typename WhitespaceRule, typename Encoding>
+using ws_char_class = typename _ws_char_class<WhitespaceRule, Encoding>::type;
+
+// Returns true if the SWAR word consists only of characters of the char class.
+// Like `char_class_match_swar()`, it can return false even though all characters match.
+template <typename CharClass, typename Encoding>
+constexpr bool ws_match_swar(swar_int cur)
+{
+    using char_type = typename Encoding::char_type;
+    if constexpr (CharClass::char_class_ascii().contains[int(' ')])
+    {
+        if (cur == swar_fill(char_type(' ')))
+            return true;
+    }
+
+    return CharClass::template char_class_match_swar<Encoding>(cur);
+}
+
+// Skips as many characters of the char class as possible at once.
+// It may stop early, so the caller still needs to match the whitespace rule.
+template <typename CharClass, typename Reader>
+LEXY_FORCE_INLINE constexpr void ws_skip_char_class(Reader& reader)
+{
+    using encoding = typename Reader::encoding;
+
+    // Most whitespace is short, e.g. a single space between two tokens.
+    // A SIMD compare has too much latency for that, so we only use it if we have a full SWAR word,
+    // e.g. for indentation.
+    if (!ws_match_swar<CharClass, encoding>(reader.peek_swar()))
+        return;
+
+#if LEXY_USE_SIMD_DISPATCH
+    if constexpr (_detail::is_simd_reader<Reader>)
+    {
+        // Let the kernel that was selected for the CPU consume as much as possible.
+        reader.bump_simd_to(
+            _detail::simd_find_class_end(reader.simd_position(), simd_char_table_of<CharClass>));
+        return;
+    }
+#elif LEXY_HAS_SIMD
+    constexpr auto has_space = CharClass::char_class_ascii().contains[int(' ')];
+    if constexpr (_detail::is_simd_reader<Reader> && (LEXY_HAS_SIMD_SHUFFLE || has_space))
+    {
+        // Skip full registers, then bump to the first char that isn't whitespace.
+        while (true)
+        {
+#    if LEXY_HAS_SIMD_SHUFFLE
+            auto mismatch = _detail::simd_table_mismatch_mask(reader.peek_simd(),
+                                                              simd_char_table_of<CharClass>);
+#    else
+            // Without a shuffle, we can only skip spaces.
+            auto mismatch = _detail::simd_eq_mask(reader.peek_simd(), _detail::simd_fill(' '))
+                            ^ _detail::simd_full_mask;
+#    endif
+            if (mismatch == 0)
+            {
+                reader.bump_simd();
+            }
+            else
+            {
+                reader.bump_simd(_detail::simd_find_first_set(mismatch));
+                return;
+            }
+        }
+    }
+#endif
+
+    do
+        reader.bump_swar();
+    while (ws_match_swar<CharClass, encoding>(reader.peek_swar()));
 }
 
 template <typename WhitespaceRule, typename Handler, typename Reader>
 constexpr auto skip_whitespace(ws_handler<Handler>&& handler, Reader& reader)
 {
-    auto begin = reader.position();
+    using char_class = ws_char_class<WhitespaceRule, typename Reader::encoding>;
+    auto begin       = reader.position();
 
     if constexpr (lexy::is_token_rule<WhitespaceRule>)
     {
         // Parsing a token repeatedly cannot fail, so we can optimize it.
 
-        if constexpr (_detail::is_swar_reader<Reader> //
-                      && space_is_definitely_whitespace<WhitespaceRule>())
+        if constexpr (_detail::is_swar_reader<Reader> && !std::is_void_v<char_class>)
         {
             while (true)
             {
-                // Skip as many spaces as possible.
-                using char_type = typename Reader::encoding::char_type;
-                while (reader.peek_swar() == _detail::swar_fill(char_type(' ')))
-                    reader.bump_swar();
+                // Skip as many characters as possible.
+                ws_skip_char_class<char_class>(reader);
 
-                // We no longer have a space, skip the entire whitespace rule once.
+                // We can no longer skip, match the entire whitespace rule once.
                 if (!lexy::try_match_token(WhitespaceRule{}, reader))
                     // If that fails, we definitely have no more whitespace.
                     break;
@@ -145,6 +265,30 @@ constexpr auto skip_whitespace(ws_handler<Handler>&& handler, Reader& reader)
                         reader.position());
         return std::true_type{};
     }
+    else if constexpr (_detail::is_swar_reader<Reader> && !std::is_void_v<char_class>)
+    {
+        // The whitespace rule is a choice that contains a char class, e.g. spaces or comments.
+        // We skip runs of the char class at once and parse the entire rule only once they end.
+        using production = ws_once_production<WhitespaceRule>;
+
+        auto result = true;
+        while (true)
+        {
+            ws_skip_char_class<char_class>(reader);
+
+            auto                pos          = reader.position();
+            ws_handler<Handler> once_handler = handler;
+            result = lexy::do_action<production, ws_result>(LEXY_MOV(once_handler),
+                                                            lexy::no_parse_state, reader);
+            if (!result || reader.position() == pos)
+                break;
+        }
+
+        handler.real_on(lexy::parse_events::token{},
+                        result ? lexy::whitespace_token_kind : lexy::error_token_kind, begin,
+                        reader.position());
+        return result;
+    }
     else if constexpr (!std::is_void_v<WhitespaceRule>)
     {
         using production = ws_production<WhitespaceRule>;
@@ -302,6 +446,12 @@ struct _wsn : _copy_base<Rule>
             }
         }
     };
+
+    template <typename Encoding>
+    static LEXY_CONSTEVAL auto branch_first_set()
+    {
+        return lexy::_detail::first_set_of<Rule, Encoding>();
+    }
 };
 
 /// Disables automatic skipping of whitespace for all tokens of the given rule.
@@ -0,0 +1,1180 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_GRAMMAR_ANALYSIS_HPP_INCLUDED
+#define LEXY_GRAMMAR_ANALYSIS_HPP_INCLUDED
+
+#include <lexy/_detail/config.hpp>
+#include <lexy/_detail/detect.hpp>
+#include <lexy/_detail/integer_sequence.hpp>
+#include <lexy/dsl.hpp>
+#include <lexy/encoding.hpp>
+#include <lexy/grammar.hpp>
+
+//=== public types ===//
+namespace lexy
+{
+/// The set of code units a rule can start with or that can follow a production.
+using grammar_char_set = _detail::first_set;
+
+struct grammar_production_info
+{
+    const char*      name;
+    grammar_char_set first;
+    bool             nullable;
+    grammar_char_set follow;
+};
+
+enum class grammar_hazard_kind
+{
+    /// Two branches of a choice can start with the same code unit.
+    choice_overlap,
+    /// A branch of a choice can never be taken, as an earlier branch always matches first.
+    choice_shadowed,
+    /// The first set of a branch is unknown, so all later branches are tried after it failed.
+    choice_unknown,
+    /// The branch of an optional rule can start with a code unit that can also follow it.
+    optional_overlap,
+    /// The branch of a loop or list can start with a code unit that can also follow it.
+    loop_overlap,
+};
+
+struct grammar_hazard
+{
+    static constexpr auto npos = std::size_t(-1);
+
+    grammar_hazard_kind kind;
+    /// The index of the production that contains the decision.
+    std::size_t production;
+    /// The index of the choice, optional, or loop among all of them in the production, in rule
+    /// order.
+    std::size_t decision;
+
+    /// For choices: the later branch and the earlier branch that is tried before it (if any).
+    std::size_t branch, other_branch;
+    /// The production name or the literal of the branches, if they have one.
+    const char* branch_name;
+    const char* other_branch_name;
+
+    /// The code units both can start with.
+    grammar_char_set overlap;
+    /// How many code units are read before the earlier branch can fail, or `npos` if there is no
+    /// bound.
+    std::size_t lookahead;
+};
+} // namespace lexy
+
+//=== shapes ===//
+namespace lexy::_detail
+{
+// The analysis doesn't look at the rules themselves, but at one of the following shapes.
+// Their arguments are rules or other shapes.
+template <typename... R>
+struct ga_seq // R in order
+{};
+template <bool Ordered, typename... R>
+struct ga_alt // one of R, Ordered if they're tried in order like `dsl::operator|`
+{};
+template <typename R, bool Decides = true>
+struct ga_opt // R or nothing, decided by the branch condition of R
+{};
+template <typename R, bool Decides = true>
+struct ga_loop // R zero or more times, decided by the branch condition of R
+{};
+template <typename Item, typename Sep = void, bool Decides = true>
+struct ga_list // Item one or more times, separated by Sep unless it is void, decided by Sep
+{};
+template <typename Production>
+struct ga_prod
+{};
+template <typename R>
+struct ga_look // R is matched, but not consumed
+{};
+template <typename Rule>
+struct ga_leaf // a rule that doesn't contain other rules, e.g. a token
+{};
+struct ga_empty // a rule that doesn't consume anything
+{};
+struct ga_opaque // a rule that can match anything
+{};
+
+template <typename Expr, typename RootOperation>
+struct ga_expr_operation
+{
+    using operation = RootOperation;
+};
+template <typename Expr>
+struct ga_expr_operation<Expr, void>
+{
+    using operation = typename Expr::operation;
+};
+
+// An operand of an expression: prefix operators followed by the atom.
+template <typename Expr, typename... PreOps>
+using ga_expr_operand = ga_seq<ga_loop<ga_alt<false, LEXY_DECAY_DECLTYPE(PreOps::op)...>>,
+                               LEXY_DECAY_DECLTYPE(Expr::atom)>;
+template <typename Expr, typename Operand, typename Op>
+using ga_expr_post_op = std::conditional_t<std::is_base_of_v<lexyd::postfix_op, Op>,
+                                           LEXY_DECAY_DECLTYPE(Op::op),
+                                           ga_seq<LEXY_DECAY_DECLTYPE(Op::op), Operand>>;
+template <typename Expr, typename... PreOps, typename... PostOps>
+auto ga_expr(operation_list<PreOps...>, operation_list<PostOps...>)
+    -> ga_seq<ga_expr_operand<Expr, PreOps...>,
+              ga_loop<ga_alt<false, ga_expr_post_op<Expr, ga_expr_operand<Expr, PreOps...>,
+                                                    PostOps>...>>>;
+
+// The shape of each rule is given by the return type of an overload.
+// We use overloads instead of specializations, as some rules inherit from other ones.
+template <typename P, typename... R>
+ga_seq<R...> ga_shape(ga_seq<R...>);
+template <typename P, bool Ordered, typename... R>
+ga_alt<Ordered, R...> ga_shape(ga_alt<Ordered, R...>);
+template <typename P, typename R, bool Decides>
+ga_opt<R, Decides> ga_shape(ga_opt<R, Decides>);
+template <typename P, typename R, bool Decides>
+ga_loop<R, Decides> ga_shape(ga_loop<R, Decides>);
+template <typename P, typename Item, typename Sep, bool Decides>
+ga_list<Item, Sep, Decides> ga_shape(ga_list<Item, Sep, Decides>);
+template <typename P, typename Production>
+ga_prod<Production> ga_shape(ga_prod<Production>);
+template <typename P, typename R>
+ga_look<R> ga_shape(ga_look<R>);
+template <typename P, typename Rule>
+ga_leaf<Rule> ga_shape(ga_leaf<Rule>);
+template <typename P>
+ga_empty ga_shape(ga_empty);
+template <typename P>
+ga_opaque ga_shape(ga_opaque);
+
+template <typename P, typename... R>
+ga_seq<R...> ga_shape(lexyd::_seq<R...>);
+template <typename P, typename Condition, typename... R>
+ga_seq<Condition, R...> ga_shape(lexyd::_br<Condition, R...>);
+template <typename P, typename... R>
+ga_alt<true, R...> ga_shape(lexyd::_chc<R...>);
+
+template <typename P, typename Production>
+ga_prod<Production> ga_shape(lexyd::_prd<Production>);
+template <typename P, typename Production, typename DepthError>
+ga_prod<Production> ga_shape(lexyd::_rec<Production, DepthError>);
+template <typename P, typename Production, typename DepthError>
+ga_prod<Production> ga_shape(lexyd::_recb<Production, DepthError>);
+// The rule of a subgrammar is defined in a different file.
+template <typename P, typename Production, typename T>
+ga_opaque ga_shape(lexyd::_subg<Production, T>);
+
+template <typename P, typename Branch>
+ga_opt<Branch> ga_shape(lexyd::_opt<Branch>);
+template <typename P, typename Branch>
+ga_opt<Branch> ga_shape(lexyd::_if<Branch>);
+template <typename P, typename Rule, auto If, auto Else>
+ga_opt<Rule> ga_shape(lexyd::_flag<Rule, If, Else>);
+template <typename P, typename Term, typename Rule>
+ga_alt<false, Term, Rule> ga_shape(lexyd::_optt<Term, Rule>);
+
+template <typename P, typename Rule>
+ga_loop<Rule, false> ga_shape(lexyd::_loop<Rule>); // stopped by `dsl::break_`
+template <typename P, typename Branch>
+ga_loop<Branch> ga_shape(lexyd::_whl<Branch>);
+template <typename P, typename FlagRule, auto Default, typename DuplicateError>
+ga_loop<FlagRule> ga_shape(lexyd::_flags<FlagRule, Default, DuplicateError>);
+template <typename P, typename DuplicateError, typename ElseRule, typename... R>
+ga_loop<ga_alt<false, R...>> ga_shape(lexyd::_comb<DuplicateError, ElseRule, R...>);
+template <typename P, std::size_t N, typename Rule>
+ga_list<Rule, void, false> ga_shape(lexyd::_times<N, Rule, void>);
+template <typename P, std::size_t N, typename Rule, typename Sep>
+ga_list<Rule, typename Sep::rule, false> ga_shape(lexyd::_times<N, Rule, Sep>);
+
+template <typename P, typename Item>
+ga_list<Item> ga_shape(lexyd::_lst<Item, void>);
+template <typename P, typename Item, typename Sep>
+ga_list<Item, typename Sep::rule> ga_shape(lexyd::_lst<Item, Sep>);
+// The list ends when the terminator matches.
+template <typename P, typename Term, typename Item, typename Recover>
+ga_seq<ga_list<Item, void, false>, Term> ga_shape(lexyd::_lstt<Term, Item, void, Recover>);
+template <typename P, typename Term, typename Item, typename Sep, typename Recover>
+ga_seq<ga_list<Item, typename Sep::rule, false>, Term> ga_shape(
+    lexyd::_lstt<Term, Item, Sep, Recover>);
+
+// The closing delimiter is checked before the content, so they can overlap.
+template <typename P, typename Close, typename Char, typename Limit, typename... Escapes>
+ga_seq<ga_loop<ga_alt<false, Char, Escapes...>, false>, Close> ga_shape(
+    lexyd::_del<Close, Char, Limit, Escapes...>);
+template <typename P, typename Escape, typename... Branches>
+ga_seq<Escape, ga_alt<false, Branches...>> ga_shape(lexyd::_escape<Escape, Branches...>);
+
+template <typename P, typename Rule, typename Tag>
+ga_look<Rule> ga_shape(lexyd::_peek<Rule, Tag>);
+template <typename P, typename Rule, typename Tag>
+ga_empty ga_shape(lexyd::_peekn<Rule, Tag>);
+template <typename P, typename Needle, typename End, typename Tag>
+ga_opaque ga_shape(lexyd::_look<Needle, End, Tag>);
+
+template <typename P, typename RootOperation>
+auto ga_shape(lexyd::_expr<RootOperation>)
+    -> decltype(ga_expr<P>(pre_operation_list_of<ga_expr_operation<P, RootOperation>, 0>{},
+                           post_operation_list_of<ga_expr_operation<P, RootOperation>, 0>{}));
+template <typename P, typename Tag, typename Literal, typename... R>
+ga_seq<Literal, R...> ga_shape(lexyd::_op<Tag, Literal, R...>);
+template <typename P, typename... Ops>
+ga_alt<false, Ops...> ga_shape(lexyd::_opc<Ops...>);
+
+template <typename P, const auto& Table, typename Token, typename Tag>
+ga_seq<Token> ga_shape(lexyd::_sym<Table, Token, Tag>);
+template <typename P, const auto& Table, typename Tag>
+ga_leaf<lexyd::_sym<Table, void, Tag>> ga_shape(lexyd::_sym<Table, void, Tag>);
+
+// Rules that only wrap another rule.
+template <typename P, typename Rule>
+ga_seq<Rule> ga_shape(lexyd::_posr<Rule>);
+template <typename P, typename Rule>
+ga_seq<Rule> ga_shape(lexyd::_capr<Rule>);
+template <typename P, typename Token>
+ga_seq<Token> ga_shape(lexyd::_cap<Token>);
+template <typename P, typename Rule>
+ga_seq<Rule> ga_shape(lexyd::_wsn<Rule>);
+template <typename P, typename Rule>
+ga_loop<Rule, false> ga_shape(lexyd::_wsr<Rule>);
+template <typename P, typename T, typename Rule, bool Front>
+ga_seq<Rule> ga_shape(lexyd::_pas<T, Rule, Front>);
+template <typename P, typename Fn, typename Rule>
+ga_seq<Rule> ga_shape(lexyd::_mem<Fn, Rule>);
+template <typename P, typename Branch, typename Error>
+ga_seq<Branch> ga_shape(lexyd::_must<Branch, Error>);
+template <typename P, typename Id, typename Rule, int Sign>
+ga_seq<Rule> ga_shape(lexyd::_ctx_cpush<Id, Rule, Sign>);
+template <typename P, typename Id, typename Identifier>
+ga_seq<Identifier> ga_shape(lexyd::_ctx_icap<Id, Identifier>);
+template <typename P, typename Id, typename Identifier, typename Tag>
+ga_seq<Identifier> ga_shape(lexyd::_ctx_irem<Id, Identifier, Tag>);
+template <typename P, typename Token, typename IntParser, typename Tag>
+ga_seq<Token> ga_shape(lexyd::_int<Token, IntParser, Tag>);
+template <typename P, typename Terminator, typename Rule, typename Recover>
+ga_seq<Rule> ga_shape(lexyd::_tryt<Terminator, Rule, Recover>);
+template <typename P, typename Rule, typename Recover>
+ga_seq<Rule> ga_shape(lexyd::_tryr<Rule, Recover>);
+template <typename P, auto Kind, typename Token>
+ga_seq<Token> ga_shape(lexyd::_tokk<Kind, Token>);
+template <typename P, typename Tag, typename Token>
+ga_seq<Token> ga_shape(lexyd::_toke<Tag, Token>);
+template <typename P, typename Rule>
+ga_seq<Rule> ga_shape(lexyd::_token<Rule>);
+
+// An error never matches.
+template <typename P, typename Tag, typename Rule>
+ga_alt<false> ga_shape(lexyd::_err<Tag, Rule>);
+
+// Rules that don't consume anything.
+template <typename P>
+ga_empty ga_shape(lexyd::_pos);
+template <typename P, LEXY_NTTP_PARAM Fn>
+ga_empty ga_shape(lexyd::_eff<Fn>);
+template <typename P>
+ga_empty ga_shape(lexyd::_eof);
+template <typename P>
+ga_empty ga_shape(lexyd::_else);
+template <typename P>
+ga_empty ga_shape(lexyd::_break);
+template <typename P>
+ga_empty ga_shape(lexyd::_nullopt);
+template <typename P>
+ga_empty ga_shape(lexyd::_ret);
+template <typename P, typename Id, int InitialValue>
+ga_empty ga_shape(lexyd::_ctx_ccreate<Id, InitialValue>);
+template <typename P, typename Id, int Delta>
+ga_empty ga_shape(lexyd::_ctx_cadd<Id, Delta>);
+template <typename P, typename Id, int Value>
+ga_empty ga_shape(lexyd::_ctx_cis<Id, Value>);
+template <typename P, typename Id>
+ga_empty ga_shape(lexyd::_ctx_cvalue<Id>);
+template <typename P, typename... Ids>
+ga_empty ga_shape(lexyd::_ctx_ceq<Ids...>);
+template <typename P, typename Id, bool InitialValue>
+ga_empty ga_shape(lexyd::_ctx_fcreate<Id, InitialValue>);
+template <typename P, typename Id, bool Value>
+ga_empty ga_shape(lexyd::_ctx_fset<Id, Value>);
+template <typename P, typename Id>
+ga_empty ga_shape(lexyd::_ctx_ftoggle<Id>);
+template <typename P, typename Id, bool Value>
+ga_empty ga_shape(lexyd::_ctx_fis<Id, Value>);
+template <typename P, typename Id>
+ga_empty ga_shape(lexyd::_ctx_fvalue<Id>);
+template <typename P, typename Id>
+ga_empty ga_shape(lexyd::_ctx_icreate<Id>);
+
+template <typename P, typename Rule>
+using _detect_ga_shape = decltype(ga_shape<P>(LEXY_DECLVAL(Rule)));
+
+// Every other rule is a leaf.
+template <typename P, typename Rule>
+using ga_shape_of = type_or<detected_or<void, _detect_ga_shape, P, Rule>, ga_leaf<Rule>>;
+
+// The rule of a production, including the initial whitespace if it defines its own.
+template <typename Production, typename = void>
+struct _ga_production_shape
+{
+    using type = lexy::production_rule<Production>;
+};
+template <typename Production>
+struct _ga_production_shape<Production, decltype(void(Production::whitespace))>
+{
+    using type = ga_seq<ga_loop<LEXY_DECAY_DECLTYPE(Production::whitespace), false>,
+                        lexy::production_rule<Production>>;
+};
+template <typename Production>
+using ga_production_shape = typename _ga_production_shape<Production>::type;
+} // namespace lexy::_detail
+
+//=== branch conditions ===//
+namespace lexy::_detail
+{
+constexpr auto ga_unbounded = grammar_hazard::npos;
+
+constexpr std::size_t ga_add_length(std::size_t lhs, std::size_t rhs)
+{
+    return lhs == ga_unbounded || rhs == ga_unbounded ? ga_unbounded : lhs + rhs;
+}
+constexpr std::size_t ga_max_length(std::size_t lhs, std::size_t rhs)
+{
+    return lhs < rhs ? rhs : lhs;
+}
+
+template <typename Encoding>
+constexpr std::size_t ga_code_point_length()
+{
+    if constexpr (std::is_same_v<Encoding, lexy::utf8_encoding>
+                  || std::is_same_v<Encoding, lexy::utf8_char_encoding>)
+        return 4;
+    else if constexpr (std::is_same_v<Encoding, lexy::utf16_encoding>)
+        return 2;
+    else
+        return 1;
+}
+
+// The maximal number of code units a rule can consume.
+template <typename Encoding, typename Rule>
+struct ga_length
+{
+    static LEXY_CONSTEVAL std::size_t get()
+    {
+        if constexpr (lexy::is_literal_set_rule<Rule>)
+            return ga_length<Encoding, typename Rule::as_lset>::get();
+        else if constexpr (lexy::is_literal_rule<Rule>)
+            return Rule::lit_max_char_count;
+        else if constexpr (lexy::is_char_class_rule<Rule>)
+        {
+            if constexpr (std::is_same_v<decltype(Rule::char_class_match_cp(char32_t())),
+                                         std::false_type>)
+                return 1;
+            else
+                return ga_code_point_length<Encoding>();
+        }
+        else
+            return ga_unbounded;
+    }
+};
+template <typename Encoding, typename... Literals>
+struct ga_length<Encoding, lexyd::_lset<Literals...>>
+{
+    static LEXY_CONSTEVAL std::size_t get()
+    {
+        auto result = std::size_t(0);
+        ((result = ga_max_length(result, ga_length<Encoding, Literals>::get())), ...);
+        return result;
+    }
+};
+template <typename Encoding, typename... R>
+struct ga_length<Encoding, lexyd::_seq<R...>>
+{
+    static LEXY_CONSTEVAL std::size_t get()
+    {
+        auto result = std::size_t(0);
+        ((result = ga_add_length(result, ga_length<Encoding, R>::get())), ...);
+        return result;
+    }
+};
+template <typename Encoding, typename Condition, typename... R>
+struct ga_length<Encoding, lexyd::_br<Condition, R...>>
+: ga_length<Encoding, lexyd::_seq<Condition, R...>>
+{};
+template <typename Encoding, typename... R>
+struct ga_length<Encoding, lexyd::_chc<R...>>
+{
+    static LEXY_CONSTEVAL std::size_t get()
+    {
+        auto result = std::size_t(0);
+        ((result = ga_max_length(result, ga_length<Encoding, R>::get())), ...);
+        return result;
+    }
+};
+
+// The maximal number of code units the branch condition of a rule reads before it fails.
+template <typename Encoding, typename Rule>
+struct ga_condition_length
+{
+    static LEXY_CONSTEVAL std::size_t get()
+    {
+        if constexpr (std::is_same_v<ga_shape_of<void, Rule>, ga_empty>)
+            return 0;
+        else
+            return ga_length<Encoding, Rule>::get();
+    }
+};
+template <typename Encoding, typename Condition, typename... R>
+struct ga_condition_length<Encoding, lexyd::_br<Condition, R...>>
+: ga_condition_length<Encoding, Condition>
+{};
+template <typename Encoding, typename Rule>
+struct ga_condition_length<Encoding, lexyd::_wsn<Rule>> : ga_condition_length<Encoding, Rule>
+{};
+template <typename Encoding, typename Production>
+struct ga_condition_length<Encoding, lexyd::_prd<Production>>
+: ga_condition_length<Encoding, lexy::production_rule<Production>>
+{};
+template <typename Encoding, typename Production, typename DepthError>
+struct ga_condition_length<Encoding, lexyd::_recb<Production, DepthError>>
+: ga_condition_length<Encoding, lexy::production_rule<Production>>
+{};
+template <typename Encoding, typename... R>
+struct ga_condition_length<Encoding, lexyd::_chc<R...>>
+{
+    static LEXY_CONSTEVAL std::size_t get()
+    {
+        auto result = std::size_t(0);
+        ((result = ga_max_length(result, ga_condition_length<Encoding, R>::get())), ...);
+        return result;
+    }
+};
+template <typename Encoding, typename Rule, typename Tag>
+struct ga_condition_length<Encoding, lexyd::_peek<Rule, Tag>> : ga_length<Encoding, Rule>
+{};
+template <typename Encoding, typename Rule, typename Tag>
+struct ga_condition_length<Encoding, lexyd::_peekn<Rule, Tag>> : ga_length<Encoding, Rule>
+{};
+// The shapes of loops and lists: the condition is the one of the first rule.
+template <typename Encoding, typename R, typename... Tail>
+struct ga_condition_length<Encoding, ga_seq<R, Tail...>> : ga_condition_length<Encoding, R>
+{};
+template <typename Encoding, bool Ordered, typename... R>
+struct ga_condition_length<Encoding, ga_alt<Ordered, R...>>
+: ga_condition_length<Encoding, lexyd::_chc<R...>>
+{};
+
+// The literal of a branch condition, if it is one.
+struct ga_no_literal
+{};
+template <typename Rule>
+struct ga_literal
+{
+    using type = ga_no_literal;
+};
+template <typename CharT, CharT... C>
+struct ga_literal<lexyd::_lit<CharT, C...>>
+{
+    using type = lexyd::_lit<CharT, C...>;
+};
+template <typename Condition, typename... R>
+struct ga_literal<lexyd::_br<Condition, R...>> : ga_literal<Condition>
+{};
+template <typename Rule>
+struct ga_literal<lexyd::_wsn<Rule>> : ga_literal<Rule>
+{};
+template <typename Production>
+struct ga_literal<lexyd::_prd<Production>> : ga_literal<lexy::production_rule<Production>>
+{};
+template <typename Production, typename DepthError>
+struct ga_literal<lexyd::_recb<Production, DepthError>>
+: ga_literal<lexy::production_rule<Production>>
+{};
+
+struct ga_literal_prefix
+{
+    // Whether both conditions are literals.
+    bool        literals;
+    std::size_t length;
+    // Whether the first literal is a prefix of the second one.
+    bool is_prefix;
+};
+
+template <typename Lhs, typename Rhs>
+constexpr ga_literal_prefix ga_common_prefix(Lhs, Rhs)
+{
+    return {false, 0, false};
+}
+template <typename CharT, CharT... C, typename CharU, CharU... D>
+constexpr ga_literal_prefix ga_common_prefix(lexyd::_lit<CharT, C...>, lexyd::_lit<CharU, D...>)
+{
+    constexpr CharT lhs[] = {C..., CharT()};
+    constexpr CharU rhs[] = {D..., CharU()};
+
+    auto length = std::size_t(0);
+    while (length != sizeof...(C) && length != sizeof...(D)
+           && char32_t(lhs[length]) == char32_t(rhs[length]))
+        ++length;
+    return {true, length, length == sizeof...(C)};
+}
+
+template <typename Lhs, typename... R>
+struct ga_common_prefix_row
+{
+    static constexpr ga_literal_prefix value[] = {
+        ga_common_prefix(typename ga_literal<Lhs>::type{}, typename ga_literal<R>::type{})...};
+};
+
+// A name for the branch to put in a report: the production or the literal.
+template <typename Literal>
+struct ga_literal_name
+{
+    static constexpr const char* value = nullptr;
+};
+template <char... C>
+struct ga_literal_name<lexyd::_lit<char, C...>>
+{
+    static constexpr char str[] = {C..., '\0'};
+    static constexpr const char* value = str;
+};
+
+template <typename Production>
+constexpr const char* ga_branch_name(lexyd::_prd<Production>)
+{
+    return lexy::production_name<Production>();
+}
+template <typename Production, typename DepthError>
+constexpr const char* ga_branch_name(lexyd::_recb<Production, DepthError>)
+{
+    return lexy::production_name<Production>();
+}
+template <typename Rule>
+constexpr const char* ga_branch_name(Rule)
+{
+    return ga_literal_name<typename ga_literal<Rule>::type>::value;
+}
+} // namespace lexy::_detail
+
+//=== analysis ===//
+namespace lexy::_detail
+{
+struct ga_info
+{
+    first_set first;
+    bool      nullable;
+};
+
+constexpr bool ga_merge(first_set& dst, const first_set& src)
+{
+    auto changed = false;
+    if (dst.known && !src.known)
+    {
+        dst.known = false;
+        changed   = true;
+    }
+    for (auto i = 0; i != 256; ++i)
+        if (src.contains[i] && !dst.contains[i])
+        {
+            dst.contains[i] = true;
+            changed         = true;
+        }
+    return changed;
+}
+constexpr bool ga_merge(ga_info& dst, const ga_info& src)
+{
+    auto changed = ga_merge(dst.first, src.first);
+    if (!dst.nullable && src.nullable)
+    {
+        dst.nullable = true;
+        changed      = true;
+    }
+    return changed;
+}
+
+// The overlap of two sets, if both are known.
+constexpr bool ga_intersect(first_set& result, const first_set& lhs, const first_set& rhs)
+{
+    if (!lhs.known || !rhs.known)
+        return false;
+
+    auto any = false;
+    for (auto i = 0; i != 256; ++i)
+        if (lhs.contains[i] && rhs.contains[i])
+        {
+            result.contains[i] = true;
+            any                = true;
+        }
+    return any;
+}
+
+// Ctx provides the encoding and the index of each production;
+// the first sets of the productions computed so far are passed to each function.
+//
+// Visitors are informed about each production that is referenced together with its follow set,
+// and about every hazard.
+template <typename P, typename Shape>
+struct ga_impl;
+
+template <typename P, typename Rule>
+using ga_node = ga_impl<P, ga_shape_of<P, Rule>>;
+
+template <typename P, typename... R>
+struct ga_impl<P, ga_seq<R...>>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info* productions)
+    {
+        ga_info result{first_set(), true};
+        ((result.nullable ? (result.nullable = false,
+                             ga_merge(result, ga_node<P, R>::template info<Ctx>(productions)))
+                          : false),
+         ...);
+        return result;
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor& visitor, const ga_info* productions,
+                                const first_set& follow)
+    {
+        constexpr auto size = sizeof...(R);
+        ga_info        infos[] = {ga_node<P, R>::template info<Ctx>(productions)..., ga_info{}};
+
+        // follows[i] is what follows R_(i-1).
+        first_set follows[size + 1];
+        follows[size] = follow;
+        for (auto i = size; i > 0; --i)
+        {
+            follows[i - 1] = infos[i - 1].first;
+            if (infos[i - 1].nullable)
+                follows[i - 1].insert(follows[i]);
+        }
+
+        auto idx = std::size_t(0);
+        (ga_node<P, R>::template visit<Ctx>(visitor, productions, follows[++idx]), ...);
+    }
+};
+
+template <typename P, bool Ordered, typename... R>
+struct ga_impl<P, ga_alt<Ordered, R...>>
+{
+    template <typename Ctx>
+    static constexpr ga_info info([[maybe_unused]] const ga_info* productions)
+    {
+        ga_info result{first_set(), false};
+        (ga_merge(result, ga_node<P, R>::template info<Ctx>(productions)), ...);
+        return result;
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit([[maybe_unused]] Visitor&       visitor,
+                                [[maybe_unused]] const ga_info* productions,
+                                [[maybe_unused]] const first_set& follow)
+    {
+        if constexpr (Ordered)
+            _check<Ctx>(visitor, productions);
+        (ga_node<P, R>::template visit<Ctx>(visitor, productions, follow), ...);
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void _check(Visitor& visitor, const ga_info* productions)
+    {
+        using encoding = typename Ctx::encoding;
+
+        constexpr auto         size            = sizeof...(R);
+        constexpr bool         unconditional[] = {lexy::is_unconditional_branch_rule<R>...};
+        constexpr const char*  names[]         = {ga_branch_name(R{})...};
+        constexpr std::size_t  lookahead[]     = {ga_condition_length<encoding, R>::get()...};
+        constexpr const ga_literal_prefix* prefixes[]
+            = {ga_common_prefix_row<R, R...>::value...};
+        ga_info infos[] = {ga_node<P, R>::template info<Ctx>(productions)...};
+
+        auto decision = visitor.decision();
+        auto hazard   = [&](grammar_hazard_kind kind, std::size_t branch, std::size_t other) {
+            grammar_hazard result{};
+            result.kind              = kind;
+            result.decision          = decision;
+            result.branch            = branch;
+            result.other_branch      = other;
+            result.branch_name       = names[branch];
+            result.other_branch_name = other == grammar_hazard::npos ? nullptr : names[other];
+            result.lookahead = other == grammar_hazard::npos ? lookahead[branch] : lookahead[other];
+            return result;
+        };
+
+        for (auto j = std::size_t(0); j != size; ++j)
+        {
+            if (unconditional[j])
+                // It is the fallback if all previous branches fail.
+                continue;
+
+            for (auto i = std::size_t(0); i != j; ++i)
+            {
+                if (unconditional[i])
+                {
+                    auto h    = hazard(grammar_hazard_kind::choice_shadowed, j, i);
+                    h.overlap = infos[j].first;
+                    visitor.hazard(h);
+                    break;
+                }
+
+                auto h = hazard(grammar_hazard_kind::choice_overlap, j, i);
+                if (!ga_intersect(h.overlap, infos[i].first, infos[j].first))
+                    continue;
+
+                const auto& prefix = prefixes[i][j];
+                if (prefix.literals && prefix.is_prefix)
+                    h.kind = grammar_hazard_kind::choice_shadowed;
+                else if (prefix.literals)
+                    h.lookahead = prefix.length + 1;
+                visitor.hazard(h);
+            }
+
+            if (!infos[j].first.known && _has_later_conditional(unconditional, j))
+                visitor.hazard(hazard(grammar_hazard_kind::choice_unknown, j,
+                                      grammar_hazard::npos));
+        }
+    }
+
+    static constexpr bool _has_later_conditional(const bool* unconditional, std::size_t j)
+    {
+        for (auto i = j + 1; i != sizeof...(R); ++i)
+            if (!unconditional[i])
+                return true;
+        return false;
+    }
+};
+
+template <typename P, typename R, bool Decides>
+struct ga_impl<P, ga_opt<R, Decides>>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info* productions)
+    {
+        auto result     = ga_node<P, R>::template info<Ctx>(productions);
+        result.nullable = true;
+        return result;
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor& visitor, const ga_info* productions,
+                                const first_set& follow)
+    {
+        if constexpr (Decides)
+        {
+            auto decision = visitor.decision();
+
+            grammar_hazard h{};
+            h.kind         = grammar_hazard_kind::optional_overlap;
+            h.decision     = decision;
+            h.branch       = grammar_hazard::npos;
+            h.other_branch = grammar_hazard::npos;
+            h.lookahead    = ga_condition_length<typename Ctx::encoding, R>::get();
+            if (ga_intersect(h.overlap, info<Ctx>(productions).first, follow))
+                visitor.hazard(h);
+        }
+
+        ga_node<P, R>::template visit<Ctx>(visitor, productions, follow);
+    }
+};
+
+template <typename P, typename R, bool Decides>
+struct ga_impl<P, ga_loop<R, Decides>>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info* productions)
+    {
+        auto result     = ga_node<P, R>::template info<Ctx>(productions);
+        result.nullable = true;
+        return result;
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor& visitor, const ga_info* productions,
+                                const first_set& follow)
+    {
+        auto first = info<Ctx>(productions).first;
+        if constexpr (Decides)
+        {
+            auto decision = visitor.decision();
+
+            grammar_hazard h{};
+            h.kind         = grammar_hazard_kind::loop_overlap;
+            h.decision     = decision;
+            h.branch       = grammar_hazard::npos;
+            h.other_branch = grammar_hazard::npos;
+            h.lookahead    = ga_condition_length<typename Ctx::encoding, R>::get();
+            if (ga_intersect(h.overlap, first, follow))
+                visitor.hazard(h);
+        }
+
+        // R can be followed by another iteration.
+        first.insert(follow);
+        ga_node<P, R>::template visit<Ctx>(visitor, productions, first);
+    }
+};
+
+template <typename P, typename Item, typename Sep, bool Decides>
+struct ga_impl<P, ga_list<Item, Sep, Decides>>
+{
+    // What is parsed after each item, if the list continues.
+    using _next = std::conditional_t<std::is_void_v<Sep>, Item, ga_seq<Sep, Item>>;
+
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info* productions)
+    {
+        return ga_node<P, Item>::template info<Ctx>(productions);
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor& visitor, const ga_info* productions,
+                                const first_set& follow)
+    {
+        auto next = ga_node<P, _next>::template info<Ctx>(productions).first;
+        if constexpr (Decides)
+        {
+            auto decision = visitor.decision();
+
+            grammar_hazard h{};
+            h.kind         = grammar_hazard_kind::loop_overlap;
+            h.decision     = decision;
+            h.branch       = grammar_hazard::npos;
+            h.other_branch = grammar_hazard::npos;
+            h.lookahead    = ga_condition_length<typename Ctx::encoding, _next>::get();
+            if (ga_intersect(h.overlap, next, follow))
+                visitor.hazard(h);
+        }
+
+        // An item can be followed by the next one, or by whatever follows the list.
+        next.insert(follow);
+        ga_node<P, Item>::template visit<Ctx>(visitor, productions, next);
+        if constexpr (!std::is_void_v<Sep>)
+        {
+            auto item = ga_node<P, Item>::template info<Ctx>(productions);
+            if (item.nullable)
+                item.first.insert(next);
+            ga_node<P, Sep>::template visit<Ctx>(visitor, productions, item.first);
+        }
+    }
+};
+
+template <typename P, typename Production>
+struct ga_impl<P, ga_prod<Production>>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info* productions)
+    {
+        return productions[Ctx::template index<Production>()];
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor& visitor, const ga_info*, const first_set& follow)
+    {
+        visitor.production(Ctx::template index<Production>(), follow);
+    }
+};
+
+template <typename P, typename R>
+struct ga_impl<P, ga_look<R>>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info* productions)
+    {
+        // We only know that the input has to start with R, not what is consumed afterwards.
+        return ga_node<P, R>::template info<Ctx>(productions);
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor& visitor, const ga_info* productions, const first_set&)
+    {
+        ga_node<P, R>::template visit<Ctx>(visitor, productions, first_set::unknown());
+    }
+};
+
+template <typename P, typename Rule>
+struct ga_impl<P, ga_leaf<Rule>>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info*)
+    {
+        return {first_set_of<Rule, typename Ctx::encoding>(),
+                lexy::is_unconditional_branch_rule<Rule>};
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor&, const ga_info*, const first_set&)
+    {}
+};
+
+template <typename P>
+struct ga_impl<P, ga_empty>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info*)
+    {
+        return {first_set(), true};
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor&, const ga_info*, const first_set&)
+    {}
+};
+
+template <typename P>
+struct ga_impl<P, ga_opaque>
+{
+    template <typename Ctx>
+    static constexpr ga_info info(const ga_info*)
+    {
+        return {first_set::unknown(), false};
+    }
+
+    template <typename Ctx, typename Visitor>
+    static constexpr void visit(Visitor&, const ga_info*, const first_set&)
+    {}
+};
+} // namespace lexy::_detail
+
+//=== production collection ===//
+namespace lexy::_detail
+{
+template <typename... Productions>
+struct ga_productions
+{
+    static constexpr auto size = sizeof...(Productions);
+
+    template <typename P>
+    static constexpr bool contains = (std::is_same_v<P, Productions> || ...);
+
+    template <typename P>
+    static constexpr std::size_t index()
+    {
+        constexpr bool same[] = {std::is_same_v<P, Productions>..., true};
+        auto           result = std::size_t(0);
+        while (!same[result])
+            ++result;
+        return result;
+    }
+};
+
+// Adds all productions reachable from the shape to the list.
+template <typename List, typename P, typename Shape>
+struct ga_collect
+{
+    using type = List;
+};
+template <typename List, typename P, typename... R>
+struct ga_collect_all;
+template <typename List, typename P>
+struct ga_collect_all<List, P>
+{
+    using type = List;
+};
+template <typename List, typename P, typename Head, typename... Tail>
+struct ga_collect_all<List, P, Head, Tail...>
+: ga_collect_all<typename ga_collect<List, P, ga_shape_of<P, Head>>::type, P, Tail...>
+{};
+
+template <typename List, typename P, typename... R>
+struct ga_collect<List, P, ga_seq<R...>> : ga_collect_all<List, P, R...>
+{};
+template <typename List, typename P, bool Ordered, typename... R>
+struct ga_collect<List, P, ga_alt<Ordered, R...>> : ga_collect_all<List, P, R...>
+{};
+template <typename List, typename P, typename R, bool Decides>
+struct ga_collect<List, P, ga_opt<R, Decides>> : ga_collect_all<List, P, R>
+{};
+template <typename List, typename P, typename R, bool Decides>
+struct ga_collect<List, P, ga_loop<R, Decides>> : ga_collect_all<List, P, R>
+{};
+template <typename List, typename P, typename Item, bool Decides>
+struct ga_collect<List, P, ga_list<Item, void, Decides>> : ga_collect_all<List, P, Item>
+{};
+template <typename List, typename P, typename Item, typename Sep, bool Decides>
+struct ga_collect<List, P, ga_list<Item, Sep, Decides>> : ga_collect_all<List, P, Item, Sep>
+{};
+template <typename List, typename P, typename R>
+struct ga_collect<List, P, ga_look<R>> : ga_collect_all<List, P, R>
+{};
+
+template <typename List, typename Production>
+struct ga_collect_production;
+template <typename... Productions, typename Production>
+struct ga_collect_production<ga_productions<Productions...>, Production>
+: ga_collect_all<ga_productions<Productions..., Production>, Production,
+                 ga_production_shape<Production>>
+{};
+
+template <typename List, typename P, typename Production>
+struct ga_collect<List, P, ga_prod<Production>>
+: std::conditional_t<List::template contains<Production>, ga_collect_all<List, P>,
+                     ga_collect_production<List, Production>>
+{};
+
+template <typename Encoding, typename List>
+struct ga_context
+{
+    using encoding = Encoding;
+
+    template <typename Production>
+    static constexpr std::size_t index()
+    {
+        return List::template index<Production>();
+    }
+};
+
+template <std::size_t N>
+struct ga_table
+{
+    ga_info   info[N];
+    first_set follow[N];
+};
+
+// Informs a production about what follows it.
+struct ga_follow_visitor
+{
+    first_set* follow;
+    bool       changed;
+
+    constexpr std::size_t decision()
+    {
+        return 0;
+    }
+    constexpr void production(std::size_t idx, const first_set& set)
+    {
+        changed |= ga_merge(follow[idx], set);
+    }
+    constexpr void hazard(const grammar_hazard&) {}
+};
+
+template <typename Ctx, typename... Productions>
+LEXY_CONSTEVAL auto ga_compute(ga_productions<Productions...>)
+{
+    ga_table<sizeof...(Productions)> result{};
+
+    // Both are computed as a fixpoint: we start with empty sets, and add code units until
+    // nothing changes anymore.
+    for (auto changed = true; changed;)
+    {
+        changed  = false;
+        auto idx = std::size_t(0);
+        ((changed |= ga_merge(result.info[idx],
+                              ga_node<Productions, ga_production_shape<Productions>>::
+                                  template info<Ctx>(result.info)),
+          ++idx),
+         ...);
+    }
+
+    for (ga_follow_visitor visitor{result.follow, true}; visitor.changed;)
+    {
+        visitor.changed = false;
+        auto idx        = std::size_t(0);
+        ((ga_node<Productions, ga_production_shape<Productions>>::template visit<Ctx>(
+              visitor, result.info, first_set(result.follow[idx])),
+          ++idx),
+         ...);
+    }
+
+    return result;
+}
+
+// Collects the hazards; if Capacity is zero, it only counts them.
+template <std::size_t Capacity>
+struct ga_hazard_visitor
+{
+    grammar_hazard hazards[Capacity == 0 ? 1 : Capacity];
+    std::size_t    count;
+    std::size_t    cur_production;
+    std::size_t    decisions;
+
+    constexpr std::size_t decision()
+    {
+        return decisions++;
+    }
+    constexpr void production(std::size_t, const first_set&) {}
+    constexpr void hazard(grammar_hazard h)
+    {
+        if constexpr (Capacity > 0)
+        {
+            h.production   = cur_production;
+            hazards[count] = h;
+        }
+        ++count;
+    }
+};
+
+template <typename Ctx, std::size_t Capacity, std::size_t N, typename... Productions>
+LEXY_CONSTEVAL auto ga_hazards(const ga_table<N>& table, ga_productions<Productions...>)
+{
+    ga_hazard_visitor<Capacity> visitor{};
+    auto                        idx = std::size_t(0);
+    ((visitor.cur_production = idx, visitor.decisions = 0,
+      ga_node<Productions, ga_production_shape<Productions>>::template visit<Ctx>(
+          visitor, table.info, first_set(table.follow[idx])),
+      ++idx),
+     ...);
+    return visitor;
+}
+} // namespace lexy::_detail
+
+namespace lexy
+{
+/// Computes the first and follow sets of all productions reachable from `Production`,
+/// and the decisions where a branch can't be selected by looking at the next code unit.
+template <typename Production, typename Encoding = lexy::default_encoding>
+class grammar_analysis
+{
+    using _productions = typename _detail::ga_collect<_detail::ga_productions<>, void,
+                                                      _detail::ga_prod<Production>>::type;
+    using _ctx         = _detail::ga_context<Encoding, _productions>;
+
+    static constexpr auto _table = _detail::ga_compute<_ctx>(_productions{});
+    static constexpr auto _hazard_count
+        = _detail::ga_hazards<_ctx, 0>(_table, _productions{}).count;
+    static constexpr auto _hazards
+        = _detail::ga_hazards<_ctx, _hazard_count>(_table, _productions{});
+
+    template <std::size_t... Idx, typename... Productions>
+    static LEXY_CONSTEVAL auto _make_infos(_detail::index_sequence<Idx...>,
+                                           _detail::ga_productions<Productions...>)
+    {
+        struct result_t
+        {
+            grammar_production_info value[sizeof...(Productions)];
+        };
+        return result_t{{{lexy::production_name<Productions>(), _table.info[Idx].first,
+                          _table.info[Idx].nullable, _table.follow[Idx]}...}};
+    }
+    static constexpr auto _infos
+        = _make_infos(_detail::make_index_sequence<_productions::size>{}, _productions{});
+
+public:
+    //=== productions ===//
+    /// The number of productions reachable from `Production`, including itself.
+    static constexpr std::size_t production_count = _productions::size;
+
+    /// The index of a reachable production; `Production` has index zero.
+    template <typename P>
+    static constexpr std::size_t production_index()
+    {
+        static_assert(_productions::template contains<P>, "production is not reachable");
+        return _productions::template index<P>();
+    }
+
+    static constexpr const grammar_production_info& production(std::size_t idx)
+    {
+        return _infos.value[idx];
+    }
+    template <typename P>
+    static constexpr const grammar_production_info& production()
+    {
+        return production(production_index<P>());
+    }
+
+    //=== hazards ===//
+    static constexpr std::size_t hazard_count = _hazard_count;
+
+    static constexpr const grammar_hazard& hazard(std::size_t idx)
+    {
+        return _hazards.hazards[idx];
+    }
+};
+} // namespace lexy
+
+#endif // LEXY_GRAMMAR_ANALYSIS_HPP_INCLUDED
+
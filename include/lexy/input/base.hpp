@@ -6,13 +6,28 @@
 
 #include <lexy/_detail/config.hpp>
 #include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/swar.hpp>
 #include <lexy/encoding.hpp>
 
 namespace lexy
 {
+// Whether the range reader can use SWAR:
+// it needs contiguous memory and an EOF value that fits into a char.
+// We also need to detect constant evaluation, as the fast path isn't constexpr.
+template <typename Encoding, typename Iterator, typename Sentinel>
+constexpr bool _rr_has_swar
+    = LEXY_HAS_IS_CONSTANT_EVALUATED                                   //
+      && std::is_same_v<Iterator, const typename Encoding::char_type*> //
+      && std::is_same_v<Sentinel, Iterator>                            //
+      && std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
+
+struct _rr_base
+{};
+
 // A generic reader from an iterator range.
 template <typename Encoding, typename Iterator, typename Sentinel = Iterator>
-class _rr
+class _rr : public std::conditional_t<_rr_has_swar<Encoding, Iterator, Sentinel>,
+                                      _detail::_swar_base, _rr_base>
 {
 public:
     using encoding = Encoding;
@@ -62,6 +77,39 @@ public:
         _cur = m._it;
     }
 
+    //=== SWAR ===//
+    // Only used if `_rr_has_swar` is true.
+    constexpr _detail::swar_int peek_swar() const noexcept
+    {
+        using char_type       = typename encoding::char_type;
+        constexpr auto length = _detail::swar_length<char_type>;
+
+        auto remaining = std::size_t(_end - _cur);
+        if (remaining >= length && !LEXY_IS_CONSTANT_EVALUATED())
+            return _detail::swar_load(_cur);
+
+        // We must not read past the end, so we gather the remaining characters
+        // and fill the rest with EOF, just like the padding of a buffer.
+        auto result = _detail::swar_int(0);
+        for (auto i = std::size_t(0); i != length; ++i)
+        {
+            auto c = i < remaining ? _cur[i] : char_type(encoding::eof());
+            result |= _detail::swar_int(_detail::make_uchar(c))
+                      << (i * _detail::char_bit_size<char_type>);
+        }
+        return result;
+    }
+
+    constexpr void bump_swar() noexcept
+    {
+        bump_swar(_detail::swar_length<typename encoding::char_type>);
+    }
+    constexpr void bump_swar(std::size_t char_count) noexcept
+    {
+        LEXY_PRECONDITION(std::size_t(_end - _cur) >= char_count);
+        _cur += char_count;
+    }
+
 private:
     Iterator                   _cur;
     LEXY_EMPTY_MEMBER Sentinel _end;
@@ -6,7 +6,10 @@
 
 #include <cstring>
 #include <lexy/_detail/memory_resource.hpp>
+#include <lexy/_detail/simd.hpp>
 #include <lexy/_detail/swar.hpp>
+#include <lexy/_detail/transcode.hpp>
+#include <lexy/_detail/validate_utf8.hpp>
 #include <lexy/error.hpp>
 #include <lexy/input/base.hpp>
 #include <lexy/lexeme.hpp>
@@ -14,8 +17,11 @@
 namespace lexy
 {
 // The reader used by the buffer if it can use a sentinel.
+// Inputs using it need to provide enough padding for SWAR and SIMD after the sentinel.
 template <typename Encoding>
-class _br : public _detail::swar_reader_base<_br<Encoding>>
+class _br : public _detail::swar_reader_base<_br<Encoding>>,
+            public _detail::simd_reader_base<_br<Encoding>,
+                                             sizeof(typename Encoding::char_type) == 1>
 {
 public:
     using encoding = Encoding;
@@ -84,6 +90,126 @@ constexpr auto _buffer_reader(const typename Encoding::char_type* data)
     else
         return _br<Encoding>(data);
 }
+
+// The buffer reader used by `lexy::parse_ascii_dispatch()` if the UTF-8 input is ASCII.
+template <typename Encoding>
+class _ascii_br : public _br<Encoding>, public _detail::ascii_only_reader_base
+{
+public:
+    explicit _ascii_br(typename _br<Encoding>::iterator begin) noexcept
+    : _br<Encoding>(begin)
+    {}
+};
+
+LEXY_INSTANTIATION_NEWTYPE(_ascii_br8, _ascii_br, lexy::utf8_encoding);
+LEXY_INSTANTIATION_NEWTYPE(_ascii_brc, _ascii_br, lexy::utf8_char_encoding);
+
+// Returns a reader at the same position that assumes the rest of the input is ASCII.
+inline auto _ascii_reader(const _br8& reader)
+{
+    return _ascii_br8(reader.position());
+}
+inline auto _ascii_reader(const _brc& reader)
+{
+    return _ascii_brc(reader.position());
+}
+
+// The buffer reader used by `lexy::parse_validated_utf8()` if the input is well-formed UTF-8.
+template <typename Encoding>
+class _utf8_br : public _br<Encoding>, public _detail::utf8_validated_reader_base
+{
+public:
+    explicit _utf8_br(typename _br<Encoding>::iterator begin) noexcept : _br<Encoding>(begin) {}
+};
+
+LEXY_INSTANTIATION_NEWTYPE(_utf8_br8, _utf8_br, lexy::utf8_encoding);
+LEXY_INSTANTIATION_NEWTYPE(_utf8_brc, _utf8_br, lexy::utf8_char_encoding);
+
+// Returns a reader at the same position that assumes the rest of the input is well-formed UTF-8.
+inline auto _utf8_validated_reader(const _br8& reader)
+{
+    return _utf8_br8(reader.position());
+}
+inline auto _utf8_validated_reader(const _brc& reader)
+{
+    return _utf8_brc(reader.position());
+}
+
+// The reader used by the buffer if it can't use a sentinel, but still has padding.
+// As any char can be valid input, it needs to check for EOF in `peek()`.
+// However, it can always read an entire SWAR: the padding is filled with the char value of EOF,
+// so SWAR loops can detect that they might have reached EOF.
+template <typename Encoding>
+class _bpr : public _detail::swar_reader_base<_bpr<Encoding>>
+{
+public:
+    using encoding = Encoding;
+    using iterator = const typename Encoding::char_type*;
+
+    struct marker
+    {
+        iterator _it;
+
+        constexpr iterator position() const noexcept
+        {
+            return _it;
+        }
+    };
+
+    explicit _bpr(iterator begin, iterator end) noexcept : _cur(begin), _end(end) {}
+
+    auto peek() const noexcept
+    {
+        if (_cur == _end)
+            return encoding::eof();
+        else
+            return encoding::to_int_type(*_cur);
+    }
+
+    void bump() noexcept
+    {
+        LEXY_PRECONDITION(_cur != _end);
+        ++_cur;
+    }
+
+    iterator position() const noexcept
+    {
+        return _cur;
+    }
+
+    marker current() const noexcept
+    {
+        return {_cur};
+    }
+    void reset(marker m) noexcept
+    {
+        LEXY_PRECONDITION(m._it <= _end);
+        _cur = m._it;
+    }
+
+private:
+    iterator _cur;
+    iterator _end;
+};
+
+LEXY_INSTANTIATION_NEWTYPE(_bprd, _bpr, lexy::default_encoding);
+LEXY_INSTANTIATION_NEWTYPE(_bprb, _bpr, lexy::byte_encoding);
+LEXY_INSTANTIATION_NEWTYPE(_bpr16, _bpr, lexy::utf16_encoding);
+
+// Create the appropriate padded buffer reader.
+template <typename Encoding>
+constexpr auto _padded_buffer_reader(const typename Encoding::char_type* begin,
+                                     const typename Encoding::char_type* end)
+{
+    if constexpr (std::is_same_v<Encoding, lexy::default_encoding>)
+        return _bprd(begin, end);
+    else if constexpr (std::is_same_v<Encoding, lexy::byte_encoding>)
+        return _bprb(begin, end);
+    else if constexpr (std::is_same_v<Encoding, lexy::utf16_encoding>)
+        return _bpr16(begin, end);
+    else
+        return _bpr<Encoding>(begin, end);
+}
 } // namespace lexy
 
 namespace lexy
@@ -91,12 +217,15 @@ namespace lexy
 /// Stores the input that will be parsed.
 /// For encodings with spare code points, it can append an EOF sentinel.
 /// This allows branch-less detection of EOF.
+/// For other encodings, it still appends padding, so SWAR can be used.
 template <typename Encoding = default_encoding, typename MemoryResource = void>
 class buffer
 {
     static_assert(lexy::is_char_encoding<Encoding>);
     static constexpr auto _has_sentinel
         = std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
+    static constexpr auto _has_padding
+        = sizeof(typename Encoding::char_type) < sizeof(_detail::swar_int);
 
 public:
     using encoding  = Encoding;
@@ -186,7 +315,7 @@ public:
     : buffer(view.data(), view.size(), resource)
     {}
 
-    buffer(const buffer& other) : buffer(other.data(), other.size(), other._resource.get()) {}
+    buffer(const buffer& other) : buffer(other, other._resource.get()) {}
     buffer(const buffer& other, MemoryResource* resource)
     : buffer(other.data(), other.size(), resource)
     {}
@@ -203,9 +332,8 @@ public:
         if (!_data)
             return;
 
-        if constexpr (_has_sentinel)
-            _resource->deallocate(_data,
-                                  _detail::round_size_for_swar(_size + 1) * sizeof(char_type),
+        if constexpr (_has_padding)
+            _resource->deallocate(_data, _padded_size(_size) * sizeof(char_type),
                                   alignof(char_type));
         else
             _resource->deallocate(_data, _size * sizeof(char_type), alignof(char_type));
@@ -266,21 +394,29 @@ public:
     {
         if constexpr (_has_sentinel)
             return _buffer_reader<encoding>(_data);
+        else if constexpr (_has_padding)
+            return _padded_buffer_reader<encoding>(_data, _data + _size);
         else
             return _range_reader<encoding>(_data, _data + _size);
     }
 
 private:
+    // The number of code units we need to allocate for the sentinel/padding.
+    static constexpr std::size_t _padded_size(std::size_t size)
+    {
+        return _detail::round_size_for_swar(size + 1) + _detail::simd_padding<char_type>;
+    }
+
     char_type* allocate(std::size_t size) const
     {
-        if constexpr (_has_sentinel)
+        if constexpr (_has_padding)
         {
-            auto mem_size = _detail::round_size_for_swar(size + 1);
+            auto mem_size = _padded_size(size);
             auto memory   = static_cast<char_type*>(
                 _resource->allocate(mem_size * sizeof(char_type), alignof(char_type)));
 
             for (auto ptr = memory + size; ptr != memory + mem_size; ++ptr)
-                *ptr = encoding::eof();
+                *ptr = _detail::swar_eof<encoding>;
 
             return memory;
         }
@@ -313,6 +449,15 @@ template <typename View, typename MemoryResource>
 buffer(const View&, MemoryResource*)
     -> buffer<deduce_encoding<LEXY_DECAY_DECLTYPE(*LEXY_DECLVAL(View).data())>, MemoryResource>;
 
+/// Returns true if the buffer contains well-formed UTF-8.
+template <typename Encoding, typename MemoryResource>
+bool validate_utf8(const buffer<Encoding, MemoryResource>& buffer) noexcept
+{
+    static_assert(sizeof(typename Encoding::char_type) == 1, "only UTF-8 buffers can be validated");
+    return _detail::validate_utf8(reinterpret_cast<const unsigned char*>(buffer.data()),
+                                  buffer.size());
+}
+
 //=== make_buffer ===//
 template <typename Encoding, encoding_endianness Endian>
 struct _make_buffer
@@ -338,30 +483,12 @@ struct _make_buffer
         }
         else
         {
+            static_assert(Endian != encoding_endianness::bom, "unhandled encoding/endianness");
+
+            // The data is in the opposite of the native endianness, so we need to swap bytes.
             typename buffer<Encoding, MemoryResource>::builder builder(size / sizeof(char_type),
                                                                        resource);
-
-            const auto end = memory + size;
-            for (auto dest = builder.data(); memory != end; memory += sizeof(char_type))
-            {
-                constexpr auto is_char16 = std::is_same_v<char_type, char16_t>;
-                constexpr auto is_char32 = std::is_same_v<char_type, char32_t>;
-
-                // We convert each group of bytes to the appropriate value.
-                if constexpr (is_char16 && Endian == encoding_endianness::little)
-                    *dest++ = static_cast<char_type>((memory[0] << 0) | (memory[1] << 8));
-                else if constexpr (is_char32 && Endian == encoding_endianness::little)
-                    *dest++ = static_cast<char_type>((memory[0] << 0) | (memory[1] << 8)
-                                                     | (memory[2] << 16) | (memory[3] << 24));
-                else if constexpr (is_char16 && Endian == encoding_endianness::big)
-                    *dest++ = static_cast<char_type>((memory[0] << 8) | (memory[1] << 0));
-                else if constexpr (is_char32 && Endian == encoding_endianness::big)
-                    *dest++ = static_cast<char_type>((memory[0] << 24) | (memory[1] << 16)
-                                                     | (memory[2] << 8) | (memory[3] << 0));
-                else
-                    static_assert(_detail::error<Encoding>, "unhandled encoding/endianness");
-            }
-
+            _detail::copy_byte_swapped(builder.data(), memory, builder.size());
             return LEXY_MOV(builder).finish();
         }
     }
@@ -452,6 +579,62 @@ struct _make_buffer<utf32_encoding, encoding_endianness::bom>
 template <typename Encoding, encoding_endianness Endianness>
 constexpr auto make_buffer_from_raw = _make_buffer<Encoding, Endianness>{};
 
+template <typename Encoding, encoding_endianness Endian>
+struct _make_buffer_utf16
+{
+    static_assert(std::is_same_v<Encoding, utf8_encoding>
+                      || std::is_same_v<Encoding, utf8_char_encoding>,
+                  "can only transcode UTF-16 to UTF-8");
+
+    template <typename MemoryResource = void>
+    auto operator()(const void* memory, std::size_t size,
+                    MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) const
+    {
+        auto replaced = std::size_t(0);
+        return (*this)(memory, size, replaced, resource);
+    }
+
+    // `replaced` is set to the number of lone surrogates that have been replaced by U+FFFD.
+    template <typename MemoryResource = void>
+    auto operator()(const void* _memory, std::size_t size, std::size_t& replaced,
+                    MemoryResource* resource = _detail::get_memory_resource<MemoryResource>()) const
+    {
+        constexpr auto native_endianness
+            = LEXY_IS_LITTLE_ENDIAN ? encoding_endianness::little : encoding_endianness::big;
+
+        LEXY_PRECONDITION(size % 2 == 0);
+        auto memory = static_cast<const unsigned char*>(_memory);
+
+        if constexpr (Endian == encoding_endianness::bom)
+        {
+            constexpr auto from_big    = _make_buffer_utf16<Encoding, encoding_endianness::big>{};
+            constexpr auto from_little = _make_buffer_utf16<Encoding, encoding_endianness::little>{};
+
+            if (size >= 2 && memory[0] == 0xFF && memory[1] == 0xFE)
+                return from_little(memory + 2, size - 2, replaced, resource);
+            else if (size >= 2 && memory[0] == 0xFE && memory[1] == 0xFF)
+                return from_big(memory + 2, size - 2, replaced, resource);
+            else
+                return from_big(memory, size, replaced, resource);
+        }
+        else
+        {
+            constexpr auto swap  = Endian != native_endianness;
+            auto           count = size / 2;
+
+            // We first compute the exact size, so we only need a single allocation.
+            auto length = _detail::utf8_length_of_utf16<swap>(memory, count, replaced);
+            typename buffer<Encoding, MemoryResource>::builder builder(length, resource);
+            _detail::transcode_utf16_to_utf8<swap>(builder.data(), memory, count);
+            return LEXY_MOV(builder).finish();
+        }
+    }
+};
+
+/// Creates a UTF-8 buffer from raw memory containing UTF-16 with the specified endianness.
+template <typename Encoding, encoding_endianness Endianness>
+constexpr auto make_buffer_from_utf16 = _make_buffer_utf16<Encoding, Endianness>{};
+
 //=== make_buffer_from_input ===//
 template <typename Input>
 using _detect_input_data = decltype(LEXY_DECLVAL(Input&).data());
@@ -26,6 +26,18 @@ enum class file_error
     /// The file cannot be opened.
     permission_denied,
 };
+
+/// Hints to the operating system on how the contents of a file are going to be accessed.
+/// They are ignored on platforms that don't support them.
+struct file_options
+{
+    /// Read the entire file into memory immediately instead of page by page on first access.
+    bool populate = false;
+    /// The file is accessed sequentially, so the kernel should read ahead aggressively.
+    bool sequential = false;
+    /// Back the memory with transparent huge pages to reduce page faults and TLB misses.
+    bool huge_pages = false;
+};
 } // namespace lexy
 
 namespace lexy::_detail
@@ -39,8 +51,103 @@ using file_callback = void (*)(void* user_data, const char* memory, std::size_t
 // Do not change ABI, especially with different build configurations!
 file_error read_file(const char* path, file_callback cb, void* user_data);
 
+// Same as above, but passes the hints given by `file_option_flags()` to the operating system.
+file_error read_file(const char* path, unsigned options, file_callback cb, void* user_data);
+
 // Same as above, but reads from stdin.
 file_error read_stdin(file_callback cb, void* user_data);
+
+// A part of a file that has been read in multiple chunks.
+struct file_chunk
+{
+    const char* memory;
+    std::size_t size;
+};
+
+// Returns the next chunk and frees the memory of the chunk it has returned before.
+// Once all chunks have been returned, returns a chunk of size zero.
+using file_chunk_reader = file_chunk (*)(void* chunks);
+
+using file_chunks_callback = void (*)(void* user_data, std::size_t total_size,
+                                      file_chunk_reader next_chunk, void* chunks);
+
+// Same as above, but the callback receives the contents in chunks.
+// As the size of a pipe isn't known in advance, it is read into multiple chunks.
+// The callback pulls them one at a time to copy them to their final location,
+// so each chunk is freed as soon as it has been copied.
+// All chunks but the last one have a size that is a multiple of 4.
+file_error read_stdin(file_chunks_callback cb, void* user_data);
+
+enum file_option_flag : unsigned
+{
+    file_option_populate   = 1u << 0,
+    file_option_sequential = 1u << 1,
+    file_option_huge_pages = 1u << 2,
+};
+
+constexpr unsigned file_option_flags(file_options options) noexcept
+{
+    auto result = 0u;
+    if (options.populate)
+        result |= file_option_populate;
+    if (options.sequential)
+        result |= file_option_sequential;
+    if (options.huge_pages)
+        result |= file_option_huge_pages;
+    return result;
+}
+
+// Applies the memory related hints of `file_option_flags()` to memory that has been allocated by
+// the caller; it needs to be called before the memory is written to.
+void advise_memory(const void* memory, std::size_t size, unsigned options) noexcept;
+
+struct file_mapping
+{
+    char*       memory;      // The beginning of the mapping.
+    std::size_t size;        // The size of the file contents.
+    std::size_t mapped_size; // The size of the entire mapping.
+};
+
+// Maps the entire contents of the specified file into memory.
+// The contents are followed by at least `padding` bytes of writable memory.
+// The mapping is private, so writes are never visible in the file.
+// The hints given by `file_option_flags()` are passed to the operating system.
+// On success, fills `mapping`, which must later be released using `unmap_file()`.
+// On error, returns the error without changing `mapping`.
+//
+// Do not change ABI, especially with different build configurations!
+file_error map_file(const char* path, std::size_t padding, unsigned options,
+                    file_mapping& mapping);
+void       unmap_file(const file_mapping& mapping) noexcept;
+
+using file_batch_callback = void (*)(void* user_data, std::size_t index, file_error ec,
+                                     const char* memory, std::size_t size);
+
+// Reads the `count` files at the specified paths using `thread_count` threads
+// (the calling thread and `thread_count - 1` workers, 0 means one per hardware thread).
+// As soon as a file has been read, invokes the callback with its index and contents,
+// potentially concurrently from multiple threads.
+// On error, invokes the callback with the error and without memory.
+// If the callback throws, no further files are read and the exception is rethrown.
+//
+// Do not change ABI, especially with different build configurations!
+void read_files(const char* const* paths, std::size_t count, std::size_t thread_count,
+                file_batch_callback cb, void* user_data);
+
+// Same as above, but reads the files using asynchronous I/O (io_uring) on the calling thread,
+// keeping up to `queue_depth` files in flight (0 means a default).
+// The callback is invoked on the calling thread while I/O for the other files is in progress.
+// If asynchronous I/O is not available, reads the files one after the other.
+//
+// Do not change ABI, especially with different build configurations!
+void read_files_async(const char* const* paths, std::size_t count, std::size_t queue_depth,
+                      file_batch_callback cb, void* user_data);
+// Whether `read_files_async()` uses asynchronous I/O.
+bool has_async_file_io() noexcept;
+
+// Reads at most `size` bytes from the file descriptor into the buffer.
+// Returns the number of bytes read, zero on EOF, or a negative value on error.
+std::ptrdiff_t read_fd(int fd, void* buffer, std::size_t size) noexcept;
 } // namespace lexy::_detail
 
 namespace lexy
@@ -91,21 +198,146 @@ private:
     file_error                             _ec;
 };
 
+// Creates a buffer from the chunks of a file, like `make_buffer_from_raw()` does for one block.
+// `next_chunk()` is called repeatedly until it returns an empty chunk.
+// The memory hints of `file_option_flags()` are applied before the chunks are copied.
+template <typename Encoding, encoding_endianness Endian>
+struct _make_buffer_from_chunks
+{
+    using char_type = typename Encoding::char_type;
+
+    struct bom_info
+    {
+        std::size_t         size;
+        encoding_endianness endian;
+    };
+
+    // Same logic as the specializations of `_make_buffer`.
+    static constexpr bom_info get_bom(const unsigned char* memory, std::size_t size) noexcept
+    {
+        if constexpr (Endian != encoding_endianness::bom)
+            return {0, Endian};
+        else if constexpr (std::is_same_v<Encoding, utf8_encoding>
+                           || std::is_same_v<Encoding, utf8_char_encoding>)
+        {
+            if (size >= 3 && memory[0] == 0xEF && memory[1] == 0xBB && memory[2] == 0xBF)
+                return {3, encoding_endianness::big};
+            else
+                return {0, encoding_endianness::big};
+        }
+        else if constexpr (std::is_same_v<Encoding, utf16_encoding>)
+        {
+            if (size >= 2 && memory[0] == 0xFF && memory[1] == 0xFE)
+                return {2, encoding_endianness::little};
+            else if (size >= 2 && memory[0] == 0xFE && memory[1] == 0xFF)
+                return {2, encoding_endianness::big};
+            else
+                return {0, encoding_endianness::big};
+        }
+        else if constexpr (std::is_same_v<Encoding, utf32_encoding>)
+        {
+            if (size >= 4 && memory[0] == 0xFF && memory[1] == 0xFE && memory[2] == 0x00
+                && memory[3] == 0x00)
+                return {4, encoding_endianness::little};
+            else if (size >= 4 && memory[0] == 0x00 && memory[1] == 0x00 && memory[2] == 0xFE
+                     && memory[3] == 0xFF)
+                return {4, encoding_endianness::big};
+            else
+                return {0, encoding_endianness::big};
+        }
+        else
+        {
+            static_assert(sizeof(char_type) == 1, "unhandled encoding/endianness");
+            return {0, encoding_endianness::big};
+        }
+    }
+
+    template <typename NextChunk, typename MemoryResource>
+    auto operator()(std::size_t total_size, NextChunk next_chunk, MemoryResource* resource,
+                    unsigned options = 0) const
+    {
+        constexpr auto native_endianness
+            = LEXY_IS_LITTLE_ENDIAN ? encoding_endianness::little : encoding_endianness::big;
+        LEXY_PRECONDITION(total_size % sizeof(char_type) == 0);
+
+        auto chunk = next_chunk();
+        auto bom   = get_bom(reinterpret_cast<const unsigned char*>(chunk.memory), chunk.size);
+
+        typename buffer<Encoding, MemoryResource>::builder builder((total_size - bom.size)
+                                                                       / sizeof(char_type),
+                                                                   resource);
+        if (options != 0)
+            _detail::advise_memory(builder.data(), builder.size() * sizeof(char_type), options);
+
+        auto dest = builder.data();
+        auto skip = bom.size;
+        for (; chunk.size > 0; chunk = next_chunk())
+        {
+            auto memory = reinterpret_cast<const unsigned char*>(chunk.memory) + skip;
+            auto size   = (chunk.size - skip) / sizeof(char_type);
+
+            if constexpr (sizeof(char_type) == 1)
+                std::memcpy(dest, memory, size);
+            else if (bom.endian == native_endianness)
+                std::memcpy(dest, memory, size * sizeof(char_type));
+            else
+                _detail::copy_byte_swapped(dest, memory, size);
+            dest += size;
+            skip = 0;
+        }
+
+        return LEXY_MOV(builder).finish();
+    }
+};
+
 template <typename Encoding, encoding_endianness Endian, typename MemoryResource>
 struct _read_file_user_data
 {
     lexy::buffer<Encoding, MemoryResource> buffer;
     MemoryResource*                        resource;
+    unsigned                               options;
 
-    _read_file_user_data(MemoryResource* resource) : buffer(resource), resource(resource) {}
+    _read_file_user_data(MemoryResource* resource, unsigned options = 0)
+    : buffer(resource), resource(resource), options(options)
+    {}
 
     static auto callback()
     {
         return [](void* _user_data, const char* memory, std::size_t size) {
             auto user_data = static_cast<_read_file_user_data*>(_user_data);
 
+            if (user_data->options == 0)
+            {
+                user_data->buffer
+                    = lexy::make_buffer_from_raw<Encoding, Endian>(memory, size,
+                                                                   user_data->resource);
+            }
+            else
+            {
+                // The hints need to be applied before the memory is written to.
+                auto chunk      = _detail::file_chunk{memory, size};
+                auto next_chunk = [&chunk] {
+                    auto result = chunk;
+                    chunk       = {nullptr, 0};
+                    return result;
+                };
+                user_data->buffer
+                    = _make_buffer_from_chunks<Encoding, Endian>{}(size, next_chunk,
+                                                                   user_data->resource,
+                                                                   user_data->options);
+            }
+        };
+    }
+
+    static auto chunks_callback()
+    {
+        return [](void* _user_data, std::size_t total_size, _detail::file_chunk_reader next,
+                  void* chunks) {
+            auto user_data  = static_cast<_read_file_user_data*>(_user_data);
+            auto next_chunk = [next, chunks] { return next(chunks); };
             user_data->buffer
-                = lexy::make_buffer_from_raw<Encoding, Endian>(memory, size, user_data->resource);
+                = _make_buffer_from_chunks<Encoding, Endian>{}(total_size, next_chunk,
+                                                               user_data->resource);
         };
     }
 };
@@ -122,6 +354,19 @@ auto read_file(const char*     path,
     return read_file_result(error, LEXY_MOV(user_data.buffer));
 }
 
+/// Reads the file at the specified path into a buffer, passing the hints to the operating system.
+template <typename Encoding          = default_encoding,
+          encoding_endianness Endian = encoding_endianness::bom, typename MemoryResource = void>
+auto read_file(const char* path, file_options options,
+               MemoryResource* resource = _detail::get_memory_resource<MemoryResource>())
+    -> read_file_result<Encoding, MemoryResource>
+{
+    auto flags = _detail::file_option_flags(options);
+    _read_file_user_data<Encoding, Endian, MemoryResource> user_data(resource, flags);
+    auto error = _detail::read_file(path, flags, user_data.callback(), &user_data);
+    return read_file_result(error, LEXY_MOV(user_data.buffer));
+}
+
 /// Reads stdin into a buffer.
 template <typename Encoding          = default_encoding,
           encoding_endianness Endian = encoding_endianness::bom, typename MemoryResource = void>
@@ -129,9 +374,234 @@ auto read_stdin(MemoryResource* resource = _detail::get_memory_resource<MemoryRe
     -> read_file_result<Encoding, MemoryResource>
 {
     _read_file_user_data<Encoding, Endian, MemoryResource> user_data(resource);
-    auto error = _detail::read_stdin(user_data.callback(), &user_data);
+    auto error = _detail::read_stdin(user_data.chunks_callback(), &user_data);
     return read_file_result(error, LEXY_MOV(user_data.buffer));
 }
+
+template <typename Encoding, encoding_endianness Endian, typename Callback>
+struct _read_files_user_data
+{
+    Callback* callback;
+
+    static void invoke(void* _user_data, std::size_t index, file_error ec, const char* memory,
+                       std::size_t size)
+    {
+        auto user_data = static_cast<_read_files_user_data*>(_user_data);
+
+        auto resource = _detail::get_memory_resource<void>();
+        if (ec == file_error::_success)
+        {
+            auto buffer = lexy::make_buffer_from_raw<Encoding, Endian>(memory, size, resource);
+            (*user_data->callback)(index, read_file_result(ec, LEXY_MOV(buffer)));
+        }
+        else
+        {
+            (*user_data->callback)(index, read_file_result<Encoding>(ec, resource));
+        }
+    }
+};
+
+/// Reads the files at the specified paths into buffers using multiple threads.
+/// As soon as a file has been read, invokes `callback(index, read_file_result&&)`;
+/// the callback is invoked concurrently from multiple threads.
+template <typename Encoding          = default_encoding,
+          encoding_endianness Endian = encoding_endianness::bom, typename Callback>
+void read_files(const char* const* paths, std::size_t count, Callback callback,
+                std::size_t thread_count = 0)
+{
+    using user_data_t = _read_files_user_data<Encoding, Endian, Callback>;
+    user_data_t user_data{&callback};
+    _detail::read_files(paths, count, thread_count, &user_data_t::invoke, &user_data);
+}
+
+/// Reads the files at the specified paths into buffers using asynchronous I/O where available.
+/// As soon as a file has been read, invokes `callback(index, read_file_result&&)` on the calling
+/// thread, while the I/O for the following files is still in progress.
+template <typename Encoding          = default_encoding,
+          encoding_endianness Endian = encoding_endianness::bom, typename Callback>
+void read_files_async(const char* const* paths, std::size_t count, Callback callback,
+                      std::size_t queue_depth = 0)
+{
+    using user_data_t = _read_files_user_data<Encoding, Endian, Callback>;
+    user_data_t user_data{&callback};
+    _detail::read_files_async(paths, count, queue_depth, &user_data_t::invoke, &user_data);
+}
+} // namespace lexy
+
+namespace lexy
+{
+/// An input that owns a memory mapping of a file.
+/// Unlike a buffer, it does not copy the file contents.
+template <typename Encoding = default_encoding>
+class mapped_file
+{
+    static_assert(lexy::is_char_encoding<Encoding>);
+    static constexpr auto _has_sentinel
+        = std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+    static_assert(std::is_trivially_copyable_v<char_type>);
+
+    //=== constructors ===//
+    constexpr mapped_file() noexcept : _mapping{nullptr, 0, 0}, _data(nullptr), _size(0) {}
+
+    mapped_file(const mapped_file&)            = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& other) noexcept
+    : _mapping(other._mapping), _data(other._data), _size(other._size)
+    {
+        other._mapping = {nullptr, 0, 0};
+        other._data    = nullptr;
+        other._size    = 0;
+    }
+
+    mapped_file& operator=(mapped_file&& other) noexcept
+    {
+        _detail::swap(_mapping, other._mapping);
+        _detail::swap(_data, other._data);
+        _detail::swap(_size, other._size);
+        return *this;
+    }
+
+    ~mapped_file() noexcept
+    {
+        if (_mapping.memory)
+            _detail::unmap_file(_mapping);
+    }
+
+    //=== access ===//
+    const char_type* data() const noexcept
+    {
+        return _data;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    //=== input ===//
+    auto reader() const& noexcept
+    {
+        if constexpr (_has_sentinel)
+            return _buffer_reader<encoding>(_data);
+        else
+            return _range_reader<encoding>(_data, _data + _size);
+    }
+
+public:
+    // Pretend this doesn't exist.
+    explicit mapped_file(const _detail::file_mapping& mapping) noexcept : _mapping(mapping)
+    {
+        auto memory = mapping.memory;
+        auto size   = mapping.size;
+
+        // We skip over a BOM in native endianness, if there is one.
+        if constexpr (std::is_same_v<Encoding, lexy::utf8_encoding>
+                      || std::is_same_v<Encoding, lexy::utf8_char_encoding>)
+        {
+            auto bytes = reinterpret_cast<const unsigned char*>(memory);
+            if (size >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+            {
+                memory += 3;
+                size -= 3;
+            }
+        }
+        else if constexpr (std::is_same_v<Encoding, lexy::utf16_encoding>
+                           || std::is_same_v<Encoding, lexy::utf32_encoding>)
+        {
+            constexpr auto bom = char_type(0xFEFF);
+            if (size >= sizeof(char_type) && std::memcmp(memory, &bom, sizeof(char_type)) == 0)
+            {
+                memory += sizeof(char_type);
+                size -= sizeof(char_type);
+            }
+        }
+
+        // The reinterpret_cast is technically UB, as we didn't create objects in memory,
+        // but until std::start_lifetime_as is added, there is nothing we can do.
+        // A trailing partial code unit is ignored.
+        _data = reinterpret_cast<char_type*>(memory);
+        _size = size / sizeof(char_type);
+
+        if constexpr (_has_sentinel)
+        {
+            // The padding of the mapping is big enough for the sentinel and SWAR/SIMD access.
+            auto end = _data + _detail::round_size_for_swar(_size + 1)
+                       + _detail::simd_padding<char_type>;
+            for (auto ptr = _data + _size; ptr != end; ++ptr)
+                *ptr = encoding::eof();
+        }
+    }
+
+    static constexpr std::size_t _padding
+        = (2 * sizeof(_detail::swar_int) + _detail::simd_padding<char_type>) * sizeof(char_type);
+
+private:
+    _detail::file_mapping _mapping;
+    char_type*            _data;
+    std::size_t           _size;
+};
+
+template <typename Encoding = default_encoding>
+class map_file_result
+{
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+
+    explicit operator bool() const noexcept
+    {
+        return _ec == file_error::_success;
+    }
+
+    const lexy::mapped_file<Encoding>& file() const& noexcept
+    {
+        LEXY_PRECONDITION(*this);
+        return _file;
+    }
+    lexy::mapped_file<Encoding>&& file() && noexcept
+    {
+        LEXY_PRECONDITION(*this);
+        return LEXY_MOV(_file);
+    }
+
+    file_error error() const noexcept
+    {
+        LEXY_PRECONDITION(!*this);
+        return _ec;
+    }
+
+public:
+    // Pretend these two don't exist.
+    explicit map_file_result(file_error ec, lexy::mapped_file<Encoding>&& file) noexcept
+    : _file(LEXY_MOV(file)), _ec(ec)
+    {}
+    explicit map_file_result(file_error ec) noexcept : _file(), _ec(ec)
+    {
+        LEXY_PRECONDITION(!*this);
+    }
+
+private:
+    lexy::mapped_file<Encoding> _file;
+    file_error                  _ec;
+};
+
+/// Maps the file at the specified path into memory without copying it.
+template <typename Encoding = default_encoding>
+auto map_file(const char* path, file_options options = {}) -> map_file_result<Encoding>
+{
+    _detail::file_mapping mapping;
+    auto error = _detail::map_file(path, mapped_file<Encoding>::_padding,
+                                   _detail::file_option_flags(options), mapping);
+    if (error != file_error::_success)
+        return map_file_result<Encoding>(error);
+
+    return map_file_result<Encoding>(error, mapped_file<Encoding>(mapping));
+}
 } // namespace lexy
 
 #endif // LEXY_INPUT_FILE_HPP_INCLUDED
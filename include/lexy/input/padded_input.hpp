@@ -0,0 +1,103 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_INPUT_PADDED_INPUT_HPP_INCLUDED
+#define LEXY_INPUT_PADDED_INPUT_HPP_INCLUDED
+
+#include <lexy/_detail/swar.hpp>
+#include <lexy/error.hpp>
+#include <lexy/input/base.hpp>
+#include <lexy/input/buffer.hpp>
+#include <lexy/lexeme.hpp>
+
+namespace lexy
+{
+/// An input that refers to caller-owned memory with spare capacity after the input.
+/// The spare capacity is used to store the EOF sentinel and SWAR padding, just like a buffer,
+/// but without copying the input.
+template <typename Encoding = default_encoding>
+class padded_input
+{
+    static_assert(lexy::is_char_encoding<Encoding>);
+    static constexpr auto _has_sentinel
+        = std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>;
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+
+    /// The number of code units that are required after the input.
+    static constexpr std::size_t padding = [] {
+        if constexpr (_has_sentinel)
+            return _detail::swar_length<char_type> + _detail::simd_padding<char_type>;
+        else
+            return std::size_t(0);
+    }();
+
+    //=== constructors ===//
+    /// Requires that `[data, data + capacity)` is writable and `capacity >= size + padding`.
+    /// It overwrites the code units after the input.
+    padded_input(char_type* data, std::size_t size, std::size_t capacity) noexcept
+    : _data(data), _size(size)
+    {
+        LEXY_PRECONDITION(capacity >= size && capacity - size >= padding);
+
+        if constexpr (_has_sentinel)
+        {
+            for (auto ptr = data + size; ptr != data + size + padding; ++ptr)
+                *ptr = encoding::eof();
+        }
+        else
+        {
+            (void)capacity;
+        }
+    }
+
+    template <typename CharT, typename = _detail::require_secondary_char_type<Encoding, CharT>>
+    padded_input(CharT* data, std::size_t size, std::size_t capacity) noexcept
+    : padded_input(reinterpret_cast<char_type*>(data), size, capacity)
+    {
+        static_assert(sizeof(CharT) == sizeof(char_type));
+    }
+
+    //=== access ===//
+    constexpr const char_type* data() const noexcept
+    {
+        return _data;
+    }
+
+    constexpr std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    //=== reader ===//
+    auto reader() const& noexcept
+    {
+        if constexpr (_has_sentinel)
+            return _buffer_reader<encoding>(_data);
+        else
+            return _range_reader<encoding>(_data, _data + _size);
+    }
+
+private:
+    char_type*  _data;
+    std::size_t _size;
+};
+
+template <typename CharT>
+padded_input(CharT*, std::size_t, std::size_t) -> padded_input<deduce_encoding<CharT>>;
+
+//=== convenience typedefs ===//
+template <typename Encoding = default_encoding>
+using padded_lexeme = lexeme_for<padded_input<Encoding>>;
+
+template <typename Tag, typename Encoding = default_encoding>
+using padded_error = error_for<padded_input<Encoding>, Tag>;
+
+template <typename Encoding = default_encoding>
+using padded_error_context = error_context<padded_input<Encoding>>;
+} // namespace lexy
+
+#endif // LEXY_INPUT_PADDED_INPUT_HPP_INCLUDED
+
@@ -0,0 +1,252 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_INPUT_SEGMENTED_INPUT_HPP_INCLUDED
+#define LEXY_INPUT_SEGMENTED_INPUT_HPP_INCLUDED
+
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/swar.hpp>
+#include <lexy/error.hpp>
+#include <lexy/input/base.hpp>
+#include <lexy/lexeme.hpp>
+
+namespace lexy
+{
+/// A contiguous part of a segmented input.
+template <typename CharT>
+struct input_segment
+{
+    const CharT* data;
+    std::size_t  size;
+};
+
+// Used if an input has no segments, so we always have one.
+template <typename CharT>
+inline constexpr input_segment<CharT> _empty_segment = {nullptr, 0};
+
+// Moves to the next non-empty segment if ptr is at the end of the current one.
+// That way, every position has exactly one representation: only EOF is at the end of a segment.
+template <typename CharT>
+constexpr void _skip_segment_end(const input_segment<CharT>*& seg, const input_segment<CharT>* last,
+                                 const CharT*& ptr)
+{
+    while (ptr == seg->data + seg->size && seg + 1 != last)
+    {
+        ++seg;
+        ptr = seg->data;
+    }
+}
+
+template <typename Encoding>
+class _segmented_iterator
+: public _detail::forward_iterator_base<_segmented_iterator<Encoding>,
+                                        const typename Encoding::char_type>
+{
+public:
+    using char_type = typename Encoding::char_type;
+    using segment   = input_segment<char_type>;
+
+    constexpr _segmented_iterator() noexcept : _seg(nullptr), _last(nullptr), _ptr(nullptr) {}
+    constexpr explicit _segmented_iterator(const segment* seg, const segment* last,
+                                           const char_type* ptr) noexcept
+    : _seg(seg), _last(last), _ptr(ptr)
+    {}
+
+    constexpr const char_type& deref() const noexcept
+    {
+        return *_ptr;
+    }
+
+    constexpr void increment() noexcept
+    {
+        LEXY_PRECONDITION(_ptr != _seg->data + _seg->size);
+        ++_ptr;
+        _skip_segment_end(_seg, _last, _ptr);
+    }
+
+    constexpr bool equal(const _segmented_iterator& rhs) const noexcept
+    {
+        // Segments might share memory, so we need to compare both.
+        return _seg == rhs._seg && _ptr == rhs._ptr;
+    }
+
+private:
+    const segment*   _seg;
+    const segment*   _last;
+    const char_type* _ptr;
+
+    template <typename>
+    friend class _segr;
+};
+
+struct _segr_no_swar
+{};
+
+// The reader of a segmented_input.
+template <typename Encoding>
+class _segr : public std::conditional_t<
+                  std::is_same_v<typename Encoding::char_type, typename Encoding::int_type>,
+                  _detail::_swar_base, _segr_no_swar>
+{
+public:
+    using encoding  = Encoding;
+    using char_type = typename Encoding::char_type;
+    using iterator  = _segmented_iterator<Encoding>;
+    using segment   = input_segment<char_type>;
+
+    struct marker
+    {
+        iterator _it;
+
+        constexpr iterator position() const noexcept
+        {
+            return _it;
+        }
+    };
+
+    constexpr explicit _segr(const segment* first, const segment* last) noexcept
+    : _seg(first), _last(last), _cur(first->data), _end(first->data + first->size)
+    {
+        next_segment();
+    }
+
+    constexpr auto peek() const noexcept
+    {
+        // We're only at the end of a segment if we've reached EOF.
+        if (_cur == _end)
+            return encoding::eof();
+        else
+            return encoding::to_int_type(*_cur);
+    }
+
+    constexpr void bump() noexcept
+    {
+        LEXY_PRECONDITION(_cur != _end);
+        ++_cur;
+        if (_cur == _end)
+            next_segment();
+    }
+
+    constexpr iterator position() const noexcept
+    {
+        return iterator(_seg, _last, _cur);
+    }
+
+    constexpr marker current() const noexcept
+    {
+        return {position()};
+    }
+    constexpr void reset(marker m) noexcept
+    {
+        _seg = m._it._seg;
+        _cur = m._it._ptr;
+        _end = _seg->data + _seg->size;
+    }
+
+    //=== SWAR ===//
+    _detail::swar_int peek_swar() const noexcept
+    {
+        constexpr auto length = _detail::swar_length<char_type>;
+        if (std::size_t(_end - _cur) >= length)
+            // Fast path: the entire SWAR is in the current segment.
+            return _detail::swar_load(_cur);
+
+        // Slow path: we gather the characters one by one, which might cross segments.
+        auto copy   = *this;
+        auto result = _detail::swar_int(0);
+        for (auto i = 0u; i != length; ++i)
+        {
+            auto c = copy.peek();
+            result |= _detail::swar_int(_detail::make_uchar(char_type(c)))
+                      << (i * _detail::char_bit_size<char_type>);
+            if (c != encoding::eof())
+                copy.bump();
+        }
+        return result;
+    }
+
+    void bump_swar() noexcept
+    {
+        bump_swar(_detail::swar_length<char_type>);
+    }
+    void bump_swar(std::size_t char_count) noexcept
+    {
+        if (std::size_t(_end - _cur) > char_count)
+        {
+            _cur += char_count;
+        }
+        else
+        {
+            for (auto i = 0u; i != char_count; ++i)
+                bump();
+        }
+    }
+
+private:
+    constexpr void next_segment() noexcept
+    {
+        _skip_segment_end(_seg, _last, _cur);
+        _end = _seg->data + _seg->size;
+    }
+
+    const segment*   _seg;
+    const segment*   _last;
+    const char_type* _cur;
+    const char_type* _end;
+};
+
+/// An input that consists of multiple contiguous segments, e.g. the pieces of a piece table or
+/// the buffers of a scatter-gather read.
+template <typename Encoding = default_encoding>
+class segmented_input
+{
+    static_assert(lexy::is_char_encoding<Encoding>);
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+    using segment   = input_segment<char_type>;
+
+    //=== constructors ===//
+    constexpr segmented_input() noexcept : segmented_input(nullptr, 0) {}
+
+    constexpr segmented_input(const segment* segments, std::size_t count) noexcept
+    : _segments(count == 0 ? &_empty_segment<char_type> : segments),
+      _count(count == 0 ? 1 : count)
+    {}
+
+    //=== access ===//
+    constexpr const segment* segments() const noexcept
+    {
+        return _segments;
+    }
+
+    constexpr std::size_t segment_count() const noexcept
+    {
+        return _count;
+    }
+
+    //=== reader ===//
+    constexpr auto reader() const& noexcept
+    {
+        return _segr<encoding>(_segments, _segments + _count);
+    }
+
+private:
+    const segment* _segments;
+    std::size_t    _count;
+};
+
+//=== convenience typedefs ===//
+template <typename Encoding = default_encoding>
+using segmented_lexeme = lexeme_for<segmented_input<Encoding>>;
+
+template <typename Tag, typename Encoding = default_encoding>
+using segmented_error = error_for<segmented_input<Encoding>, Tag>;
+
+template <typename Encoding = default_encoding>
+using segmented_error_context = error_context<segmented_input<Encoding>>;
+} // namespace lexy
+
+#endif // LEXY_INPUT_SEGMENTED_INPUT_HPP_INCLUDED
+
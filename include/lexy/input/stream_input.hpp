@@ -0,0 +1,583 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+#define LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+
+#include <lexy/_detail/iterator.hpp>
+#include <lexy/_detail/swar.hpp>
+#include <lexy/error.hpp>
+#include <lexy/input/base.hpp>
+#include <lexy/input/file.hpp>
+#include <lexy/lexeme.hpp>
+
+namespace lexy
+{
+// Owns the chunks of a stream.
+// Chunks are reference counted by all readers and iterators pointing into them.
+// Once the oldest chunk is no longer referenced, it is recycled.
+// When the last reader is destroyed, its position is remembered so the next reader continues there.
+template <typename Encoding>
+class _stream_buffer
+{
+public:
+    using char_type = typename Encoding::char_type;
+
+    static constexpr auto _has_sentinel
+        = std::is_same_v<char_type, typename Encoding::int_type>;
+    // The padding is filled with EOF, so SWAR can read past the end of the data.
+    static constexpr auto _padding = _has_sentinel ? 2 * _detail::swar_length<char_type> : 0;
+
+    struct chunk
+    {
+        _stream_buffer* owner;
+        chunk*          next;
+        std::size_t     ref_count;
+        std::size_t     offset; // The position of data[0] in the entire stream.
+        std::size_t     size;
+        char_type*      data;
+
+        void pin() noexcept
+        {
+            ++ref_count;
+        }
+        void unpin() noexcept
+        {
+            LEXY_PRECONDITION(ref_count > 0);
+            if (--ref_count == 0 && owner->_head == this)
+                owner->release();
+        }
+    };
+
+    explicit _stream_buffer(int fd, std::size_t capacity) noexcept
+    : _fd(fd), _capacity(capacity), _head(nullptr), _tail(nullptr), _free(nullptr),
+      _resume_chunk(nullptr), _resume_ptr(nullptr), _reader_count(0), _eof(false), _error(false)
+    {
+        LEXY_PRECONDITION(capacity > 0);
+    }
+
+    _stream_buffer(const _stream_buffer&)            = delete;
+    _stream_buffer& operator=(const _stream_buffer&) = delete;
+
+    ~_stream_buffer() noexcept
+    {
+        destroy_list(_head);
+        destroy_list(_free);
+    }
+
+    // The oldest chunk that is still buffered; reads the first one if necessary.
+    chunk* head()
+    {
+        if (!_head)
+            refill();
+        return _head;
+    }
+
+    // Reads more data and appends it to the last chunk or a new one.
+    // Returns false if the stream is exhausted.
+    bool refill()
+    {
+        if (_eof)
+            return false;
+
+        auto target = _tail;
+        if (!target || target->size == _capacity)
+            target = acquire(_tail ? _tail->offset + _tail->size : 0);
+
+        // For multi-byte code units, we keep on reading until we have a full code unit.
+        auto memory     = reinterpret_cast<unsigned char*>(target->data + target->size);
+        auto max_bytes  = (_capacity - target->size) * sizeof(char_type);
+        auto read_bytes = std::size_t(0);
+        do
+        {
+            auto result = _detail::read_fd(_fd, memory + read_bytes, max_bytes - read_bytes);
+            if (result <= 0)
+            {
+                _eof   = true;
+                _error = result < 0;
+                break;
+            }
+
+            read_bytes += std::size_t(result);
+        } while (read_bytes % sizeof(char_type) != 0);
+
+        auto read_size = read_bytes / sizeof(char_type);
+        if (target != _tail)
+        {
+            if (read_size == 0 && _tail)
+            {
+                // We've created a new chunk without reading anything; give it back.
+                target->next = _free;
+                _free        = target;
+                return false;
+            }
+
+            // Link the new chunk; we always keep the first chunk so readers have something to
+            // point to.
+            if (_tail)
+                _tail->next = target;
+            else
+                _head = target;
+            _tail = target;
+        }
+
+        target->size += read_size;
+        if constexpr (_has_sentinel)
+        {
+            auto end = target->data + target->size + _padding;
+            for (auto ptr = target->data + target->size; ptr != end; ++ptr)
+                *ptr = Encoding::eof();
+        }
+
+        return read_size > 0;
+    }
+
+    std::size_t buffered_size() const noexcept
+    {
+        return _head ? _tail->offset + _tail->size - _head->offset : 0;
+    }
+
+    // The position where the next reader starts: where the last reader stopped, or the beginning.
+    // The chunk remains pinned until `release_resume()` is called.
+    chunk* resume_chunk()
+    {
+        if (!_resume_chunk)
+        {
+            _resume_chunk = head();
+            _resume_ptr   = _resume_chunk->data;
+            _resume_chunk->pin();
+        }
+        return _resume_chunk;
+    }
+    const char_type* resume_ptr() const noexcept
+    {
+        return _resume_ptr;
+    }
+    void release_resume() noexcept
+    {
+        auto c        = _resume_chunk;
+        _resume_chunk = nullptr;
+        c->unpin();
+    }
+
+    bool has_readers() const noexcept
+    {
+        return _reader_count > 0;
+    }
+    void add_reader() noexcept
+    {
+        ++_reader_count;
+    }
+    void remove_reader(chunk* c, const char_type* ptr) noexcept
+    {
+        LEXY_PRECONDITION(_reader_count > 0);
+        if (--_reader_count == 0)
+        {
+            // The reader is destroyed after all its copies, so this is where parsing stopped.
+            c->pin();
+            if (_resume_chunk)
+                _resume_chunk->unpin();
+            _resume_chunk = c;
+            _resume_ptr   = ptr;
+        }
+    }
+
+    bool has_error() const noexcept
+    {
+        return _error;
+    }
+
+private:
+    chunk* acquire(std::size_t offset)
+    {
+        auto result = _free;
+        if (result)
+        {
+            _free = result->next;
+        }
+        else
+        {
+            result = new chunk{this, nullptr, 0, 0, 0, nullptr};
+            result->data
+                = static_cast<char_type*>(::operator new((_capacity + _padding) * sizeof(char_type)));
+        }
+
+        result->next      = nullptr;
+        result->ref_count = 0;
+        result->offset    = offset;
+        result->size      = 0;
+        return result;
+    }
+
+    void release() noexcept
+    {
+        // We never release the last chunk, as new data is appended to it.
+        while (_head != _tail && _head->ref_count == 0)
+        {
+            auto next   = _head->next;
+            _head->next = _free;
+            _free       = _head;
+            _head       = next;
+        }
+    }
+
+    static void destroy_list(chunk* cur) noexcept
+    {
+        while (cur)
+        {
+            auto next = cur->next;
+            ::operator delete(cur->data);
+            delete cur;
+            cur = next;
+        }
+    }
+
+    int         _fd;
+    std::size_t _capacity;
+    chunk*      _head;
+    chunk*      _tail;
+    chunk*      _free;
+
+    chunk*           _resume_chunk;
+    const char_type* _resume_ptr;
+    std::size_t      _reader_count;
+
+    bool _eof, _error;
+};
+
+template <typename Encoding>
+class _stream_iterator
+: public _detail::forward_iterator_base<_stream_iterator<Encoding>,
+                                        const typename Encoding::char_type>
+{
+    using chunk = typename _stream_buffer<Encoding>::chunk;
+
+public:
+    using char_type = typename Encoding::char_type;
+
+    constexpr _stream_iterator() noexcept : _chunk(nullptr), _ptr(nullptr) {}
+    explicit _stream_iterator(chunk* c, const char_type* ptr) noexcept : _chunk(c), _ptr(ptr)
+    {
+        _chunk->pin();
+    }
+
+    _stream_iterator(const _stream_iterator& other) noexcept
+    : _chunk(other._chunk), _ptr(other._ptr)
+    {
+        if (_chunk)
+            _chunk->pin();
+    }
+    _stream_iterator& operator=(const _stream_iterator& other) noexcept
+    {
+        if (other._chunk)
+            other._chunk->pin();
+        if (_chunk)
+            _chunk->unpin();
+
+        _chunk = other._chunk;
+        _ptr   = other._ptr;
+        return *this;
+    }
+
+    ~_stream_iterator() noexcept
+    {
+        if (_chunk)
+            _chunk->unpin();
+    }
+
+    const char_type& deref() const noexcept
+    {
+        if (_ptr == _chunk->data + _chunk->size)
+            // The position at the end of a chunk is the same as the beginning of the next one.
+            return _chunk->next->data[0];
+        else
+            return *_ptr;
+    }
+
+    void increment() noexcept
+    {
+        if (_ptr == _chunk->data + _chunk->size)
+        {
+            auto next = _chunk->next;
+            LEXY_PRECONDITION(next);
+            next->pin();
+            _chunk->unpin();
+
+            _chunk = next;
+            _ptr   = next->data;
+        }
+
+        ++_ptr;
+    }
+
+    bool equal(const _stream_iterator& rhs) const noexcept
+    {
+        if (!_chunk || !rhs._chunk)
+            return !_chunk && !rhs._chunk;
+        else
+            return offset() == rhs.offset();
+    }
+
+    // The position in the entire stream.
+    std::size_t offset() const noexcept
+    {
+        return _chunk->offset + std::size_t(_ptr - _chunk->data);
+    }
+
+private:
+    chunk*           _chunk;
+    const char_type* _ptr;
+
+    template <typename>
+    friend class _sr;
+};
+
+struct _sr_no_swar
+{};
+
+// The reader of a stream_input.
+// Unlike other readers, it isn't noexcept: moving past the data read so far reads more input,
+// which might need to allocate a new chunk.
+template <typename Encoding>
+class _sr : public std::conditional_t<_stream_buffer<Encoding>::_has_sentinel,
+                                      _detail::_swar_base, _sr_no_swar>
+{
+    using chunk = typename _stream_buffer<Encoding>::chunk;
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename Encoding::char_type;
+    using iterator  = _stream_iterator<Encoding>;
+
+    struct marker
+    {
+        iterator _it;
+
+        iterator position() const noexcept
+        {
+            return _it;
+        }
+    };
+
+    explicit _sr(chunk* c, const char_type* cur) : _chunk(c), _cur(cur), _end(c->data + c->size)
+    {
+        _chunk->pin();
+        _chunk->owner->add_reader();
+        if (_cur == _end)
+            advance();
+    }
+
+    _sr(const _sr& other) noexcept : _chunk(other._chunk), _cur(other._cur), _end(other._end)
+    {
+        _chunk->pin();
+        _chunk->owner->add_reader();
+    }
+    _sr& operator=(const _sr& other) noexcept
+    {
+        other._chunk->pin();
+        _chunk->unpin();
+
+        _chunk = other._chunk;
+        _cur   = other._cur;
+        _end   = other._end;
+        return *this;
+    }
+
+    ~_sr() noexcept
+    {
+        _chunk->owner->remove_reader(_chunk, _cur);
+        _chunk->unpin();
+    }
+
+    auto peek() const noexcept
+    {
+        // We're only at the end of a chunk if we've reached EOF.
+        if constexpr (_stream_buffer<Encoding>::_has_sentinel)
+            return *_cur; // The sentinel is EOF.
+        else if (_cur == _end)
+            return encoding::eof();
+        else
+            return encoding::to_int_type(*_cur);
+    }
+
+    void bump()
+    {
+        LEXY_PRECONDITION(_cur != _end);
+        ++_cur;
+        if (_cur == _end)
+            advance();
+    }
+
+    iterator position() const noexcept
+    {
+        return iterator(_chunk, _cur);
+    }
+
+    marker current() const noexcept
+    {
+        return {position()};
+    }
+    void reset(marker m)
+    {
+        m._it._chunk->pin();
+        _chunk->unpin();
+
+        _chunk = m._it._chunk;
+        _cur   = m._it._ptr;
+        _end   = _chunk->data + _chunk->size;
+        if (_cur == _end)
+            advance();
+    }
+
+    //=== SWAR ===//
+    _detail::swar_int peek_swar() const
+    {
+        constexpr auto length = _detail::swar_length<char_type>;
+#if LEXY_IS_LITTLE_ENDIAN
+        if (std::size_t(_end - _cur) >= length)
+        {
+            // Fast path: the entire SWAR is in the current chunk.
+            _detail::swar_int result;
+            std::memcpy(&result, _cur, sizeof(_detail::swar_int));
+            return result;
+        }
+#endif
+
+        // Slow path: we gather the characters one by one, which might need to read more input.
+        auto copy   = *this;
+        auto result = _detail::swar_int(0);
+        for (auto i = 0u; i != length; ++i)
+        {
+            auto c = copy.peek();
+            result |= _detail::swar_int(_detail::make_uchar(c)) << (i * _detail::char_bit_size<char_type>);
+            if (c != encoding::eof())
+                copy.bump();
+        }
+        return result;
+    }
+
+    void bump_swar()
+    {
+        bump_swar(_detail::swar_length<char_type>);
+    }
+    void bump_swar(std::size_t char_count)
+    {
+        if (std::size_t(_end - _cur) > char_count)
+        {
+            _cur += char_count;
+        }
+        else
+        {
+            for (auto i = 0u; i != char_count; ++i)
+                bump();
+        }
+    }
+
+private:
+    // Called when we've reached the end of the current chunk; moves to the next one if possible.
+    void advance()
+    {
+        if (_end == _chunk->data + _chunk->size && !_chunk->next)
+            // We've reached the end of all data read so far.
+            _chunk->owner->refill();
+
+        if (_end != _chunk->data + _chunk->size)
+        {
+            // More data has been appended to the current chunk.
+            _end = _chunk->data + _chunk->size;
+        }
+        else if (auto next = _chunk->next)
+        {
+            next->pin();
+            _chunk->unpin();
+
+            _chunk = next;
+            _cur   = next->data;
+            _end   = next->data + next->size;
+        }
+        // Otherwise, we've reached EOF.
+    }
+
+    chunk*           _chunk;
+    const char_type* _cur;
+    const char_type* _end;
+};
+
+/// An input that incrementally reads from a file descriptor.
+/// Only the input that is still referenced by a reader, marker, or iterator is kept in memory.
+template <typename Encoding = default_encoding>
+class stream_input
+{
+    static_assert(lexy::is_char_encoding<Encoding>);
+
+public:
+    using encoding  = Encoding;
+    using char_type = typename encoding::char_type;
+
+    static constexpr std::size_t default_chunk_size = std::size_t(64) * 1024;
+
+    //=== constructors ===//
+    /// Reads from the file descriptor, which must remain open while the input is used.
+    /// Data is read in chunks of the specified number of code units.
+    explicit stream_input(int fd, std::size_t chunk_size = default_chunk_size) noexcept
+    : _buffer(fd, chunk_size)
+    {}
+
+    stream_input(const stream_input&)            = delete;
+    stream_input& operator=(const stream_input&) = delete;
+
+    //=== access ===//
+    /// Whether an error occurred while reading; it is then treated as EOF.
+    bool has_error() const noexcept
+    {
+        return _buffer.has_error();
+    }
+    file_error error() const noexcept
+    {
+        LEXY_PRECONDITION(has_error());
+        return file_error::os_error;
+    }
+
+    /// The number of code units that are currently kept in memory.
+    std::size_t buffered_size() const noexcept
+    {
+        return _buffer.buffered_size();
+    }
+
+    //=== input ===//
+    /// Returns a reader at the position where the previous reader stopped.
+    auto reader() const&
+    {
+        if (_buffer.has_readers())
+        {
+            // Another reader is still in use, e.g. because we're reporting an error,
+            // so we start at the beginning.
+            auto head = _buffer.head();
+            LEXY_PRECONDITION(head->offset == 0); // The beginning has already been discarded.
+            return _sr<encoding>(head, head->data);
+        }
+
+        auto          chunk = _buffer.resume_chunk();
+        _sr<encoding> result(chunk, _buffer.resume_ptr());
+        // The reader now keeps the chunk alive.
+        _buffer.release_resume();
+        return result;
+    }
+
+private:
+    mutable _stream_buffer<encoding> _buffer;
+};
+
+//=== convenience typedefs ===//
+template <typename Encoding = default_encoding>
+using stream_lexeme = lexeme_for<stream_input<Encoding>>;
+
+template <typename Tag, typename Encoding = default_encoding>
+using stream_error = error_for<stream_input<Encoding>, Tag>;
+
+template <typename Encoding = default_encoding>
+using stream_error_context = error_context<stream_input<Encoding>>;
+} // namespace lexy
+
+#endif // LEXY_INPUT_STREAM_INPUT_HPP_INCLUDED
+
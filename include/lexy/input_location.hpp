@@ -4,6 +4,7 @@
 #ifndef LEXY_INPUT_LOCATION_HPP_INCLUDED
 #define LEXY_INPUT_LOCATION_HPP_INCLUDED
 
+#include <lexy/_detail/simd.hpp>
 #include <lexy/dsl/code_point.hpp>
 #include <lexy/dsl/newline.hpp>
 #include <lexy/input/base.hpp>
@@ -227,6 +228,34 @@ constexpr auto get_input_location(const Input&                                 i
     auto column_begin = line_begin;
     auto column_nr    = 1u;
 
+#if LEXY_HAS_SIMD_DISPATCH && LEXY_HAS_IS_CONSTANT_EVALUATED
+    using iterator = typename lexy::input_reader<Input>::iterator;
+    if constexpr (_detail::is_swar_reader<decltype(reader)> && std::is_pointer_v<iterator>
+                  && sizeof(std::remove_pointer_t<iterator>) == 1
+                  && (std::is_same_v<Counting, code_unit_location_counting>
+                      || std::is_same_v<Counting, code_point_location_counting>))
+    {
+        if (!LEXY_IS_CONSTANT_EVALUATED())
+        {
+            // Every newline ends in '\n', so we can skip all lines before the position at once:
+            // the last '\n' before it ends the previous line.
+            auto begin = reinterpret_cast<const unsigned char*>(line_begin.position());
+            auto end   = reinterpret_cast<const unsigned char*>(position);
+            if (auto count = _detail::simd_count_char(begin, end, '\n'); count > 0)
+            {
+                auto last_newline = end - 1;
+                while (*last_newline != '\n')
+                    --last_newline;
+
+                line_nr += static_cast<unsigned>(count);
+                line_begin   = {position - (end - (last_newline + 1))};
+                column_begin = line_begin;
+                reader.reset(line_begin);
+            }
+        }
+    }
+#endif
+
     Counting counting;
     while (true)
     {
@@ -0,0 +1,172 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#ifndef LEXY_EXT_GRAMMAR_REPORT_HPP_INCLUDED
+#define LEXY_EXT_GRAMMAR_REPORT_HPP_INCLUDED
+
+#include <cstdio>
+#include <lexy/grammar_analysis.hpp>
+#include <lexy/visualize.hpp>
+
+namespace lexy_ext::_detail
+{
+template <typename OutputIt>
+OutputIt write_char_set_char(OutputIt out, int c)
+{
+    if (c == '\\' || c == ']' || c == '-' || c == '^')
+    {
+        *out++ = '\\';
+        *out++ = static_cast<char>(c);
+    }
+    else if (c > ' ' && c < 0x7F)
+        *out++ = static_cast<char>(c);
+    else if (c == ' ')
+        out = lexy::_detail::write_str(out, "\\s");
+    else if (c == '\t')
+        out = lexy::_detail::write_str(out, "\\t");
+    else if (c == '\n')
+        out = lexy::_detail::write_str(out, "\\n");
+    else if (c == '\r')
+        out = lexy::_detail::write_str(out, "\\r");
+    else
+        out = lexy::_detail::write_format(out, "\\x%02X", c);
+    return out;
+}
+
+// Writes a set like a regex character class, e.g. `[+\-0-9]`.
+template <typename OutputIt>
+OutputIt write_char_set(OutputIt out, const lexy::grammar_char_set& set)
+{
+    if (!set.known)
+        return lexy::_detail::write_str(out, "<any>");
+
+    *out++ = '[';
+    for (auto c = 0; c != 256;)
+    {
+        if (!set.contains[c])
+        {
+            ++c;
+            continue;
+        }
+
+        auto end = c + 1;
+        while (end != 256 && set.contains[end])
+            ++end;
+
+        out = write_char_set_char(out, c);
+        if (end - c > 2)
+            *out++ = '-';
+        if (end - c > 1)
+            out = write_char_set_char(out, end - 1);
+        c = end;
+    }
+    *out++ = ']';
+    return out;
+}
+
+template <typename OutputIt>
+OutputIt write_branch(OutputIt out, std::size_t idx, const char* name)
+{
+    out = lexy::_detail::write_format(out, "branch %zu", idx);
+    if (name != nullptr)
+    {
+        out = lexy::_detail::write_str(out, " (");
+        out = lexy::_detail::write_str(out, name);
+        *out++ = ')';
+    }
+    return out;
+}
+
+template <typename OutputIt>
+OutputIt write_lookahead(OutputIt out, std::size_t lookahead)
+{
+    if (lookahead == lexy::grammar_hazard::npos)
+        return lexy::_detail::write_str(out, "an unbounded number of code units");
+    else
+        return lexy::_detail::write_format(out, "%zu code unit(s)", lookahead);
+}
+} // namespace lexy_ext::_detail
+
+namespace lexy_ext
+{
+/// Writes the first and follow sets of all productions reachable from `Production`,
+/// followed by all decisions that need more than one code unit of lookahead.
+template <typename Production, typename Encoding = lexy::default_encoding, typename OutputIt>
+OutputIt write_grammar_report(OutputIt out)
+{
+    using namespace lexy_ext::_detail;
+    using analysis = lexy::grammar_analysis<Production, Encoding>;
+
+    for (auto idx = std::size_t(0); idx != analysis::production_count; ++idx)
+    {
+        auto& production = analysis::production(idx);
+
+        out = lexy::_detail::write_str(out, "production ");
+        out = lexy::_detail::write_str(out, production.name);
+        out = lexy::_detail::write_str(out, "\n  first:    ");
+        out = write_char_set(out, production.first);
+        out = lexy::_detail::write_str(out, "\n  nullable: ");
+        out = lexy::_detail::write_str(out, production.nullable ? "yes" : "no");
+        out = lexy::_detail::write_str(out, "\n  follow:   ");
+        out = write_char_set(out, production.follow);
+        *out++ = '\n';
+    }
+
+    out = lexy::_detail::write_format(out, "\n%zu hazard(s)\n", analysis::hazard_count);
+    for (auto idx = std::size_t(0); idx != analysis::hazard_count; ++idx)
+    {
+        auto& hazard = analysis::hazard(idx);
+
+        out = lexy::_detail::write_str(out, "in ");
+        out = lexy::_detail::write_str(out, analysis::production(hazard.production).name);
+        out = lexy::_detail::write_format(out, ", decision %zu: ", hazard.decision);
+        switch (hazard.kind)
+        {
+        case lexy::grammar_hazard_kind::choice_overlap:
+            out = write_branch(out, hazard.branch, hazard.branch_name);
+            out = lexy::_detail::write_str(out, " overlaps ");
+            out = write_branch(out, hazard.other_branch, hazard.other_branch_name);
+            out = lexy::_detail::write_str(out, " on ");
+            out = write_char_set(out, hazard.overlap);
+            out = lexy::_detail::write_str(out, ", which reads ");
+            out = write_lookahead(out, hazard.lookahead);
+            out = lexy::_detail::write_str(out, " before it fails");
+            break;
+        case lexy::grammar_hazard_kind::choice_shadowed:
+            out = write_branch(out, hazard.branch, hazard.branch_name);
+            out = lexy::_detail::write_str(out, " is never taken, as ");
+            out = write_branch(out, hazard.other_branch, hazard.other_branch_name);
+            out = lexy::_detail::write_str(out, " matches first");
+            break;
+        case lexy::grammar_hazard_kind::choice_unknown:
+            out = write_branch(out, hazard.branch, hazard.branch_name);
+            out = lexy::_detail::write_str(out, " can start with anything, and reads ");
+            out = write_lookahead(out, hazard.lookahead);
+            out = lexy::_detail::write_str(out, " before the later branches are tried");
+            break;
+        case lexy::grammar_hazard_kind::optional_overlap:
+            out = lexy::_detail::write_str(out, "optional rule can start with ");
+            out = write_char_set(out, hazard.overlap);
+            out = lexy::_detail::write_str(out, ", which can also follow it");
+            break;
+        case lexy::grammar_hazard_kind::loop_overlap:
+            out = lexy::_detail::write_str(out, "loop can start with ");
+            out = write_char_set(out, hazard.overlap);
+            out = lexy::_detail::write_str(out, ", which can also follow it");
+            break;
+        }
+        *out++ = '\n';
+    }
+
+    return out;
+}
+
+template <typename Production, typename Encoding = lexy::default_encoding>
+void print_grammar_report(std::FILE* file = stdout)
+{
+    write_grammar_report<Production, Encoding>(lexy::cfile_output_iterator{file});
+}
+} // namespace lexy_ext
+
+#endif // LEXY_EXT_GRAMMAR_REPORT_HPP_INCLUDED
+
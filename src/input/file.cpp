@@ -4,14 +4,51 @@
 #include <cstddef>
 #include <lexy/input/file.hpp>
 
+#include <atomic>
 #include <cerrno>
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
+#include <exception>
 #include <lexy/_detail/buffer_builder.hpp>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace
+{
+// Passes a single block of memory to a `file_chunks_callback`.
+struct single_chunk
+{
+    lexy::_detail::file_chunks_callback cb;
+    void*                               user_data;
+    lexy::_detail::file_chunk           chunk;
+
+    static lexy::_detail::file_chunk next(void* _self) noexcept
+    {
+        auto self   = static_cast<single_chunk*>(_self);
+        auto result = self->chunk;
+        self->chunk = {nullptr, 0};
+        return result;
+    }
+
+    // A `file_callback` that expects a `single_chunk` as user data.
+    static void callback(void* _self, const char* memory, std::size_t size)
+    {
+        auto self   = static_cast<single_chunk*>(_self);
+        self->chunk = {memory, size};
+        self->cb(self->user_data, size, &next, self);
+    }
+};
+} // namespace
 
 #if defined(__unix__) || defined(__APPLE__)
 
 #    include <fcntl.h>
 #    include <sys/mman.h>
+#    include <sys/stat.h>
 #    include <unistd.h>
 
 namespace
@@ -59,22 +96,46 @@ lexy::file_error get_file_error() noexcept
 
 constexpr std::size_t small_file_size  = std::size_t(4) * 1024;
 constexpr std::size_t medium_file_size = std::size_t(32) * 1024;
-} // namespace
 
-lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, void* user_data)
+int get_mmap_flags(unsigned options) noexcept
 {
-    raii_fd fd(::open(path, O_RDONLY));
-    if (fd < 0)
-        return get_file_error();
+    auto flags = MAP_PRIVATE;
+#    if defined(MAP_POPULATE)
+    if ((options & lexy::_detail::file_option_populate) != 0)
+        flags |= MAP_POPULATE;
+#    else
+    (void)options;
+#    endif
+    return flags;
+}
 
+// Passes the hints to the kernel; they're just hints, so errors are ignored.
+// `memory` must be page aligned.
+void advise(void* memory, std::size_t size, unsigned options) noexcept
+{
+    if ((options & lexy::_detail::file_option_sequential) != 0)
+    {
+        ::posix_madvise(memory, size, POSIX_MADV_SEQUENTIAL);
+        ::posix_madvise(memory, size, POSIX_MADV_WILLNEED);
+    }
+#    if defined(MADV_HUGEPAGE)
+    if ((options & lexy::_detail::file_option_huge_pages) != 0)
+        ::madvise(memory, size, MADV_HUGEPAGE);
+#    endif
+}
+
+// Reads the remainder of a regular file, starting at offset `begin`.
+lexy::file_error read_regular_file(int fd, ::off_t begin, lexy::_detail::file_callback cb,
+                                   void* user_data, unsigned options = 0)
+{
     auto off = ::lseek(fd, 0, SEEK_END);
-    if (off == static_cast<::off_t>(-1))
+    if (off == static_cast<::off_t>(-1) || off < begin)
         return lexy::file_error::os_error;
-    auto size = static_cast<std::size_t>(off);
+    auto size = static_cast<std::size_t>(off - begin);
 
     if (size <= small_file_size)
     {
-        if (::lseek(fd, 0, SEEK_SET) != 0)
+        if (::lseek(fd, begin, SEEK_SET) != begin)
             return lexy::file_error::os_error;
 
         char buffer[small_file_size]; // Don't initialize.
@@ -85,7 +146,7 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
     }
     else if (size <= medium_file_size)
     {
-        if (::lseek(fd, 0, SEEK_SET) != 0)
+        if (::lseek(fd, begin, SEEK_SET) != begin)
             return lexy::file_error::os_error;
 
         lexy::buffer<>::builder builder(size);
@@ -96,20 +157,273 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
     }
     else
     {
-        auto memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // The offset of the mapping needs to be a multiple of the page size.
+        auto page_size   = static_cast<::off_t>(::sysconf(_SC_PAGESIZE));
+        auto map_begin   = begin / page_size * page_size;
+        auto skip        = static_cast<std::size_t>(begin - map_begin);
+        auto mapped_size = size + skip;
+
+        auto memory
+            = ::mmap(nullptr, mapped_size, PROT_READ, get_mmap_flags(options), fd, map_begin);
         if (memory == MAP_FAILED) // NOLINT: int-to-ptr conversion happens in header
             return lexy::file_error::os_error;
+        advise(memory, mapped_size, options);
+
+        cb(user_data, reinterpret_cast<const char*>(memory) + skip, size);
+
+        ::munmap(memory, mapped_size);
+    }
+
+    return lexy::file_error::_success;
+}
+
+// A singly-linked list of big chunks that is filled by reading from a pipe.
+// Unlike a growing buffer, filling it does not require copying data that has already been read.
+class chunk_list
+{
+public:
+    explicit chunk_list(std::size_t chunk_size) noexcept : _chunk_size(chunk_size) {}
+
+    chunk_list(const chunk_list&)            = delete;
+    chunk_list& operator=(const chunk_list&) = delete;
+
+    ~chunk_list() noexcept
+    {
+        while (_head)
+            pop_front();
+    }
+
+    // Reads everything from the file descriptor until EOF.
+    bool read_all(int fd)
+    {
+        while (true)
+        {
+            if (!_tail || _tail->size == _chunk_size)
+                push_back();
+
+            auto read = lexy::_detail::read_fd(fd, _tail->data() + _tail->size,
+                                               _chunk_size - _tail->size);
+            if (read < 0)
+                return false;
+            else if (read == 0)
+                return true;
+
+            _tail->size += static_cast<std::size_t>(read);
+            _total_size += static_cast<std::size_t>(read);
+        }
+    }
+
+    // Passes the chunks to the callback, which copies them to their final location.
+    // Each chunk is freed as soon as the callback has asked for the next one.
+    void finish(lexy::_detail::file_chunks_callback cb, void* user_data)
+    {
+        _started = false;
+        cb(user_data, _total_size, &next_chunk, this);
+    }
+
+private:
+    struct chunk
+    {
+        chunk*      next;
+        std::size_t size;
+
+        char* data() noexcept
+        {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    void push_back()
+    {
+        auto memory = ::operator new(sizeof(chunk) + _chunk_size);
+        auto c      = ::new (memory) chunk{nullptr, 0};
+        if (_tail)
+            _tail->next = c;
+        else
+            _head = c;
+        _tail = c;
+    }
+
+    void pop_front() noexcept
+    {
+        auto next = _head->next;
+        ::operator delete(_head);
+        _head = next;
+        if (!_head)
+            _tail = nullptr;
+    }
+
+    static lexy::_detail::file_chunk next_chunk(void* _self) noexcept
+    {
+        auto self = static_cast<chunk_list*>(_self);
+        // The chunk we've returned before has been copied, so we no longer need it.
+        if (self->_started && self->_head)
+            self->pop_front();
+        self->_started = true;
+
+        if (self->_head)
+            return {self->_head->data(), self->_head->size};
+        else
+            return {nullptr, 0};
+    }
+
+    chunk*      _head       = nullptr;
+    chunk*      _tail       = nullptr;
+    std::size_t _chunk_size = 0;
+    std::size_t _total_size = 0;
+    bool        _started    = false;
+};
+
+// Pipes can't give us their size, so we read them in big chunks.
+constexpr std::size_t stdin_chunk_size = std::size_t(1024) * 1024;
+} // namespace
+
+lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, void* user_data)
+{
+    raii_fd fd(::open(path, O_RDONLY));
+    if (fd < 0)
+        return get_file_error();
+
+    return read_regular_file(fd, 0, cb, user_data);
+}
+
+lexy::file_error lexy::_detail::read_file(const char* path, unsigned options, file_callback cb,
+                                          void* user_data)
+{
+    raii_fd fd(::open(path, O_RDONLY));
+    if (fd < 0)
+        return get_file_error();
+
+    return read_regular_file(fd, 0, cb, user_data, options);
+}
+
+lexy::file_error lexy::_detail::map_file(const char* path, std::size_t padding, unsigned options,
+                                         file_mapping& mapping)
+{
+    raii_fd fd(::open(path, O_RDONLY));
+    if (fd < 0)
+        return get_file_error();
+
+    auto off = ::lseek(fd, 0, SEEK_END);
+    if (off == static_cast<::off_t>(-1))
+        return lexy::file_error::os_error;
+    auto size = static_cast<std::size_t>(off);
+
+    // We first reserve enough anonymous memory for the file and the padding.
+    // The file is then mapped over the beginning of that reservation,
+    // so the padding is directly behind the file contents.
+    auto page_size   = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    auto mapped_size = (size + padding + page_size - 1) / page_size * page_size;
+    auto memory      = ::mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) // NOLINT: int-to-ptr conversion happens in header
+        return lexy::file_error::os_error;
+
+    if (size > 0)
+    {
+        // The mapping is private, so writing to the part of the last page that is past the end
+        // of the file does not change the file.
+        auto file_memory = ::mmap(memory, size, PROT_READ | PROT_WRITE,
+                                  get_mmap_flags(options) | MAP_FIXED, fd, 0);
+        if (file_memory == MAP_FAILED) // NOLINT: int-to-ptr conversion happens in header
+        {
+            ::munmap(memory, mapped_size);
+            return lexy::file_error::os_error;
+        }
+        advise(memory, size, options);
+    }
+
+    mapping.memory      = static_cast<char*>(memory);
+    mapping.size        = size;
+    mapping.mapped_size = mapped_size;
+    return lexy::file_error::_success;
+}
+
+void lexy::_detail::unmap_file(const file_mapping& mapping) noexcept
+{
+    ::munmap(mapping.memory, mapping.mapped_size);
+}
+
+void lexy::_detail::advise_memory(const void* memory, std::size_t size, unsigned options) noexcept
+{
+#    if defined(MADV_HUGEPAGE)
+    if ((options & file_option_huge_pages) == 0)
+        return;
+
+    // We can only advise entire pages.
+    auto page_size = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    auto begin     = (reinterpret_cast<std::uintptr_t>(memory) + page_size - 1) & ~(page_size - 1);
+    auto end       = (reinterpret_cast<std::uintptr_t>(memory) + size) & ~(page_size - 1);
+    if (begin >= end)
+        return;
+
+    ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#    else
+    (void)memory;
+    (void)size;
+    (void)options;
+#    endif
+}
+
+std::ptrdiff_t lexy::_detail::read_fd(int fd, void* buffer, std::size_t size) noexcept
+{
+    while (true)
+    {
+        auto result = ::read(fd, buffer, size);
+        if (result >= 0 || errno != EINTR)
+            return result;
+    }
+}
+
+lexy::file_error lexy::_detail::read_stdin(file_chunks_callback cb, void* user_data)
+{
+    // We bypass the C I/O routines and read from the file descriptor directly.
+    auto fd = STDIN_FILENO;
+
+    struct ::stat info;
+    if (::fstat(fd, &info) != 0)
+        return lexy::file_error::os_error;
+
+    if (S_ISREG(info.st_mode))
+    {
+        // stdin has been redirected from a file, so we can read it like one.
+        // We need to start at the current position, in case something has already been read.
+        auto begin = ::lseek(fd, 0, SEEK_CUR);
+        if (begin == static_cast<::off_t>(-1))
+            return lexy::file_error::os_error;
 
-        cb(user_data, reinterpret_cast<const char*>(memory), size);
+        single_chunk data{cb, user_data, {nullptr, 0}};
+        auto         result = read_regular_file(fd, begin, &single_chunk::callback, &data);
+        // We've consumed everything.
+        ::lseek(fd, 0, SEEK_END);
+        return result;
+    }
 
-        ::munmap(memory, size);
+    auto chunk_size = stdin_chunk_size;
+#    if defined(F_GETPIPE_SZ)
+    // Make the chunk size a multiple of the pipe size, so each read() can fill it completely.
+    auto pipe_size = ::fcntl(fd, F_GETPIPE_SZ);
+    if (pipe_size > 0)
+    {
+        auto unit  = static_cast<std::size_t>(pipe_size);
+        chunk_size = (chunk_size + unit - 1) / unit * unit;
     }
+#    endif
+
+    chunk_list chunks(chunk_size);
+    if (!chunks.read_all(fd))
+        return lexy::file_error::os_error;
 
+    chunks.finish(cb, user_data);
     return lexy::file_error::_success;
 }
 
 #else // portable read_file() using C I/O
 
+#    if defined(_WIN32)
+#        include <io.h>
+#    endif
+
 namespace
 {
 class raii_file
@@ -184,11 +498,67 @@ lexy::file_error lexy::_detail::read_file(const char* path, file_callback cb, vo
     return file_error::_success;
 }
 
-#endif
+lexy::file_error lexy::_detail::read_file(const char* path, unsigned, file_callback cb,
+                                          void* user_data)
+{
+    // We don't have any way of passing the hints.
+    return read_file(path, cb, user_data);
+}
 
-// When reading from stdin, performance doesn't really matter.
-// As such, we use the simple portable way of the C I/O routines.
-lexy::file_error lexy::_detail::read_stdin(file_callback cb, void* user_data)
+lexy::file_error lexy::_detail::map_file(const char* path, std::size_t padding, unsigned,
+                                         file_mapping& mapping)
+{
+    // We can't map the file, so we just read it into memory that has the necessary padding.
+    raii_file file(std::fopen(path, "rb"));
+    if (!file)
+        return get_file_error();
+
+    if (std::fseek(file, 0, SEEK_END) != 0)
+        return lexy::file_error::os_error;
+
+    auto size = std::ftell(file);
+    if (size == -1)
+        return lexy::file_error::os_error;
+
+    if (std::fseek(file, 0, SEEK_SET) != 0)
+        return lexy::file_error::os_error;
+
+    auto mapped_size = std::size_t(size) + padding;
+    auto memory      = static_cast<char*>(::operator new(mapped_size));
+    if (std::fread(memory, sizeof(char), std::size_t(size), file) != std::size_t(size))
+    {
+        ::operator delete(memory);
+        return lexy::file_error::os_error;
+    }
+    std::memset(memory + size, 0, padding);
+
+    mapping.memory      = memory;
+    mapping.size        = std::size_t(size);
+    mapping.mapped_size = mapped_size;
+    return lexy::file_error::_success;
+}
+
+void lexy::_detail::unmap_file(const file_mapping& mapping) noexcept
+{
+    ::operator delete(mapping.memory);
+}
+
+void lexy::_detail::advise_memory(const void*, std::size_t, unsigned) noexcept {}
+
+std::ptrdiff_t lexy::_detail::read_fd(int fd, void* buffer, std::size_t size) noexcept
+{
+#    if defined(_WIN32)
+    return ::_read(fd, buffer, static_cast<unsigned>(size));
+#    else
+    // We don't know how to read from a file descriptor.
+    (void)fd;
+    (void)buffer;
+    (void)size;
+    return -1;
+#    endif
+}
+
+lexy::file_error lexy::_detail::read_stdin(file_chunks_callback cb, void* user_data)
 {
     // We can't use ftell() to get file size
     // So instead use a conservative loop.
@@ -222,7 +592,150 @@ lexy::file_error lexy::_detail::read_stdin(file_callback cb, void* user_data)
     }
 
     // Pass final buffer to callback.
-    cb(user_data, builder.read_data(), builder.read_size());
+    single_chunk data{cb, user_data, {nullptr, 0}};
+    single_chunk::callback(&data, builder.read_data(), builder.read_size());
     return file_error::_success;
 }
 
+#endif
+
+lexy::file_error lexy::_detail::read_stdin(file_callback cb, void* user_data)
+{
+    struct callback_data
+    {
+        file_callback cb;
+        void*         user_data;
+    } data{cb, user_data};
+    auto contiguous = [](void* _data, std::size_t total_size, file_chunk_reader next,
+                         void* chunks) {
+        auto data = static_cast<callback_data*>(_data);
+
+        auto chunk = next(chunks);
+        if (chunk.size > 0 && chunk.size == total_size)
+        {
+            // Everything is already in a single block.
+            data->cb(data->user_data, chunk.memory, chunk.size);
+            return;
+        }
+
+        lexy::buffer<>::builder builder(total_size);
+        auto                    dest = builder.data();
+        for (; chunk.size > 0; chunk = next(chunks))
+        {
+            std::memcpy(dest, chunk.memory, chunk.size);
+            dest += chunk.size;
+        }
+        data->cb(data->user_data, builder.data(), builder.size());
+    };
+
+    return read_stdin(contiguous, &data);
+}
+
+namespace
+{
+class file_batch
+{
+public:
+    explicit file_batch(const char* const* paths, std::size_t count,
+                        lexy::_detail::file_batch_callback cb, void* user_data) noexcept
+    : _paths(paths), _count(count), _cb(cb), _user_data(user_data), _next(0)
+    {}
+
+    // Reads files until there are none left.
+    void work() noexcept
+    {
+        while (true)
+        {
+            auto index = _next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= _count)
+                break;
+
+            try
+            {
+                read(index);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_exception)
+                    _exception = std::current_exception();
+
+                // Stop all other threads as well.
+                _next.store(_count, std::memory_order_relaxed);
+                break;
+            }
+        }
+    }
+
+    void rethrow_exception() const
+    {
+        if (_exception)
+            std::rethrow_exception(_exception);
+    }
+
+private:
+    struct user_data
+    {
+        file_batch* self;
+        std::size_t index;
+    };
+
+    void read(std::size_t index)
+    {
+        user_data data{this, index};
+        auto      cb = [](void* _data, const char* memory, std::size_t size) {
+            auto data = static_cast<user_data*>(_data);
+            data->self->_cb(data->self->_user_data, data->index, lexy::file_error::_success,
+                            memory, size);
+        };
+
+        auto ec = lexy::_detail::read_file(_paths[index], cb, &data);
+        if (ec != lexy::file_error::_success)
+            _cb(_user_data, index, ec, nullptr, 0);
+    }
+
+    const char* const*                 _paths;
+    std::size_t                        _count;
+    lexy::_detail::file_batch_callback _cb;
+    void*                              _user_data;
+
+    std::atomic<std::size_t> _next;
+    std::mutex               _mutex;
+    std::exception_ptr       _exception;
+};
+} // namespace
+
+void lexy::_detail::read_files(const char* const* paths, std::size_t count,
+                               std::size_t thread_count, file_batch_callback cb, void* user_data)
+{
+    if (thread_count == 0)
+        thread_count = std::thread::hardware_concurrency();
+    if (thread_count > count)
+        thread_count = count;
+
+    file_batch batch(paths, count, cb, user_data);
+
+    // The calling thread is one of the workers.
+    std::vector<std::thread> workers;
+    if (thread_count > 1)
+    {
+        workers.reserve(thread_count - 1);
+        for (auto i = std::size_t(1); i != thread_count; ++i)
+        {
+            try
+            {
+                workers.emplace_back([&batch] { batch.work(); });
+            }
+            catch (const std::system_error&)
+            {
+                // We can't create more threads, so just use the ones we already have.
+                break;
+            }
+        }
+    }
+    batch.work();
+
+    for (auto& worker : workers)
+        worker.join();
+    batch.rethrow_exception();
+}
@@ -0,0 +1,540 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <cstddef>
+#include <lexy/input/file.hpp>
+
+#include <cerrno>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__) && defined(__has_include)
+#    if __has_include(<linux/io_uring.h>)
+#        define LEXY_HAS_IO_URING 1
+#    endif
+#endif
+
+#ifdef LEXY_HAS_IO_URING
+
+#    include <fcntl.h>
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+
+namespace
+{
+lexy::file_error get_file_error(int error) noexcept
+{
+    switch (error)
+    {
+    case ENOENT:
+    case ENOTDIR:
+    case ELOOP:
+        return lexy::file_error::file_not_found;
+
+    case EACCES:
+    case EPERM:
+        return lexy::file_error::permission_denied;
+
+    default:
+        return lexy::file_error::os_error;
+    }
+}
+
+// A minimal io_uring instance that talks to the kernel directly, so we don't need liburing.
+class io_uring_queue
+{
+public:
+    io_uring_queue() noexcept = default;
+
+    io_uring_queue(const io_uring_queue&)            = delete;
+    io_uring_queue& operator=(const io_uring_queue&) = delete;
+
+    ~io_uring_queue() noexcept
+    {
+        if (_sqes != nullptr)
+            ::munmap(_sqes, _sqes_size);
+        if (_cq_ring != nullptr && _cq_ring != _sq_ring)
+            ::munmap(_cq_ring, _cq_ring_size);
+        if (_sq_ring != nullptr)
+            ::munmap(_sq_ring, _sq_ring_size);
+        if (_fd >= 0)
+            ::close(_fd);
+    }
+
+    // Returns false if io_uring or one of the operations we need is not available.
+    bool init(unsigned entries) noexcept
+    {
+        io_uring_params params{};
+        _fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+        if (_fd < 0)
+            return false;
+
+        if (!supports_operations())
+            return false;
+
+        _sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        _cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+        {
+            if (_cq_ring_size > _sq_ring_size)
+                _sq_ring_size = _cq_ring_size;
+            _cq_ring_size = _sq_ring_size;
+        }
+
+        _sq_ring = map(_sq_ring_size, IORING_OFF_SQ_RING);
+        if (_sq_ring == nullptr)
+            return false;
+
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+            _cq_ring = _sq_ring;
+        else
+        {
+            _cq_ring = map(_cq_ring_size, IORING_OFF_CQ_RING);
+            if (_cq_ring == nullptr)
+                return false;
+        }
+
+        _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        _sqes      = static_cast<io_uring_sqe*>(map(_sqes_size, IORING_OFF_SQES));
+        if (_sqes == nullptr)
+            return false;
+
+        _sq_tail  = ring_ptr(_sq_ring, params.sq_off.tail);
+        _sq_mask  = *ring_ptr(_sq_ring, params.sq_off.ring_mask);
+        _sq_array = ring_ptr(_sq_ring, params.sq_off.array);
+
+        _cq_head = ring_ptr(_cq_ring, params.cq_off.head);
+        _cq_tail = ring_ptr(_cq_ring, params.cq_off.tail);
+        _cq_mask = *ring_ptr(_cq_ring, params.cq_off.ring_mask);
+        _cqes    = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(_cq_ring)
+                                                   + params.cq_off.cqes);
+
+        return true;
+    }
+
+    // Returns a zeroed submission queue entry that will be submitted by the next `wait()`.
+    // The caller must ensure that there are never more pending operations than entries.
+    io_uring_sqe* next_sqe() noexcept
+    {
+        auto tail       = *_sq_tail + _unpublished;
+        auto idx        = tail & _sq_mask;
+        _sq_array[idx]  = idx;
+        auto sqe        = &_sqes[idx];
+        *sqe            = io_uring_sqe{};
+        ++_unpublished;
+        return sqe;
+    }
+
+    // Submits all new entries and waits until an operation has completed.
+    // It might also return early without a completion, e.g. if the kernel didn't accept all
+    // entries; the remaining ones are then submitted by the next call.
+    // Returns false if io_uring_enter() failed for good; errno is set accordingly.
+    bool wait() noexcept
+    {
+        __atomic_store_n(_sq_tail, *_sq_tail + _unpublished, __ATOMIC_RELEASE);
+        _unsubmitted += _unpublished;
+        _unpublished = 0;
+
+        while (true)
+        {
+            auto result = ::syscall(__NR_io_uring_enter, _fd, _unsubmitted, 1u,
+                                    IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (result >= 0)
+            {
+                _unsubmitted -= static_cast<unsigned>(result);
+                return true;
+            }
+            else if (errno == EAGAIN || errno == EBUSY)
+                // The kernel is temporarily out of resources; the caller needs to process the
+                // completions that have already arrived before we try again.
+                return true;
+            else if (errno != EINTR)
+                return false;
+        }
+    }
+
+    // Invokes `f(user_data, res)` for every completed operation.
+    template <typename Fn>
+    void for_each_completion(Fn f)
+    {
+        auto head = *_cq_head;
+        auto tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            auto& cqe = _cqes[head & _cq_mask];
+            auto  ud  = cqe.user_data;
+            auto  res = cqe.res;
+
+            ++head;
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+
+            f(ud, res);
+        }
+    }
+
+private:
+    bool supports_operations() noexcept
+    {
+        constexpr auto op_count    = 256u;
+        constexpr auto probe_size  = sizeof(io_uring_probe) + op_count * sizeof(io_uring_probe_op);
+        alignas(io_uring_probe) char memory[probe_size] = {};
+
+        auto probe = reinterpret_cast<io_uring_probe*>(memory);
+        if (::syscall(__NR_io_uring_register, _fd, IORING_REGISTER_PROBE, probe, op_count) < 0)
+            return false;
+
+        auto supports = [&](unsigned op) {
+            return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+        };
+        return supports(IORING_OP_OPENAT) && supports(IORING_OP_STATX)
+               && supports(IORING_OP_READ);
+    }
+
+    void* map(std::size_t size, unsigned long long offset) noexcept
+    {
+        auto memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                             _fd, static_cast<::off_t>(offset));
+        if (memory == MAP_FAILED) // NOLINT: int-to-ptr conversion happens in header
+            return nullptr;
+        return memory;
+    }
+
+    static unsigned* ring_ptr(void* ring, unsigned offset) noexcept
+    {
+        return reinterpret_cast<unsigned*>(static_cast<char*>(ring) + offset);
+    }
+
+    int         _fd = -1;
+    void*       _sq_ring = nullptr;
+    void*       _cq_ring = nullptr;
+    std::size_t _sq_ring_size = 0, _cq_ring_size = 0, _sqes_size = 0;
+
+    io_uring_sqe* _sqes     = nullptr;
+    unsigned*     _sq_tail  = nullptr;
+    unsigned*     _sq_array = nullptr;
+    unsigned      _sq_mask  = 0;
+    unsigned      _unpublished = 0; // Entries that haven't been added to the tail yet.
+    unsigned      _unsubmitted = 0; // Entries the kernel hasn't consumed yet.
+
+    io_uring_cqe* _cqes    = nullptr;
+    unsigned*     _cq_head = nullptr;
+    unsigned*     _cq_tail = nullptr;
+    unsigned      _cq_mask = 0;
+};
+
+// Reads a batch of files, keeping up to `queue_depth` of them in flight.
+// Each file goes through openat -> statx -> read (repeated for short reads).
+class async_file_batch
+{
+public:
+    explicit async_file_batch(io_uring_queue& queue, const char* const* paths, std::size_t count,
+                              lexy::_detail::file_batch_callback cb, void* user_data) noexcept
+    : _queue(&queue), _paths(paths), _count(count), _cb(cb), _user_data(user_data)
+    {}
+
+    async_file_batch(const async_file_batch&)            = delete;
+    async_file_batch& operator=(const async_file_batch&) = delete;
+
+    ~async_file_batch() noexcept
+    {
+        delete[] _slots;
+    }
+
+    void run(std::size_t queue_depth)
+    {
+        _slots      = new slot[queue_depth];
+        _slot_count = queue_depth;
+        for (auto i = std::size_t(0); i != queue_depth; ++i)
+            _slots[i].current = stage::idle;
+        for (auto i = std::size_t(0); i != queue_depth && _next != _count; ++i)
+            start(_slots[i], _next++);
+
+        try
+        {
+            while (_in_flight > 0)
+            {
+                if (!_queue->wait())
+                    return abandon();
+
+                _queue->for_each_completion([&](std::uint64_t user_data, int res) {
+                    complete(*reinterpret_cast<slot*>(user_data), res);
+                });
+            }
+        }
+        catch (...)
+        {
+            // The kernel might still write into our buffers, so wait for everything to finish.
+            _next = _count;
+            while (_in_flight > 0)
+            {
+                if (!_queue->wait())
+                {
+                    leak_slots();
+                    break;
+                }
+
+                _queue->for_each_completion([&](std::uint64_t user_data, int res) {
+                    auto& s = *reinterpret_cast<slot*>(user_data);
+                    --_in_flight;
+                    if (s.current == stage::open && res >= 0)
+                        s.fd = res;
+                    release(s);
+                });
+            }
+            throw;
+        }
+    }
+
+private:
+    enum class stage
+    {
+        idle,
+        open,
+        stat,
+        read,
+    };
+
+    // Reads are split into parts of at most this size, as the length of a read is 32 bit.
+    static constexpr std::size_t max_read_size = std::size_t(1) << 30;
+
+    struct slot
+    {
+        std::size_t  index;
+        stage        current;
+        int          fd;
+        char*        memory;
+        std::size_t  size, read;
+        struct statx info;
+    };
+
+    void start(slot& s, std::size_t index) noexcept
+    {
+        s.index  = index;
+        s.current = stage::open;
+        s.fd     = -1;
+        s.memory = nullptr;
+        s.size   = 0;
+        s.read   = 0;
+
+        auto sqe         = _queue->next_sqe();
+        sqe->opcode      = IORING_OP_OPENAT;
+        sqe->fd          = AT_FDCWD;
+        sqe->addr        = reinterpret_cast<std::uint64_t>(_paths[index]);
+        sqe->open_flags  = O_RDONLY | O_CLOEXEC;
+        sqe->user_data   = reinterpret_cast<std::uint64_t>(&s);
+        ++_in_flight;
+    }
+
+    void submit_stat(slot& s) noexcept
+    {
+        s.current        = stage::stat;
+        auto sqe         = _queue->next_sqe();
+        sqe->opcode      = IORING_OP_STATX;
+        sqe->fd          = s.fd;
+        sqe->addr        = reinterpret_cast<std::uint64_t>("");
+        sqe->len         = STATX_SIZE;
+        sqe->statx_flags = AT_EMPTY_PATH;
+        sqe->off         = reinterpret_cast<std::uint64_t>(&s.info);
+        sqe->user_data   = reinterpret_cast<std::uint64_t>(&s);
+        ++_in_flight;
+    }
+
+    void submit_read(slot& s) noexcept
+    {
+        s.current      = stage::read;
+        auto sqe       = _queue->next_sqe();
+        sqe->opcode    = IORING_OP_READ;
+        sqe->fd        = s.fd;
+        sqe->addr      = reinterpret_cast<std::uint64_t>(s.memory + s.read);
+        sqe->len       = static_cast<unsigned>(
+            s.size - s.read < max_read_size ? s.size - s.read : max_read_size);
+        sqe->off       = s.read;
+        sqe->user_data = reinterpret_cast<std::uint64_t>(&s);
+        ++_in_flight;
+    }
+
+    // Handles the completion of an operation of the slot.
+    void complete(slot& s, int res)
+    {
+        --_in_flight;
+        switch (s.current)
+        {
+        case stage::idle:
+            LEXY_ASSERT(false, "completion for a slot without an operation");
+            break;
+
+        case stage::open:
+            if (res < 0)
+                return fail(s, get_file_error(-res));
+
+            s.fd = res;
+            submit_stat(s);
+            break;
+
+        case stage::stat:
+            if (res < 0)
+                return fail(s, lexy::file_error::os_error);
+
+            s.size   = static_cast<std::size_t>(s.info.stx_size);
+            s.memory = static_cast<char*>(::operator new(s.size == 0 ? 1 : s.size, std::nothrow));
+            if (s.memory == nullptr)
+            {
+                // Close the file before we report the error.
+                _next = _count;
+                release(s);
+                throw std::bad_alloc();
+            }
+            else if (s.size == 0)
+                return succeed(s);
+
+            submit_read(s);
+            break;
+
+        case stage::read:
+            if (res == -EINTR || res == -EAGAIN)
+                return submit_read(s);
+            else if (res < 0)
+                return fail(s, lexy::file_error::os_error);
+            else if (res == 0)
+            {
+                // The file has been truncated since we've checked its size.
+                s.size = s.read;
+                return succeed(s);
+            }
+
+            s.read += static_cast<std::size_t>(res);
+            if (s.read == s.size)
+                return succeed(s);
+
+            // A short read or a big file, read the rest.
+            submit_read(s);
+            break;
+        }
+    }
+
+    void succeed(slot& s)
+    {
+        finish(s, [&] { _cb(_user_data, s.index, lexy::file_error::_success, s.memory, s.size); });
+    }
+    void fail(slot& s, lexy::file_error ec)
+    {
+        finish(s, [&] { _cb(_user_data, s.index, ec, nullptr, 0); });
+    }
+
+    // Invokes the callback and then releases the slot, even if the callback throws.
+    template <typename Fn>
+    void finish(slot& s, Fn callback)
+    {
+        struct guard
+        {
+            async_file_batch* self;
+            slot*             s;
+
+            ~guard() noexcept
+            {
+                self->release(*s);
+            }
+        } g{this, &s};
+
+        callback();
+    }
+
+    // Releases the resources of the slot and reuses it for the next file.
+    void release(slot& s) noexcept
+    {
+        if (s.fd >= 0)
+            ::close(s.fd);
+        ::operator delete(s.memory);
+        s.fd     = -1;
+        s.memory = nullptr;
+
+        if (_next != _count)
+            start(s, _next++);
+        else
+            s.current = stage::idle;
+    }
+
+    // Called when we can no longer submit or wait for operations;
+    // reports an error for every file that hasn't been read yet.
+    void abandon()
+    {
+        auto slots = _slots;
+        leak_slots();
+
+        for (auto i = std::size_t(0); i != _slot_count; ++i)
+            if (slots[i].current != stage::idle)
+                _cb(_user_data, slots[i].index, lexy::file_error::os_error, nullptr, 0);
+        while (_next != _count)
+            _cb(_user_data, _next++, lexy::file_error::os_error, nullptr, 0);
+    }
+
+    // The kernel might still complete the operations in flight and write into the slots and
+    // their buffers, so we must not free them.
+    void leak_slots() noexcept
+    {
+        _slots     = nullptr;
+        _in_flight = 0;
+    }
+
+    io_uring_queue*                    _queue;
+    const char* const*                 _paths;
+    std::size_t                        _count;
+    lexy::_detail::file_batch_callback _cb;
+    void*                              _user_data;
+
+    slot*       _slots      = nullptr;
+    std::size_t _slot_count = 0;
+    std::size_t _next       = 0;
+    std::size_t _in_flight = 0;
+};
+} // namespace
+
+bool lexy::_detail::has_async_file_io() noexcept
+{
+    io_uring_queue queue;
+    return queue.init(1);
+}
+
+void lexy::_detail::read_files_async(const char* const* paths, std::size_t count,
+                                     std::size_t queue_depth, file_batch_callback cb,
+                                     void* user_data)
+{
+    if (queue_depth == 0)
+        queue_depth = 64;
+    if (queue_depth > count)
+        queue_depth = count;
+
+    if (queue_depth > 0)
+    {
+        io_uring_queue queue;
+        // Every file has at most one operation in flight.
+        if (queue.init(static_cast<unsigned>(queue_depth)))
+        {
+            async_file_batch batch(queue, paths, count, cb, user_data);
+            batch.run(queue_depth);
+            return;
+        }
+    }
+
+    // io_uring is not available, read them synchronously instead.
+    read_files(paths, count, 1, cb, user_data);
+}
+
+#else
+
+bool lexy::_detail::has_async_file_io() noexcept
+{
+    return false;
+}
+
+void lexy::_detail::read_files_async(const char* const* paths, std::size_t count, std::size_t,
+                                     file_batch_callback cb, void* user_data)
+{
+    // We don't have asynchronous I/O, read them synchronously instead.
+    read_files(paths, count, 1, cb, user_data);
+}
+
+#endif
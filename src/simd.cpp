@@ -0,0 +1,372 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/_detail/simd.hpp>
+#include <lexy/_detail/swar.hpp>
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+// We compile the kernels for every instruction set, independent of the flags of this file,
+// and select one at runtime.
+#if LEXY_IS_X86
+#    define LEXY_SIMD_X86 1
+#    include <immintrin.h>
+#    if defined(__GNUC__)
+#        define LEXY_SIMD_TARGET(Name) __attribute__((target(Name)))
+#    else
+#        define LEXY_SIMD_TARGET(Name)
+#    endif
+#else
+#    define LEXY_SIMD_X86 0
+#endif
+
+namespace
+{
+using lexy::_detail::simd_char_table;
+using uchar = unsigned char;
+
+//=== CPU detection ===//
+enum class cpu_level
+{
+    swar,
+    sse2,
+    ssse3,
+    avx2,
+};
+
+cpu_level detect_cpu_level() noexcept
+{
+#if LEXY_SIMD_X86
+#    if defined(__GNUC__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return cpu_level::avx2;
+    else if (__builtin_cpu_supports("ssse3"))
+        return cpu_level::ssse3;
+    else if (__builtin_cpu_supports("sse2"))
+        return cpu_level::sse2;
+#    elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    auto max_leaf = info[0];
+
+    __cpuid(info, 1);
+    auto has_sse2  = (info[3] >> 26) & 1;
+    auto has_ssse3 = (info[2] >> 9) & 1;
+    // AVX2 also requires that the OS saves the YMM registers.
+    auto has_ymm = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && (_xgetbv(0) & 0x6) == 0x6;
+    if (max_leaf >= 7 && has_ymm)
+    {
+        __cpuidex(info, 7, 0);
+        if ((info[1] >> 5) & 1)
+            return cpu_level::avx2;
+    }
+    if (has_ssse3)
+        return cpu_level::ssse3;
+    else if (has_sse2)
+        return cpu_level::sse2;
+#    endif
+#endif
+    return cpu_level::swar;
+}
+
+// The instruction set of the kernels: the best one of the CPU,
+// unless the `LEXY_SIMD` environment variable asks for a worse one.
+cpu_level kernel_level() noexcept
+{
+    static const auto level = [] {
+        auto result = detect_cpu_level();
+        if (auto env = std::getenv("LEXY_SIMD"))
+        {
+            auto requested = result;
+            if (std::strcmp(env, "swar") == 0)
+                requested = cpu_level::swar;
+            else if (std::strcmp(env, "sse2") == 0)
+                requested = cpu_level::sse2;
+            else if (std::strcmp(env, "ssse3") == 0)
+                requested = cpu_level::ssse3;
+
+            if (requested < result)
+                result = requested;
+        }
+        return result;
+    }();
+    return level;
+}
+
+#if LEXY_SIMD_X86
+unsigned find_first_set(std::uint32_t mask) noexcept
+{
+#    if defined(__GNUC__)
+    return unsigned(__builtin_ctz(mask));
+#    elif defined(_MSC_VER)
+    unsigned long bit_idx;
+    _BitScanForward(&bit_idx, mask);
+    return unsigned(bit_idx);
+#    endif
+}
+#endif
+
+//=== find_class_end ===//
+const uchar* find_class_end_swar(const uchar* ptr, const simd_char_table& table) noexcept
+{
+    // A char class can only be checked with SWAR if it's known at compile-time.
+    while (table.lo[*ptr & 0xF] & table.hi[*ptr >> 4])
+        ++ptr;
+    return ptr;
+}
+
+#if LEXY_SIMD_X86
+LEXY_SIMD_TARGET("ssse3")
+const uchar* find_class_end_ssse3(const uchar* ptr, const simd_char_table& table) noexcept
+{
+    auto lo_table    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo));
+    auto hi_table    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi));
+    auto nibble_mask = _mm_set1_epi8(0x0F);
+
+    while (true)
+    {
+        auto v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        auto lo = _mm_and_si128(v, nibble_mask);
+        auto hi = _mm_and_si128(_mm_srli_epi16(v, 4), nibble_mask);
+
+        auto bits = _mm_and_si128(_mm_shuffle_epi8(lo_table, lo), _mm_shuffle_epi8(hi_table, hi));
+        auto mismatch
+            = std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(bits, _mm_setzero_si128())));
+        if (mismatch != 0)
+            return ptr + find_first_set(mismatch);
+
+        ptr += 16;
+    }
+}
+
+LEXY_SIMD_TARGET("avx2")
+const uchar* find_class_end_avx2(const uchar* ptr, const simd_char_table& table) noexcept
+{
+    // The shuffle works on each 128 bit lane separately, so we need the table in both.
+    auto lo_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.lo)));
+    auto hi_table = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(table.hi)));
+    auto nibble_mask = _mm256_set1_epi8(0x0F);
+
+    while (true)
+    {
+        auto v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        auto lo = _mm256_and_si256(v, nibble_mask);
+        auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble_mask);
+
+        auto bits     = _mm256_and_si256(_mm256_shuffle_epi8(lo_table, lo),
+                                         _mm256_shuffle_epi8(hi_table, hi));
+        auto mismatch = std::uint32_t(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(bits, _mm256_setzero_si256())));
+        if (mismatch != 0)
+            return ptr + find_first_set(mismatch);
+
+        ptr += 32;
+    }
+}
+#endif
+
+//=== find_either ===//
+const uchar* find_either_swar(const uchar* ptr, uchar a, uchar b) noexcept
+{
+    using namespace lexy::_detail;
+
+    auto a_mask = swar_fill(a);
+    auto b_mask = swar_fill(b);
+    while (true)
+    {
+        auto cur = swar_load(ptr);
+        if (swar_has_zero<uchar>(cur ^ a_mask) || swar_has_zero<uchar>(cur ^ b_mask))
+            break;
+        ptr += swar_length<uchar>;
+    }
+
+    while (*ptr != a && *ptr != b)
+        ++ptr;
+    return ptr;
+}
+
+#if LEXY_SIMD_X86
+LEXY_SIMD_TARGET("sse2")
+const uchar* find_either_sse2(const uchar* ptr, uchar a, uchar b) noexcept
+{
+    auto a_vec = _mm_set1_epi8(static_cast<char>(a));
+    auto b_vec = _mm_set1_epi8(static_cast<char>(b));
+    while (true)
+    {
+        auto v     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+        auto match = _mm_or_si128(_mm_cmpeq_epi8(v, a_vec), _mm_cmpeq_epi8(v, b_vec));
+        if (auto mask = std::uint32_t(_mm_movemask_epi8(match)))
+            return ptr + find_first_set(mask);
+
+        ptr += 16;
+    }
+}
+
+LEXY_SIMD_TARGET("avx2")
+const uchar* find_either_avx2(const uchar* ptr, uchar a, uchar b) noexcept
+{
+    auto a_vec = _mm256_set1_epi8(static_cast<char>(a));
+    auto b_vec = _mm256_set1_epi8(static_cast<char>(b));
+    while (true)
+    {
+        auto v     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+        auto match = _mm256_or_si256(_mm256_cmpeq_epi8(v, a_vec), _mm256_cmpeq_epi8(v, b_vec));
+        if (auto mask = std::uint32_t(_mm256_movemask_epi8(match)))
+            return ptr + find_first_set(mask);
+
+        ptr += 32;
+    }
+}
+#endif
+
+//=== count_char ===//
+std::size_t count_char_swar(const uchar* begin, const uchar* end, uchar c) noexcept
+{
+    using namespace lexy::_detail;
+
+    auto result = std::size_t(0);
+
+    auto c_mask    = swar_fill(c);
+    auto low_mask  = swar_fill(uchar(0x7F));
+    auto high_mask = swar_fill(uchar(0x80));
+    for (; end - begin >= std::ptrdiff_t(swar_length<uchar>); begin += swar_length<uchar>)
+    {
+        auto cur = swar_load(begin) ^ c_mask;
+        // The high bit of each char is set if the char is non-zero; we then count the others.
+        auto non_zero = ((cur & low_mask) + low_mask) | cur;
+        result += std::bitset<64>(~non_zero & high_mask).count();
+    }
+
+    for (; begin != end; ++begin)
+        if (*begin == c)
+            ++result;
+    return result;
+}
+
+#if LEXY_SIMD_X86
+LEXY_SIMD_TARGET("sse2")
+std::size_t count_char_sse2(const uchar* begin, const uchar* end, uchar c) noexcept
+{
+    auto result = std::size_t(0);
+
+    auto c_vec = _mm_set1_epi8(static_cast<char>(c));
+    for (; end - begin >= 16; begin += 16)
+    {
+        auto v    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        auto mask = std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, c_vec)));
+        result += std::bitset<32>(mask).count();
+    }
+
+    return result + count_char_swar(begin, end, c);
+}
+
+LEXY_SIMD_TARGET("avx2")
+std::size_t count_char_avx2(const uchar* begin, const uchar* end, uchar c) noexcept
+{
+    auto result = std::size_t(0);
+
+    auto c_vec = _mm256_set1_epi8(static_cast<char>(c));
+    for (; end - begin >= 32; begin += 32)
+    {
+        auto v    = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        auto mask = std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, c_vec)));
+        result += std::bitset<32>(mask).count();
+    }
+
+    return result + count_char_swar(begin, end, c);
+}
+#endif
+
+//=== dispatch ===//
+// Each kernel starts out with a function that selects the implementation, remembers it, and
+// forwards to it. All later calls then go to the implementation directly.
+template <typename Fn>
+Fn* select_kernel([[maybe_unused]] Fn* swar, [[maybe_unused]] Fn* sse2,
+                  [[maybe_unused]] Fn* ssse3, [[maybe_unused]] Fn* avx2) noexcept
+{
+#if LEXY_SIMD_X86
+    switch (kernel_level())
+    {
+    case cpu_level::avx2:
+        return avx2;
+    case cpu_level::ssse3:
+        return ssse3;
+    case cpu_level::sse2:
+        return sse2;
+    case cpu_level::swar:
+        break;
+    }
+#endif
+    return swar;
+}
+
+#if LEXY_SIMD_X86
+#    define LEXY_SIMD_KERNELS(Name)                                                               \
+        Name##_swar, Name##_sse2, Name##_ssse3, Name##_avx2
+// There is no SSE2 shuffle, so we can't use it for char classes.
+constexpr auto find_class_end_sse2 = find_class_end_swar;
+// The SSSE3 versions would be identical to the SSE2 ones.
+constexpr auto find_either_ssse3 = find_either_sse2;
+constexpr auto count_char_ssse3  = count_char_sse2;
+#else
+#    define LEXY_SIMD_KERNELS(Name) Name##_swar, Name##_swar, Name##_swar, Name##_swar
+#endif
+
+using find_class_end_fn = decltype(find_class_end_swar);
+const uchar* find_class_end_select(const uchar* ptr, const simd_char_table& table) noexcept;
+std::atomic<find_class_end_fn*> find_class_end_impl(&find_class_end_select);
+
+const uchar* find_class_end_select(const uchar* ptr, const simd_char_table& table) noexcept
+{
+    auto impl = select_kernel<find_class_end_fn>(LEXY_SIMD_KERNELS(find_class_end));
+    find_class_end_impl.store(impl, std::memory_order_relaxed);
+    return impl(ptr, table);
+}
+
+using find_either_fn = decltype(find_either_swar);
+const uchar* find_either_select(const uchar* ptr, uchar a, uchar b) noexcept;
+std::atomic<find_either_fn*> find_either_impl(&find_either_select);
+
+const uchar* find_either_select(const uchar* ptr, uchar a, uchar b) noexcept
+{
+    auto impl = select_kernel<find_either_fn>(LEXY_SIMD_KERNELS(find_either));
+    find_either_impl.store(impl, std::memory_order_relaxed);
+    return impl(ptr, a, b);
+}
+
+using count_char_fn = decltype(count_char_swar);
+std::size_t count_char_select(const uchar* begin, const uchar* end, uchar c) noexcept;
+std::atomic<count_char_fn*> count_char_impl(&count_char_select);
+
+std::size_t count_char_select(const uchar* begin, const uchar* end, uchar c) noexcept
+{
+    auto impl = select_kernel<count_char_fn>(LEXY_SIMD_KERNELS(count_char));
+    count_char_impl.store(impl, std::memory_order_relaxed);
+    return impl(begin, end, c);
+}
+} // namespace
+
+const unsigned char* lexy::_detail::simd_find_class_end(const unsigned char*  ptr,
+                                                        const simd_char_table& table) noexcept
+{
+    return find_class_end_impl.load(std::memory_order_relaxed)(ptr, table);
+}
+
+const unsigned char* lexy::_detail::simd_find_either(const unsigned char* ptr, unsigned char a,
+                                                     unsigned char b) noexcept
+{
+    return find_either_impl.load(std::memory_order_relaxed)(ptr, a, b);
+}
+
+std::size_t lexy::_detail::simd_count_char(const unsigned char* begin, const unsigned char* end,
+                                           unsigned char c) noexcept
+{
+    return count_char_impl.load(std::memory_order_relaxed)(begin, end, c);
+}
@@ -0,0 +1,61 @@
+#!/usr/bin/python
+# Generate the header file containing the powers of five used by `lexy::dsl::real`.
+# For each q in [-342, 308], it stores the 128 most significant bits of 5^q as two 64 bit words.
+# The table is the one used by the Eisel-Lemire algorithm, see https://arxiv.org/abs/2101.11408.
+# Positive powers are truncated, negative powers are rounded up.
+
+SMALLEST_POWER = -342
+LARGEST_POWER = 308
+
+def power_of_five_128(q):
+    if q >= 0:
+        power5 = 5 ** q
+        # Move the most significant bit to bit 127 and truncate the rest.
+        while power5 < (1 << 127):
+            power5 *= 2
+        while power5 >= (1 << 128):
+            power5 //= 2
+        return power5
+    else:
+        power5 = 5 ** -q
+        z = power5.bit_length()
+        # Compute the reciprocal with enough bits, so that it can be truncated to 128 bits.
+        b = z + 127 if q >= -27 else 2 * z + 2 * 64
+        result = 2 ** b // power5 + 1
+        while result >= (1 << 128):
+            result //= 2
+        return result
+
+def generate_table():
+    yield '// AUTOGENERATED FILE --- DO NOT EDIT!\n'
+    yield '// Generated by `support/generate-pow5-table.py`.\n'
+    yield '\n'
+    yield '#ifndef LEXY_DETAIL_POW5_TABLE_HPP_INCLUDED\n'
+    yield '#define LEXY_DETAIL_POW5_TABLE_HPP_INCLUDED\n'
+    yield '\n'
+    yield '#include <cstdint>\n'
+    yield '\n'
+    yield 'namespace lexy::_detail\n'
+    yield '{\n'
+    yield f'constexpr int pow5_table_smallest_power = {SMALLEST_POWER};\n'
+    yield f'constexpr int pow5_table_largest_power  = {LARGEST_POWER};\n'
+    yield '\n'
+    yield '// The high and low word of 5^q for q in [smallest_power, largest_power].\n'
+    yield 'constexpr std::uint64_t pow5_table[] = {\n'
+    for q in range(SMALLEST_POWER, LARGEST_POWER + 1):
+        value = power_of_five_128(q)
+        yield f'    0x{value >> 64:016x}, 0x{value & 0xFFFFFFFFFFFFFFFF:016x},\n'
+    yield '};\n'
+    yield '} // namespace lexy::_detail\n'
+    yield '\n'
+    yield '#endif // LEXY_DETAIL_POW5_TABLE_HPP_INCLUDED\n'
+
+#=== main ===#
+import sys
+
+if len(sys.argv) < 2:
+    print(f'usage: {sys.argv[0]} <output-file>')
+    sys.exit(1)
+
+with open(sys.argv[1], "w") as output_file:
+    print(''.join(generate_table()), file=output_file, end='')
@@ -577,7 +577,18 @@ TEST_CASE("roundtrip13")
     CHECK(tree == expected);
 }
 
-// 14 has an integer overflow.
+TEST_CASE("roundtrip14")
+{
+    auto tree = parse_tree(R"(-9223372036854775808)");
+
+    auto expected = lexy_ext::parse_tree_desc(grammar::json{})
+                        .production(grammar::number{})
+                        .literal("-")
+                        .token(lexy::digits_token_kind, "9223372036854775808")
+                        .finish()
+                        .eof();
+    CHECK(tree == expected);
+}
 
 TEST_CASE("roundtrip15")
 {
@@ -645,9 +656,7 @@ TEST_CASE("roundtrip20")
 
     auto expected = lexy_ext::parse_tree_desc(grammar::json{})
                         .production(grammar::number{})
-                        .token(lexy::digits_token_kind, "0")
-                        .literal(".")
-                        .token(lexy::digits_token_kind, "0")
+                        .token(lexy::digits_token_kind, "0.0")
                         .finish()
                         .eof();
     CHECK(tree == expected);
@@ -660,9 +669,7 @@ TEST_CASE("roundtrip21")
     auto expected = lexy_ext::parse_tree_desc(grammar::json{})
                         .production(grammar::number{})
                         .literal("-")
-                        .token(lexy::digits_token_kind, "0")
-                        .literal(".")
-                        .token(lexy::digits_token_kind, "0")
+                        .token(lexy::digits_token_kind, "0.0")
                         .finish()
                         .eof();
     CHECK(tree == expected);
@@ -674,9 +681,7 @@ TEST_CASE("roundtrip22")
 
     auto expected = lexy_ext::parse_tree_desc(grammar::json{})
                         .production(grammar::number{})
-                        .token(lexy::digits_token_kind, "1")
-                        .literal(".")
-                        .token(lexy::digits_token_kind, "2345")
+                        .token(lexy::digits_token_kind, "1.2345")
                         .finish()
                         .eof();
     CHECK(tree == expected);
@@ -689,9 +694,7 @@ TEST_CASE("roundtrip23")
     auto expected = lexy_ext::parse_tree_desc(grammar::json{})
                         .production(grammar::number{})
                         .literal("-")
-                        .token(lexy::digits_token_kind, "1")
-                        .literal(".")
-                        .token(lexy::digits_token_kind, "2345")
+                        .token(lexy::digits_token_kind, "1.2345")
                         .finish()
                         .eof();
     CHECK(tree == expected);
@@ -703,10 +706,7 @@ TEST_CASE("roundtrip24")
 
     auto expected = lexy_ext::parse_tree_desc(grammar::json{})
                         .production(grammar::number{})
-                        .token(lexy::digits_token_kind, "5")
-                        .literal("e")
-                        .literal("-")
-                        .token(lexy::digits_token_kind, "324")
+                        .token(lexy::digits_token_kind, "5e-324")
                         .finish()
                         .eof();
     CHECK(tree == expected);
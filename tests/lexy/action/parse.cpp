@@ -3,18 +3,26 @@
 
 #include <lexy/action/parse.hpp>
 
+#include <cstring>
 #include <doctest/doctest.h>
 #include <lexy/callback.hpp>
 #include <lexy/dsl/ascii.hpp>
 #include <lexy/dsl/brackets.hpp>
 #include <lexy/dsl/capture.hpp>
+#include <lexy/dsl/code_point.hpp>
+#include <lexy/dsl/delimited.hpp>
+#include <lexy/dsl/eof.hpp>
 #include <lexy/dsl/identifier.hpp>
 #include <lexy/dsl/list.hpp>
+#include <lexy/dsl/loop.hpp>
 #include <lexy/dsl/option.hpp>
 #include <lexy/dsl/production.hpp>
 #include <lexy/dsl/punctuator.hpp>
 #include <lexy/dsl/sequence.hpp>
+#include <lexy/dsl/unicode.hpp>
+#include <lexy/input/buffer.hpp>
 #include <lexy/input/string_input.hpp>
+#include <string>
 #include <vector>
 
 namespace parse_value
@@ -249,3 +257,163 @@ TEST_CASE("parse with state")
         CHECK(abc_123.value().b == "123");
     }
 }
+
+namespace parse_ascii_dispatch
+{
+namespace dsl = lexy::dsl;
+
+struct result_t
+{
+    bool        ascii_reader;
+    bool        utf8_reader;
+    std::string first;
+    std::string str;
+};
+
+struct string_p
+{
+    static constexpr auto rule  = dsl::quoted(dsl::unicode::print);
+    static constexpr auto value = lexy::as_string<std::string, lexy::utf8_encoding>;
+};
+
+struct prod
+{
+    static constexpr auto rule = dsl::capture(dsl::code_point) + dsl::p<string_p>
+                                 + dsl::while_(dsl::unicode::space) + dsl::eof;
+
+    static constexpr auto value = lexy::callback<result_t>([](auto lexeme, std::string str) {
+        constexpr auto ascii_reader
+            = std::is_same_v<decltype(lexeme), lexy::lexeme<lexy::_ascii_br8>>;
+        constexpr auto utf8_reader
+            = std::is_same_v<decltype(lexeme), lexy::lexeme<lexy::_utf8_br8>>;
+        return result_t{ascii_reader, utf8_reader, std::string(lexeme.begin(), lexeme.end()),
+                        LEXY_MOV(str)};
+    });
+};
+} // namespace parse_ascii_dispatch
+
+TEST_CASE("parse_ascii_dispatch")
+{
+    using namespace parse_ascii_dispatch;
+
+    auto parse = [](const char* str) {
+        lexy::buffer<lexy::utf8_encoding> input(str, std::strlen(str));
+
+        auto expected = lexy::parse<prod>(input, lexy::count);
+        auto result   = lexy::parse_ascii_dispatch<prod>(input, lexy::count);
+        CHECK(result.is_success() == expected.is_success());
+        CHECK(result.errors() == expected.errors());
+        if (result.has_value())
+        {
+            CHECK(!expected.value().ascii_reader);
+            CHECK(result.value().first == expected.value().first);
+            CHECK(result.value().str == expected.value().str);
+        }
+        return result;
+    };
+
+    auto empty = parse("");
+    CHECK(!empty);
+    CHECK(empty.errors() == 1);
+
+    auto ascii = parse("a\"bc\"");
+    CHECK(ascii);
+    CHECK(ascii.value().ascii_reader);
+    CHECK(ascii.value().first == "a");
+    CHECK(ascii.value().str == "bc");
+
+    auto ascii_space = parse("a\"bc\" \t");
+    CHECK(ascii_space);
+    CHECK(ascii_space.value().ascii_reader);
+
+    auto ascii_trailing = parse("a\"bc\" x");
+    CHECK(!ascii_trailing);
+    CHECK(ascii_trailing.errors() == 1);
+
+    auto ascii_error = parse("a\"b\x01c\"");
+    CHECK(ascii_error.is_recovered_error());
+    CHECK(ascii_error.errors() == 1);
+    CHECK(ascii_error.value().ascii_reader);
+
+    auto non_ascii_first = parse("\u00E4\"bc\"");
+    CHECK(non_ascii_first);
+    CHECK(!non_ascii_first.value().ascii_reader);
+    CHECK(non_ascii_first.value().first == "\u00E4");
+
+    auto non_ascii_str = parse("a\"b\u20ACc\"");
+    CHECK(non_ascii_str);
+    CHECK(!non_ascii_str.value().ascii_reader);
+    CHECK(non_ascii_str.value().str == "b\u20ACc");
+
+    auto non_ascii_space = parse("a\"bc\" \u3000");
+    CHECK(non_ascii_space);
+    CHECK(!non_ascii_space.value().ascii_reader);
+
+    auto non_ascii_error = parse("a\"b\xC3" "c\"");
+    CHECK(non_ascii_error.is_recovered_error());
+    CHECK(non_ascii_error.errors() == 1);
+
+    lexy::buffer<lexy::utf8_encoding> input("a\"\"", 3);
+    auto                              state      = 42;
+    auto                              with_state = lexy::parse_ascii_dispatch<prod>(input, state,
+                                                                                    lexy::count);
+    CHECK(with_state);
+}
+
+TEST_CASE("parse_validated_utf8")
+{
+    using namespace parse_ascii_dispatch;
+
+    auto parse = [](const char* str) {
+        lexy::buffer<lexy::utf8_encoding> input(str, std::strlen(str));
+
+        auto expected = lexy::parse<prod>(input, lexy::count);
+        auto result   = lexy::parse_validated_utf8<prod>(input, lexy::count);
+        CHECK(result.is_success() == expected.is_success());
+        CHECK(result.errors() == expected.errors());
+        if (result.has_value())
+        {
+            CHECK(!expected.value().utf8_reader);
+            CHECK(!result.value().ascii_reader);
+            CHECK(result.value().first == expected.value().first);
+            CHECK(result.value().str == expected.value().str);
+        }
+        return result;
+    };
+
+    auto empty = parse("");
+    CHECK(!empty);
+    CHECK(empty.errors() == 1);
+
+    auto ascii = parse("a\"bc\"");
+    CHECK(ascii);
+    CHECK(ascii.value().utf8_reader);
+    CHECK(ascii.value().first == "a");
+    CHECK(ascii.value().str == "bc");
+
+    auto non_ascii = parse("\u00E4\"b\u20ACc\" \u3000");
+    CHECK(non_ascii);
+    CHECK(non_ascii.value().utf8_reader);
+    CHECK(non_ascii.value().first == "\u00E4");
+    CHECK(non_ascii.value().str == "b\u20ACc");
+
+    auto trailing = parse("\U0001F600\"bc\" x");
+    CHECK(!trailing);
+    CHECK(trailing.errors() == 1);
+
+    auto print_error = parse("a\"b\u0085c\"");
+    CHECK(print_error.is_recovered_error());
+    CHECK(print_error.errors() == 1);
+    CHECK(print_error.value().utf8_reader);
+
+    auto ill_formed = parse("a\"b\xC3" "c\"");
+    CHECK(ill_formed.is_recovered_error());
+    CHECK(ill_formed.errors() == 1);
+    CHECK(!ill_formed.value().utf8_reader);
+
+    lexy::buffer<lexy::utf8_encoding> input("a\"\"", 3);
+    auto                              state      = 42;
+    auto                              with_state = lexy::parse_validated_utf8<prod>(input, state,
+                                                                                    lexy::count);
+    CHECK(with_state);
+}
@@ -17,3 +17,15 @@ TEST_CASE("as_integer")
     CHECK(plus_sign == 42);
 }
 
+
+TEST_CASE("as_real")
+{
+    double no_sign = lexy::as_real<double>(1.5);
+    CHECK(no_sign == 1.5);
+
+    double minus_sign = lexy::as_real<double>(lexy::minus_sign{}, 1.5);
+    CHECK(minus_sign == -1.5);
+
+    float plus_sign = lexy::as_real<float>(lexy::plus_sign{}, 1.5f);
+    CHECK(plus_sign == 1.5f);
+}
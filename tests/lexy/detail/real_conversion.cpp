@@ -0,0 +1,130 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/_detail/real_conversion.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <doctest/doctest.h>
+#include <string>
+
+namespace
+{
+template <typename T>
+T parse(const std::string& str)
+{
+    return lexy::_detail::parse_real<T>(str.data(), str.data() + str.size());
+}
+
+template <typename T>
+bool same_bits(T lhs, T rhs)
+{
+    return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+}
+} // namespace
+
+TEST_CASE("parse_real")
+{
+    SUBCASE("fast path")
+    {
+        CHECK(same_bits(parse<double>("0"), 0.0));
+        CHECK(same_bits(parse<double>("0.000e10"), 0.0));
+        CHECK(parse<double>("1") == 1.0);
+        CHECK(parse<double>("0.1") == 0.1);
+        CHECK(parse<double>("3.25") == 3.25);
+        CHECK(parse<double>("1e22") == 1e22);
+        CHECK(parse<double>("1e+22") == 1e22);
+        CHECK(parse<double>("1E-22") == 1e-22);
+        CHECK(parse<double>("9007199254740992") == 9007199254740992.0);
+
+        CHECK(parse<float>("0.1") == 0.1f);
+        CHECK(parse<float>("16777216") == 16777216.0f);
+    }
+    SUBCASE("Eisel-Lemire")
+    {
+        CHECK(parse<double>("1e23") == 1e23);
+        CHECK(parse<double>("9007199254740993") == 9007199254740992.0);
+        CHECK(parse<double>("9007199254740995") == 9007199254740996.0);
+        CHECK(parse<double>("123.456e-100") == 123.456e-100);
+        CHECK(parse<double>("1.7976931348623157e308") == 1.7976931348623157e308);
+        CHECK(parse<double>("2.2250738585072014e-308") == 2.2250738585072014e-308);
+        CHECK(parse<double>("2.2250738585072011e-308") == 2.2250738585072011e-308);
+        CHECK(parse<double>("4.9406564584124654e-324") == 4.9406564584124654e-324);
+
+        CHECK(parse<float>("3.4028235e38") == 3.4028235e38f);
+        CHECK(parse<float>("1.17549435e-38") == 1.17549435e-38f);
+        CHECK(parse<float>("1.4e-45") == 1.4e-45f);
+    }
+    SUBCASE("out of range")
+    {
+        auto inf = std::numeric_limits<double>::infinity();
+        CHECK(parse<double>("1.7976931348623159e308") == inf);
+        CHECK(parse<double>("1e309") == inf);
+        CHECK(parse<double>("1e99999999999") == inf);
+        CHECK(same_bits(parse<double>("2e-324"), 0.0));
+        CHECK(same_bits(parse<double>("1e-99999999999"), 0.0));
+
+        CHECK(parse<float>("3.4028236e38") == std::numeric_limits<float>::infinity());
+        CHECK(same_bits(parse<float>("7e-46"), 0.0f));
+    }
+    SUBCASE("many digits")
+    {
+        CHECK(parse<double>("12345678901234567890") == 12345678901234567890.0);
+        CHECK(parse<double>("0.000000000000000000000000000001") == 1e-30);
+        CHECK(parse<double>("100000000000000000000000000000000") == 1e32);
+        CHECK(parse<double>("1.000000000000000000000000000000001") == 1.0);
+
+        // Exactly between 2^53 and 2^53 + 2, or just above it.
+        CHECK(parse<double>("9007199254740993.0000000000000000000") == 9007199254740992.0);
+        CHECK(parse<double>("9007199254740993.0000000000000000001") == 9007199254740994.0);
+        CHECK(parse<double>("9007199254740995.0000000000000000000") == 9007199254740996.0);
+
+        // Exactly between 1 and the next float, or just above it.
+        CHECK(parse<float>("1.000000059604644775390625") == 1.0f);
+        CHECK(parse<float>("1.00000005960464477539062501") == 1.00000012f);
+
+        // Exactly half of the smallest subnormal, which rounds down to zero, or just above it.
+        auto half_min = std::string(
+            "2.4703282292062327208828439643411068618252990130716238221279284125033775"
+            "363510437593264991818081799618989828234772285886546332835517796989819938"
+            "739800539093906315035659515570226392290858392449105184435931802849936536"
+            "152500319370457678249219365623669863658480757001585769269903706311928279"
+            "558551332927834338409351978015531246597263579574622766465272827220056374"
+            "006485499977096599470454020828166226237857393450736339007967761930577506"
+            "740176324673600968951340535537458516661134223766678604162159680461914467"
+            "291840300530057530849048765391711386591646239524912623653881879636239373"
+            "280423891018672348497668235089863388587925628302755995657524455507255189"
+            "313690836254779186948667994968324049705821028513185451396213837722826145"
+            "437693412532098591327667236328125e-324");
+        CHECK(same_bits(parse<double>(half_min), 0.0));
+        CHECK(parse<double>(half_min.substr(0, half_min.size() - 5) + "000001e-324")
+              == 4.9406564584124654e-324);
+    }
+    SUBCASE("random")
+    {
+        // Compare against strtod, which is also correctly rounded.
+        auto state = std::uint64_t(0x1234'5678'9ABC'DEF0);
+        auto next  = [&] {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        };
+
+        for (auto i = 0; i != 10'000; ++i)
+        {
+            double value;
+            auto   bits = next() & 0x7FFF'FFFF'FFFF'FFFF;
+            std::memcpy(&value, &bits, sizeof(double));
+            if (value - value != 0)
+                continue;
+
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%.*g", int(next() % 25 + 1), value);
+            INFO(buffer);
+            CHECK(same_bits(parse<double>(buffer), std::strtod(buffer, nullptr)));
+            CHECK(same_bits(parse<float>(buffer), std::strtof(buffer, nullptr)));
+        }
+    }
+}
@@ -0,0 +1,190 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/_detail/simd.hpp>
+
+#include <cstring>
+#include <doctest/doctest.h>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/char_class.hpp>
+
+using namespace lexy::_detail;
+
+TEST_CASE("make_simd_char_table")
+{
+    constexpr auto table = make_simd_char_table(lexy::dsl::ascii::digit.char_class_ascii());
+    auto contains        = [&](int c) { return (table.lo[c & 0xF] & table.hi[c >> 4]) != 0; };
+
+    for (auto c = 0; c != 256; ++c)
+        CHECK(contains(c) == (c >= '0' && c <= '9'));
+}
+
+TEST_CASE("simd_padding")
+{
+    // It must not depend on the instruction set flags or LEXY_HAS_SIMD_DISPATCH.
+#if LEXY_IS_X86
+    CHECK(simd_padding<char> == 32);
+#endif
+    CHECK(simd_padding<char> >= simd_width);
+    CHECK(simd_padding<char16_t> == 0);
+}
+
+namespace
+{
+struct test_reader : simd_reader_base<test_reader, true>
+{
+    struct marker
+    {
+        const char* _it;
+    };
+
+    const char* cur;
+
+    const char* position() const
+    {
+        return cur;
+    }
+    void reset(marker m)
+    {
+        cur = m._it;
+    }
+};
+} // namespace
+
+TEST_CASE("simd_reader_base")
+{
+    // The hooks for the kernels don't depend on LEXY_HAS_SIMD_DISPATCH either.
+    CHECK(is_simd_reader<test_reader>);
+    CHECK(!is_simd_reader<simd_reader_base<test_reader, false>>);
+
+    const char  str[] = "abc";
+    test_reader reader{{}, str};
+    CHECK(reader.simd_position() == reinterpret_cast<const unsigned char*>(str));
+
+    reader.bump_simd_to(reader.simd_position() + 2);
+    CHECK(reader.cur == str + 2);
+}
+
+#if LEXY_HAS_SIMD
+namespace
+{
+simd_int load(const char* str)
+{
+    char buffer[simd_width];
+    for (auto i = 0u; i != simd_width; ++i)
+        buffer[i] = *str == '\0' ? 'a' : *str++;
+    return simd_load(buffer);
+}
+} // namespace
+
+TEST_CASE("simd_has_char")
+{
+    CHECK(!simd_has_char<char, 'b'>(load("")));
+    CHECK(simd_has_char<char, 'b'>(load("b")));
+    CHECK(simd_has_char<char, 'b'>(load("aaaab")));
+    CHECK(simd_has_char<char, char(0xFF)>(load("aaa\xFF")));
+
+    CHECK(simd_all_char<char, 'a'>(load("")));
+    CHECK(!simd_all_char<char, 'a'>(load("aaab")));
+}
+
+TEST_CASE("simd_has_char_less")
+{
+    CHECK(!simd_has_char_less<char, 0xF>(load("")));
+    CHECK(simd_has_char_less<char, 0xF>(load("aa\n")));
+    CHECK(simd_has_char_less<char, 0xF>(load("aa\x0E")));
+    CHECK(!simd_has_char_less<char, 0xF>(load("aa\x0F")));
+    CHECK(!simd_has_char_less<char, 0xF>(load("aa\xFF")));
+}
+
+TEST_CASE("simd_find_first_set")
+{
+    CHECK(simd_find_first_set(0b1) == 0);
+    CHECK(simd_find_first_set(0b1010'0000) == 5);
+    CHECK(simd_find_first_set(std::uint32_t(1) << (simd_width - 1)) == simd_width - 1);
+}
+
+#    if LEXY_HAS_SIMD_SHUFFLE
+TEST_CASE("simd_table_mismatch_mask")
+{
+    constexpr auto table = make_simd_char_table(lexy::dsl::ascii::lower.char_class_ascii());
+    CHECK(simd_table_mismatch_mask(load(""), table) == 0);
+    CHECK(simd_table_mismatch_mask(load("xyz"), table) == 0);
+    CHECK(simd_table_mismatch_mask(load("xYz"), table) == 0b10);
+    CHECK(simd_table_mismatch_mask(load("x1z\xE1"), table) == 0b1010);
+}
+
+TEST_CASE("simd_match_table")
+{
+    constexpr auto table = make_simd_char_table(lexy::dsl::ascii::lower.char_class_ascii());
+    CHECK(simd_match_table(load(""), table));
+    CHECK(simd_match_table(load("xyz"), table));
+    CHECK(!simd_match_table(load("xYz"), table));
+    CHECK(!simd_match_table(load("x1z"), table));
+    CHECK(!simd_match_table(load("x\xE1z"), table));
+}
+#    endif
+#endif
+
+#if LEXY_HAS_SIMD_DISPATCH
+namespace
+{
+// A string followed by EOF and enough padding for the kernels.
+struct padded_str
+{
+    unsigned char data[128];
+
+    explicit padded_str(const char* str)
+    {
+        auto len = std::strlen(str);
+        std::memcpy(data, str, len);
+        std::memset(data + len, 0xFF, sizeof(data) - len);
+    }
+};
+} // namespace
+
+TEST_CASE("simd_find_class_end")
+{
+    constexpr auto table = make_simd_char_table(lexy::dsl::ascii::lower.char_class_ascii());
+
+    padded_str empty("");
+    CHECK(simd_find_class_end(empty.data, table) == empty.data);
+
+    padded_str short_str("abc");
+    CHECK(simd_find_class_end(short_str.data, table) == short_str.data + 3);
+
+    padded_str long_str("abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyzABC");
+    CHECK(simd_find_class_end(long_str.data, table) == long_str.data + 52);
+
+    padded_str unicode("abcdefghijklmnopqrstuvwxyzabcdefghijklmnop\xC3\xA4");
+    CHECK(simd_find_class_end(unicode.data, table) == unicode.data + 42);
+}
+
+TEST_CASE("simd_find_either")
+{
+    padded_str empty("");
+    CHECK(simd_find_either(empty.data, '\n', 0xFF) == empty.data);
+
+    padded_str short_str("abc\n");
+    CHECK(simd_find_either(short_str.data, '\n', 0xFF) == short_str.data + 3);
+    CHECK(simd_find_either(short_str.data, 'c', '\n') == short_str.data + 2);
+
+    padded_str long_str("abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz\r\n");
+    CHECK(simd_find_either(long_str.data, '\n', 0xFF) == long_str.data + 53);
+}
+
+TEST_CASE("simd_count_char")
+{
+    auto count = [](const char* str) {
+        auto ptr = reinterpret_cast<const unsigned char*>(str);
+        return simd_count_char(ptr, ptr + std::strlen(str), '\n');
+    };
+
+    CHECK(count("") == 0);
+    CHECK(count("abc") == 0);
+    CHECK(count("a\nb\nc\n") == 3);
+    CHECK(count("abcdefghijklmnopqrstuvwxyz\nabcdefghijklmnopqrstuvwxyz\n\n"
+                "abcdefghijklmnopqrstuvwxyz\n\r\n")
+          == 5);
+}
+#endif
@@ -0,0 +1,154 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/_detail/validate_utf8.hpp>
+
+#include <cstring>
+#include <doctest/doctest.h>
+#include <string>
+
+using namespace lexy::_detail;
+
+namespace
+{
+bool validate_scalar(const std::string& str)
+{
+    auto ptr = reinterpret_cast<const unsigned char*>(str.data());
+    return validate_utf8_scalar(ptr, ptr + str.size());
+}
+
+bool validate(const std::string& str)
+{
+    auto result = validate_utf8(reinterpret_cast<const unsigned char*>(str.data()), str.size());
+    CHECK(result == validate_scalar(str));
+    return result;
+}
+
+// Checks the string at every offset, so it crosses the block boundaries.
+bool validate_shifted(const std::string& str)
+{
+    auto result = validate(str);
+    for (auto prefix = 1u; prefix != 40; ++prefix)
+    {
+        auto shifted = std::string(prefix, 'a') + str + std::string(prefix, 'b');
+        CHECK(validate(shifted) == result);
+    }
+    return result;
+}
+} // namespace
+
+TEST_CASE("validate_utf8")
+{
+    SUBCASE("ASCII")
+    {
+        CHECK(validate(""));
+        CHECK(validate("abc"));
+        CHECK(validate(std::string(100, 'a')));
+        CHECK(validate(std::string(100, '\0')));
+        CHECK(validate_shifted("\x7F"));
+    }
+    SUBCASE("well-formed")
+    {
+        CHECK(validate_shifted("ä"));
+        CHECK(validate_shifted("߿"));
+        CHECK(validate_shifted("ࠀ"));
+        CHECK(validate_shifted("€"));
+        CHECK(validate_shifted("퟿"));
+        CHECK(validate_shifted(""));
+        CHECK(validate_shifted("￿"));
+        CHECK(validate_shifted("\U00010000"));
+        CHECK(validate_shifted("\U0001F642"));
+        CHECK(validate_shifted("\U0010FFFF"));
+
+        std::string mixed;
+        for (auto i = 0; i != 20; ++i)
+            mixed += "aä€\U0001F642";
+        CHECK(validate_shifted(mixed));
+    }
+    SUBCASE("ill-formed")
+    {
+        // Trailing code unit without lead.
+        CHECK(!validate_shifted("\x80"));
+        CHECK(!validate_shifted("\xBF"));
+        CHECK(!validate_shifted("ä\x80"));
+        // Missing trailing code units.
+        CHECK(!validate_shifted("\xC3"));
+        CHECK(!validate_shifted("\xC3" "a"));
+        CHECK(!validate_shifted("\xE2\x82"));
+        CHECK(!validate_shifted("\xE2\x82" "a"));
+        CHECK(!validate_shifted("\xF0\x9F\x99"));
+        CHECK(!validate_shifted("\xF0\x9F\x99" "a"));
+        // Overlong sequences.
+        CHECK(!validate_shifted("\xC0\x80"));
+        CHECK(!validate_shifted("\xC1\xBF"));
+        CHECK(!validate_shifted("\xE0\x80\x80"));
+        CHECK(!validate_shifted("\xE0\x9F\xBF"));
+        CHECK(!validate_shifted("\xF0\x80\x80\x80"));
+        CHECK(!validate_shifted("\xF0\x8F\xBF\xBF"));
+        // Surrogates.
+        CHECK(!validate_shifted("\xED\xA0\x80"));
+        CHECK(!validate_shifted("\xED\xBF\xBF"));
+        // Out of range.
+        CHECK(!validate_shifted("\xF4\x90\x80\x80"));
+        CHECK(!validate_shifted("\xF5\x80\x80\x80"));
+        CHECK(!validate_shifted("\xF8\x80\x80\x80\x80"));
+        CHECK(!validate_shifted("\xFF"));
+        // Too many trailing code units.
+        CHECK(!validate_shifted("\xC3\xA4\x80"));
+        CHECK(!validate_shifted("\xE2\x82\xAC\x80"));
+        CHECK(!validate_shifted("\xF0\x9F\x99\x82\x80"));
+    }
+    SUBCASE("ill-formed at the end")
+    {
+        for (auto size = 0u; size != 70; ++size)
+        {
+            auto str = std::string(size, 'a');
+            CHECK(!validate(str + "\xC3"));
+            CHECK(!validate(str + "\xE2\x82"));
+            CHECK(!validate(str + "\xF0\x9F\x99"));
+            CHECK(validate(str + "\xF0\x9F\x99\x82"));
+        }
+    }
+    SUBCASE("all two code unit sequences")
+    {
+        // Compare against the scalar implementation, which is easier to verify.
+        for (auto first = 0; first != 256; ++first)
+            for (auto second = 0; second != 256; ++second)
+            {
+                std::string str(20, 'a');
+                str[15] = char(first);
+                str[16] = char(second);
+                validate(str);
+                str[18] = char(0x80);
+                validate(str);
+            }
+    }
+}
+
+TEST_CASE("is_ascii")
+{
+    auto is_ascii = [](const std::string& str) {
+        return lexy::_detail::is_ascii(reinterpret_cast<const unsigned char*>(str.data()),
+                                       str.size());
+    };
+
+    CHECK(is_ascii(""));
+    CHECK(is_ascii("abc"));
+    CHECK(is_ascii("\x7F"));
+    CHECK(!is_ascii("\x80"));
+    CHECK(!is_ascii("\u00E4"));
+
+    for (auto size = 1u; size != 200; ++size)
+    {
+        auto str = std::string(size, 'a');
+        CHECK(is_ascii(str));
+
+        // Check every position, as they're handled by different loops.
+        for (auto i = 0u; i != size; ++i)
+        {
+            str[i] = char(0xFF);
+            CHECK(!is_ascii(str));
+            str[i] = 'a';
+        }
+    }
+}
@@ -4,8 +4,12 @@
 #include <lexy/dsl/choice.hpp>
 
 #include "verify.hpp"
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/case_folding.hpp>
+#include <lexy/dsl/digit.hpp>
 #include <lexy/dsl/error.hpp>
 #include <lexy/dsl/if.hpp>
+#include <lexy/dsl/peek.hpp>
 #include <lexy/dsl/production.hpp>
 #include <lexy/dsl/recover.hpp>
 
@@ -33,6 +37,7 @@ TEST_CASE("dsl::operator|")
         constexpr auto rule
             = LEXY_LIT("abc") >> dsl::p<label<0>> | LEXY_LIT("def") >> dsl::p<label<1>>;
         CHECK(lexy::is_branch_rule<decltype(rule)>);
+        CHECK(decltype(rule)::_dispatch<lexy::default_encoding>.enabled);
 
         auto empty = LEXY_VERIFY("");
         CHECK(empty.status == test_result::fatal_error);
@@ -63,6 +68,8 @@ TEST_CASE("dsl::operator|")
         constexpr auto rule
             = LEXY_LIT("a") >> dsl::p<label<0>> | LEXY_LIT("abc") >> dsl::p<label<1>>;
         CHECK(lexy::is_branch_rule<decltype(rule)>);
+        // Both branches start with the same char, so we need to try them in order.
+        CHECK(!decltype(rule)::_dispatch<lexy::default_encoding>.enabled);
 
         auto empty = LEXY_VERIFY("");
         CHECK(empty.status == test_result::fatal_error);
@@ -155,6 +162,114 @@ TEST_CASE("dsl::operator|")
                      .expected_literal(3, "!", 0)
                      .recovery());
     }
+    SUBCASE("dispatch on next char")
+    {
+        constexpr auto rule
+            = LEXY_LIT("abc") >> dsl::p<label<0>>                                       //
+              | dsl::ascii::case_folding(LEXY_LIT("def")) >> dsl::p<label<1>>           //
+              | dsl::peek(dsl::ascii::digit) >> dsl::p<label<2>>                        //
+              | dsl::literal_set(LEXY_LIT("+"), LEXY_LIT("-")) >> dsl::p<label<3>>      //
+              | dsl::else_ >> dsl::p<label<4>>;
+        CHECK(lexy::is_rule<decltype(rule)>);
+        // Each branch starts with different chars, so the next char selects the only branch.
+        CHECK(decltype(rule)::_dispatch<lexy::default_encoding>.enabled);
+        CHECK(!decltype(rule)::_dispatch<lexy::utf16_encoding>.enabled);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::recovered_error);
+        CHECK(empty.value == 4);
+        CHECK(empty.trace
+              == test_trace().production("label").expected_literal(0, "!", 0).recovery());
+
+        auto abc = LEXY_VERIFY("abc!");
+        CHECK(abc.status == test_result::success);
+        CHECK(abc.value == 0);
+        CHECK(abc.trace == test_trace().literal("abc").production("label").literal("!"));
+
+        auto DEF = LEXY_VERIFY("DEF!");
+        CHECK(DEF.status == test_result::success);
+        CHECK(DEF.value == 1);
+        CHECK(DEF.trace == test_trace().literal("DEF").production("label").literal("!"));
+
+        auto digit = LEXY_VERIFY("1");
+        CHECK(digit.status == test_result::recovered_error);
+        CHECK(digit.value == 2);
+
+        auto minus = LEXY_VERIFY("-!");
+        CHECK(minus.status == test_result::success);
+        CHECK(minus.value == 3);
+        CHECK(minus.trace == test_trace().literal("-").production("label").literal("!"));
+
+        // The selected branch doesn't match, so we take the else branch.
+        auto abd = LEXY_VERIFY("abd!");
+        CHECK(abd.status == test_result::recovered_error);
+        CHECK(abd.value == 4);
+        CHECK(abd.trace
+              == test_trace().production("label").expected_literal(0, "!", 0).recovery());
+    }
+    SUBCASE("dispatch on digits")
+    {
+        constexpr auto rule
+            = dsl::digits<>.sep(dsl::digit_sep_tick) >> dsl::p<label<0>>              //
+              | LEXY_LIT("x") >> dsl::p<label<1>>                                      //
+              | LEXY_LIT("-") >> dsl::n_digits<2, dsl::hex_upper> + dsl::p<label<2>>;
+        CHECK(lexy::is_rule<decltype(rule)>);
+        // The digits start with a decimal digit, which the other branches don't.
+        CHECK(decltype(rule)::_dispatch<lexy::default_encoding>.enabled);
+
+        auto digits = LEXY_VERIFY("1'2!");
+        CHECK(digits.status == test_result::success);
+        CHECK(digits.value == 0);
+        CHECK(digits.trace == test_trace().token("digits", "1'2").production("label").literal("!"));
+
+        auto x = LEXY_VERIFY("x!");
+        CHECK(x.status == test_result::success);
+        CHECK(x.value == 1);
+        CHECK(x.trace == test_trace().literal("x").production("label").literal("!"));
+
+        auto minus = LEXY_VERIFY("-1F!");
+        CHECK(minus.status == test_result::success);
+        CHECK(minus.value == 2);
+        CHECK(minus.trace
+              == test_trace().literal("-").token("digits", "1F").production("label").literal("!"));
+
+        auto none = LEXY_VERIFY("a");
+        CHECK(none.status == test_result::fatal_error);
+        CHECK(none.trace == test_trace().error(0, 0, "exhausted choice").cancel());
+    }
+    SUBCASE("dispatch on n_digits")
+    {
+        constexpr auto rule = dsl::n_digits<2, dsl::hex_upper> >> dsl::p<label<0>> //
+                              | LEXY_LIT("x") >> dsl::p<label<1>>;
+        CHECK(decltype(rule)::_dispatch<lexy::default_encoding>.enabled);
+
+        auto digits = LEXY_VERIFY("A0!");
+        CHECK(digits.status == test_result::success);
+        CHECK(digits.value == 0);
+        CHECK(digits.trace == test_trace().token("digits", "A0").production("label").literal("!"));
+
+        // The branch is selected, but only one digit matches, so no branch is taken.
+        auto short_ = LEXY_VERIFY("A!");
+        CHECK(short_.status == test_result::fatal_error);
+        CHECK(short_.trace == test_trace().error(0, 0, "exhausted choice").cancel());
+    }
+    SUBCASE("digits overlapping literal")
+    {
+        constexpr auto rule = LEXY_LIT("0x") >> dsl::p<label<0>> //
+                              | dsl::digits<> >> dsl::p<label<1>>;
+        // Both branches can start with 0, so they're tried in order.
+        CHECK(!decltype(rule)::_dispatch<lexy::default_encoding>.enabled);
+
+        auto hex = LEXY_VERIFY("0x!");
+        CHECK(hex.status == test_result::success);
+        CHECK(hex.value == 0);
+        CHECK(hex.trace == test_trace().literal("0x").production("label").literal("!"));
+
+        auto zero = LEXY_VERIFY("0!");
+        CHECK(zero.status == test_result::success);
+        CHECK(zero.value == 1);
+        CHECK(zero.trace == test_trace().token("digits", "0").production("label").literal("!"));
+    }
 
     SUBCASE("as branch")
     {
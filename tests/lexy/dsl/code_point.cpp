@@ -4,6 +4,7 @@
 #include <lexy/dsl/code_point.hpp>
 
 #include "verify.hpp"
+#include <lexy/input/buffer.hpp>
 
 using lexy::_detail::cp_error;
 
@@ -216,6 +217,42 @@ TEST_CASE("UTF-8 code point parsing")
             CHECK(result.value == i);
         }
     }
+    SUBCASE("validated")
+    {
+        auto parse_validated = [](const lexy::buffer<lexy::utf8_encoding>& buffer) {
+            auto reader = lexy::_utf8_validated_reader(buffer.reader());
+            REQUIRE(lexy::_detail::is_utf8_validated_reader<decltype(reader)>);
+
+            auto result = lexy::_detail::parse_code_point(reader);
+            return parse_result{std::size_t(result.end.position() - buffer.data()), result.error,
+                                result.cp};
+        };
+
+        for (auto cp = char32_t(0x01); cp <= 0x10FFFF; ++cp)
+        {
+            if (cp >= 0xD800 && cp <= 0xDFFF)
+                continue;
+            INFO(cp);
+
+            LEXY_CHAR8_T str[5] = {};
+            auto         end    = lexy::_detail::encode_utf8(str, cp);
+
+            lexy::buffer<lexy::utf8_encoding> buffer(str, std::size_t(end - str));
+            REQUIRE(lexy::validate_utf8(buffer));
+
+            auto expected = parse(str);
+            auto result   = parse_validated(buffer);
+            CHECK(result);
+            CHECK(result.count == expected.count);
+            CHECK(result.value == expected.value);
+        }
+
+        lexy::buffer<lexy::utf8_encoding> empty(LEXY_CHAR8_STR(""), std::size_t(0));
+        auto result = parse_validated(empty);
+        CHECK(!result);
+        CHECK(result.count == 0);
+        CHECK(result.ec == cp_error::eof);
+    }
 }
 
 TEST_CASE("UTF-16 code point parsing")
@@ -635,6 +635,21 @@ TEST_CASE("dsl::delimited(open, close) - SWAR")
                  .literal(")")
                  .token("stuvwxyz")
                  .literal(")"));
+
+    auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{},
+                            "(abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+                            "$)abcdefghijklmnopqrstuvwxyz)");
+    CHECK(simd.status == test_result::success);
+    CHECK(simd.value == 78);
+    CHECK(simd.trace
+          == test_trace()
+                 .literal("(")
+                 .token("abcdefghijklmnopqrstuvwxyz"
+                        "abcdefghijklmnopqrstuvwxyz")
+                 .literal("$")
+                 .literal(")")
+                 .token("abcdefghijklmnopqrstuvwxyz")
+                 .literal(")"));
 }
 
 TEST_CASE("dsl::delimited(delim)")
@@ -113,6 +113,16 @@ TEST_CASE("dsl::digit")
         check_valid(rule, '0', '1', '2', '3', '4', '5', '6', '7', '8', '9');
         check_invalid(rule, "digit.decimal", 'a', 'b', 'c', 'd', 'e', 'f', 'A', 'B', 'C', 'D', 'E',
                       'F');
+
+        auto swar_value = [](const char* str) {
+            return dsl::decimal::swar_value(lexy::_detail::swar_load(str));
+        };
+        CHECK(swar_value("00000000") == 0);
+        CHECK(swar_value("00000001") == 1);
+        CHECK(swar_value("10000000") == 10000000);
+        CHECK(swar_value("12345678") == 12345678);
+        CHECK(swar_value("87654321") == 87654321);
+        CHECK(swar_value("99999999") == 99999999);
     }
     SUBCASE("hex_lower")
     {
@@ -1535,10 +1535,9 @@ TEST_CASE("expression - transparent atom")
     CHECK(empty.status == test_result::fatal_error);
     CHECK(empty.value == -1);
     // clang-format off
+    // The atoms start with different characters, so they aren't tried at all.
     CHECK(empty.trace == test_trace()
             .operation_chain()
-                .production("atom").cancel()
-                .production("atom").cancel()
                 .error(0, 0, "exhausted choice")
                 .finish()
             .cancel());
@@ -1556,8 +1555,6 @@ TEST_CASE("expression - transparent atom")
     // clang-format off
     CHECK(one.trace == test_trace()
             .operation_chain()
-                .production("atom")
-                    .cancel()
                 .production("atom")
                     .literal("1"));
     // clang-format on
@@ -1573,8 +1570,6 @@ TEST_CASE("expression - transparent atom")
                      .literal("0")
                      .finish()
                  .literal("+")
-                 .production("atom")
-                     .cancel()
                  .production("atom")
                      .literal("1")
                      .finish()
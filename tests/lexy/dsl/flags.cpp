@@ -94,6 +94,45 @@ TEST_CASE("dsl::flags")
     }
 }
 
+namespace
+{
+// In the tests, the parse state is the test handler, so we can't store the table in it.
+const std::pair<lexy::_detail::string_view, flags> runtime_flag_mappings[]
+    = {{"a", flags::a}, {"b", flags::b}, {"c", flags::c}};
+const lexy::runtime_symbol_table<flags> runtime_flag_symbols(runtime_flag_mappings);
+
+constexpr auto get_runtime_flag_symbols
+    = [](const auto&) -> const lexy::runtime_symbol_table<flags>& { return runtime_flag_symbols; };
+} // namespace
+
+TEST_CASE("dsl::flags with runtime symbol table")
+{
+    constexpr auto rule     = dsl::flags<flags::none>(dsl::symbol<get_runtime_flag_symbols>);
+    constexpr auto callback = [](const char*, flags value) { return int(value); };
+
+    auto empty = LEXY_VERIFY_RUNTIME("");
+    CHECK(empty.status == test_result::success);
+    CHECK(empty.value == int(flags::none));
+    CHECK(empty.trace == test_trace());
+
+    auto cab = LEXY_VERIFY_RUNTIME("cab");
+    CHECK(cab.status == test_result::success);
+    CHECK(cab.value == (int(flags::c) | int(flags::a) | int(flags::b)));
+    CHECK(
+        cab.trace
+        == test_trace().token("identifier", "c").token("identifier", "a").token("identifier", "b"));
+
+    auto aba = LEXY_VERIFY_RUNTIME("aba");
+    CHECK(aba.status == test_result::recovered_error);
+    CHECK(aba.value == (int(flags::a) | int(flags::b)));
+    CHECK(aba.trace
+          == test_trace()
+                 .token("identifier", "a")
+                 .token("identifier", "b")
+                 .token("identifier", "a")
+                 .error(2, 3, "duplicate flag"));
+}
+
 TEST_CASE("dsl::flag")
 {
     SUBCASE("explicit value")
@@ -48,6 +48,15 @@ TEST_CASE("dsl::identifier(leading, trailing).pattern()")
     auto swar = LEXY_VERIFY(lexy::utf8_char_encoding{}, "Abcdefghijklmnopqrstuvwxyz");
     CHECK(swar.status == test_result::success);
     CHECK(swar.trace == test_trace().token("identifier", "Abcdefghijklmnopqrstuvwxyz"));
+
+    auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{}, "Abcdefghijklmnopqrstuvwxyz"
+                                                        "abcdefghijklmnopqrstuvwxyz"
+                                                        "abcdefghijklmnopqrstuvwxyz");
+    CHECK(simd.status == test_result::success);
+    CHECK(simd.trace
+          == test_trace().token("identifier", "Abcdefghijklmnopqrstuvwxyz"
+                                              "abcdefghijklmnopqrstuvwxyz"
+                                              "abcdefghijklmnopqrstuvwxyz"));
 }
 
 TEST_CASE("dsl::identifier(leading, trailing)")
@@ -232,6 +232,63 @@ TEST_CASE("_integer_parser")
         CHECK(parse_int(parser, "1'2") == 12);
         CHECK(parse_int(parser, "0'0'0'0'0'0'1'2") == 12);
     }
+    SUBCASE("base 10, long digit sequences")
+    {
+        // Those can be parsed eight digits at a time.
+        constexpr auto parser = dsl::_integer_parser<long long, dsl::decimal, false>{};
+        auto           check  = [&](long long value) {
+            INFO(value);
+            CHECK(parse_int(parser, std::to_string(value).c_str()).value == value);
+            CHECK(!parse_int(parser, std::to_string(value).c_str()).overflow);
+        };
+
+        for (auto value = 1ll; value < LLONG_MAX / 10; value = value * 10 + value % 7 + 1)
+        {
+            check(value);
+            check(value * 10 - 1);
+        }
+        check(LLONG_MAX);
+        check(LLONG_MAX - 1);
+        check(12345678);
+        check(123456789);
+        check(1234567890123456);
+
+        CHECK(parse_int(parser, "0000000000000000000000000009223372036854775807").value
+              == LLONG_MAX);
+
+        auto overflow = parse_int(parser, "9223372036854775808");
+        CHECK(overflow.overflow);
+        CHECK(overflow.value == LLONG_MAX / 10 * 10);
+        CHECK(parse_int(parser, "12345678901234567890").overflow);
+        CHECK(parse_int(parser, "92233720368547758070").overflow);
+
+        auto sep = parse_int(parser, "1'2345'6789'0123'4567");
+        CHECK(!sep.overflow);
+        CHECK(sep.value == 12345678901234567);
+        CHECK(parse_int(parser, "922337203685477580'7").value == LLONG_MAX);
+        CHECK(parse_int(parser, "922337203685477580'8").overflow);
+
+        constexpr auto uparser
+            = dsl::_integer_parser<unsigned long long, dsl::decimal, false>{};
+        CHECK(parse_int(uparser, "18446744073709551615").value == ULLONG_MAX);
+        CHECK(parse_int(uparser, "18446744073709551616").overflow);
+        CHECK(parse_int(uparser, "99999999999999999999").overflow);
+
+        constexpr auto iparser = dsl::_integer_parser<int, dsl::decimal, false>{};
+        CHECK(parse_int(iparser, "2147483647") == INT_MAX);
+        CHECK(parse_int(iparser, "2147483648").overflow);
+        CHECK(parse_int(iparser, "9999999999").overflow);
+
+        constexpr auto unbounded_parser
+            = dsl::_integer_parser<lexy::unbounded<std::uint8_t>, dsl::decimal, false>{};
+        CHECK(parse_int(unbounded_parser, "123456789012") == 123456789012 % 256);
+        CHECK(parse_int(unbounded_parser, "1'2345'6789'012") == 123456789012 % 256);
+
+        constexpr auto bounded_parser
+            = dsl::_integer_parser<lexy::bounded<unsigned, 1'000'000'000>, dsl::decimal, false>{};
+        CHECK(parse_int(bounded_parser, "1000000000").value == 1'000'000'000);
+        CHECK(parse_int(bounded_parser, "1000000001").overflow);
+    }
 
     SUBCASE("base 16, uint8_t")
     {
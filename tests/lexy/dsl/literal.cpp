@@ -179,6 +179,43 @@ TEST_CASE("dsl::lit")
         CHECK(success.status == test_result::success);
         CHECK(success.trace == test_trace().literal("abcdefghijklmnopqrstuvwxyz"));
     }
+    SUBCASE("simd")
+    {
+        constexpr auto rule = LEXY_LIT("abcdefghijklmnopqrstuvwxyz0123456789ABCD");
+        CHECK(lexy::is_token_rule<decltype(rule)>);
+        CHECK(lexy::is_literal_rule<decltype(rule)>);
+
+        auto partial = LEXY_VERIFY(lexy::utf8_encoding{},
+                                   LEXY_CHAR8_STR("abcdefghijklmnopqrstuvwxyz0123"));
+        CHECK(partial.status == test_result::fatal_error);
+        CHECK(partial.trace
+              == test_trace()
+                     .error_token("abcdefghijklmnopqrstuvwxyz0123")
+                     .expected_literal(0, "abcdefghijklmnopqrstuvwxyz0123456789ABCD", 30)
+                     .cancel());
+
+        auto wrong_first = LEXY_VERIFY(lexy::utf8_encoding{},
+                                       LEXY_CHAR8_STR("abcdefghijklmNOPQRSTUVWXYZ0123456789ABCD"));
+        CHECK(wrong_first.status == test_result::fatal_error);
+        CHECK(wrong_first.trace
+              == test_trace()
+                     .error_token("abcdefghijklm")
+                     .expected_literal(0, "abcdefghijklmnopqrstuvwxyz0123456789ABCD", 13)
+                     .cancel());
+        auto wrong_last = LEXY_VERIFY(lexy::utf8_encoding{},
+                                      LEXY_CHAR8_STR("abcdefghijklmnopqrstuvwxyz0123456789ABcd"));
+        CHECK(wrong_last.status == test_result::fatal_error);
+        CHECK(wrong_last.trace
+              == test_trace()
+                     .error_token("abcdefghijklmnopqrstuvwxyz0123456789AB")
+                     .expected_literal(0, "abcdefghijklmnopqrstuvwxyz0123456789ABCD", 38)
+                     .cancel());
+
+        auto success = LEXY_VERIFY(lexy::utf8_encoding{},
+                                   LEXY_CHAR8_STR("abcdefghijklmnopqrstuvwxyz0123456789ABCDEF"));
+        CHECK(success.status == test_result::success);
+        CHECK(success.trace == test_trace().literal("abcdefghijklmnopqrstuvwxyz0123456789ABCD"));
+    }
 }
 
 TEST_CASE("dsl::lit_cp")
@@ -422,6 +459,108 @@ TEST_CASE("dsl::literal_set")
         CHECK(abc.trace == test_trace().literal("abc"));
     }
 
+    SUBCASE("long chain")
+    {
+        constexpr auto id   = dsl::identifier(dsl::ascii::alpha_underscore);
+        constexpr auto rule = dsl::literal_set(LEXY_LIT("<"), LEXY_LIT("<![CDATA["),
+                                               LEXY_LIT("<!DOCTYPE html>"),
+                                               LEXY_LIT("abcdefghijklmnopqrstuvwxyz"),
+                                               LEXY_LIT("abcdefghijklmnopqrstuvwxyz0123456789"),
+                                               LEXY_KEYWORD("transfer_encoding_chunked", id));
+        CHECK(lexy::is_token_rule<decltype(rule)>);
+        CHECK(lexy::is_literal_set_rule<decltype(rule)>);
+
+        auto doctype = LEXY_VERIFY(lexy::utf8_char_encoding{}, "<!DOCTYPE html>");
+        CHECK(doctype.status == test_result::success);
+        CHECK(doctype.trace == test_trace().literal("<!DOCTYPE\\u0020html>"));
+        auto doctype_partial = LEXY_VERIFY(lexy::utf8_char_encoding{}, "<!DOCTYPE>");
+        CHECK(doctype_partial.status == test_result::success);
+        CHECK(doctype_partial.trace == test_trace().literal("<"));
+        auto cdata = LEXY_VERIFY(lexy::utf8_char_encoding{}, "<![CDATA[");
+        CHECK(cdata.status == test_result::success);
+        CHECK(cdata.trace == test_trace().literal("<![CDATA["));
+
+        auto alphabet = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz");
+        CHECK(alphabet.status == test_result::success);
+        CHECK(alphabet.trace == test_trace().literal("abcdefghijklmnopqrstuvwxyz"));
+        auto alphabet_digits
+            = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz0123456789");
+        CHECK(alphabet_digits.status == test_result::success);
+        CHECK(alphabet_digits.trace
+              == test_trace().literal("abcdefghijklmnopqrstuvwxyz0123456789"));
+        auto alphabet_some_digits
+            = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz012345678");
+        CHECK(alphabet_some_digits.status == test_result::success);
+        CHECK(alphabet_some_digits.trace == test_trace().literal("abcdefghijklmnopqrstuvwxyz"));
+        auto alphabet_wrong = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyZ");
+        CHECK(alphabet_wrong.status == test_result::fatal_error);
+        CHECK(alphabet_wrong.trace == test_trace().error(0, 0, "expected literal set").cancel());
+
+        auto keyword = LEXY_VERIFY(lexy::utf8_char_encoding{}, "transfer_encoding_chunked");
+        CHECK(keyword.status == test_result::success);
+        CHECK(keyword.trace == test_trace().literal("transfer_encoding_chunked"));
+        auto not_keyword = LEXY_VERIFY(lexy::utf8_char_encoding{}, "transfer_encoding_chunked_");
+        CHECK(not_keyword.status == test_result::fatal_error);
+        CHECK(not_keyword.trace == test_trace().error(0, 0, "expected literal set").cancel());
+    }
+
+    SUBCASE("wide nodes")
+    {
+        constexpr auto id   = dsl::identifier(dsl::ascii::alpha);
+        constexpr auto rule = dsl::literal_set(
+            LEXY_LIT("a"), LEXY_LIT("aa"), LEXY_LIT("ab"), LEXY_LIT("ac"), LEXY_LIT("ad"),
+            LEXY_LIT("ae"), LEXY_LIT("af"), LEXY_LIT("ba"), LEXY_LIT("bb"), LEXY_LIT("bc"),
+            LEXY_LIT("bd"), LEXY_LIT("be"), LEXY_LIT("bf"), dsl::ascii::case_folding(LEXY_LIT("ca")),
+            LEXY_LIT("cb"), LEXY_LIT("cc"), LEXY_LIT("cd"), LEXY_LIT("ce"), LEXY_LIT("cf"),
+            LEXY_KEYWORD("da", id), LEXY_LIT("db"), LEXY_LIT("dc"), LEXY_LIT("dd"), LEXY_LIT("de"),
+            LEXY_LIT("df"), LEXY_LIT("ddd"));
+        CHECK(lexy::is_token_rule<decltype(rule)>);
+        CHECK(lexy::is_literal_set_rule<decltype(rule)>);
+        // Most nodes have six transitions, so it is matched using the table.
+        CHECK(lexy::_detail::lit_trie_dfa<
+              decltype(rule)::_t<lexy::default_encoding>>::enabled);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::fatal_error);
+        CHECK(empty.trace == test_trace().error(0, 0, "expected literal set").cancel());
+        auto e = LEXY_VERIFY("e");
+        CHECK(e.status == test_result::fatal_error);
+        CHECK(e.trace == test_trace().error(0, 0, "expected literal set").cancel());
+        auto b = LEXY_VERIFY("b");
+        CHECK(b.status == test_result::fatal_error);
+        CHECK(b.trace == test_trace().error(0, 0, "expected literal set").cancel());
+
+        auto a = LEXY_VERIFY("a");
+        CHECK(a.status == test_result::success);
+        CHECK(a.trace == test_trace().literal("a"));
+        auto ad = LEXY_VERIFY("ad");
+        CHECK(ad.status == test_result::success);
+        CHECK(ad.trace == test_trace().literal("ad"));
+        auto ag = LEXY_VERIFY("ag");
+        CHECK(ag.status == test_result::success);
+        CHECK(ag.trace == test_trace().literal("a"));
+        auto bc = LEXY_VERIFY("bcd");
+        CHECK(bc.status == test_result::success);
+        CHECK(bc.trace == test_trace().literal("bc"));
+        auto CA = LEXY_VERIFY("CA");
+        CHECK(CA.status == test_result::success);
+        CHECK(CA.trace == test_trace().literal("CA"));
+        auto ddd = LEXY_VERIFY("dddd");
+        CHECK(ddd.status == test_result::success);
+        CHECK(ddd.trace == test_trace().literal("ddd"));
+
+        auto da = LEXY_VERIFY("da");
+        CHECK(da.status == test_result::success);
+        CHECK(da.trace == test_trace().literal("da"));
+        auto dab = LEXY_VERIFY("dab");
+        CHECK(dab.status == test_result::fatal_error);
+        CHECK(dab.trace == test_trace().error(0, 0, "expected literal set").cancel());
+
+        auto utf16 = LEXY_VERIFY(lexy::utf16_encoding{}, u"bd");
+        CHECK(utf16.status == test_result::success);
+        CHECK(utf16.trace == test_trace().literal("bd"));
+    }
+
     SUBCASE("lit_b")
     {
         constexpr auto rule
@@ -0,0 +1,145 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/dsl/real.hpp>
+
+#include "verify.hpp"
+#include <lexy/dsl/if.hpp>
+#include <lexy/dsl/sign.hpp>
+
+TEST_CASE("dsl::real")
+{
+    constexpr auto real = dsl::real<double>;
+    CHECK(lexy::is_branch_rule<decltype(real)>);
+
+    // The test handler only stores ints, so we store thousandths.
+    constexpr auto callback
+        = lexy::callback<int>([](const char*) { return -11; },
+                              [](const char*, double value) {
+                                  return value > 1e6 ? -1 : static_cast<int>(value * 1000);
+                              });
+
+    SUBCASE("as rule")
+    {
+        constexpr auto rule = real;
+
+        auto empty = LEXY_VERIFY_RUNTIME("");
+        CHECK(empty.status == test_result::fatal_error);
+        CHECK(empty.trace == test_trace().expected_char_class(0, "digit.decimal").cancel());
+        auto period = LEXY_VERIFY_RUNTIME(".5");
+        CHECK(period.status == test_result::fatal_error);
+        CHECK(period.trace == test_trace().expected_char_class(0, "digit.decimal").cancel());
+
+        auto zero = LEXY_VERIFY_RUNTIME("0");
+        CHECK(zero.status == test_result::success);
+        CHECK(zero.value == 0);
+        CHECK(zero.trace == test_trace().token("digits", "0"));
+        auto integer = LEXY_VERIFY_RUNTIME("123");
+        CHECK(integer.status == test_result::success);
+        CHECK(integer.value == 123'000);
+        CHECK(integer.trace == test_trace().token("digits", "123"));
+        auto leading_zero = LEXY_VERIFY_RUNTIME("0123");
+        CHECK(leading_zero.status == test_result::success);
+        CHECK(leading_zero.value == 0);
+        CHECK(leading_zero.trace == test_trace().token("digits", "0"));
+
+        auto fraction = LEXY_VERIFY_RUNTIME("3.25");
+        CHECK(fraction.status == test_result::success);
+        CHECK(fraction.value == 3'250);
+        CHECK(fraction.trace == test_trace().token("digits", "3.25"));
+        auto zero_fraction = LEXY_VERIFY_RUNTIME("0.1");
+        CHECK(zero_fraction.status == test_result::success);
+        CHECK(zero_fraction.value == 100);
+        CHECK(zero_fraction.trace == test_trace().token("digits", "0.1"));
+
+        auto exponent = LEXY_VERIFY_RUNTIME("12e3");
+        CHECK(exponent.status == test_result::success);
+        CHECK(exponent.value == 12'000'000);
+        CHECK(exponent.trace == test_trace().token("digits", "12e3"));
+        auto exponent_sign = LEXY_VERIFY_RUNTIME("1.5E-3");
+        CHECK(exponent_sign.status == test_result::success);
+        CHECK(exponent_sign.value == 1);
+        CHECK(exponent_sign.trace == test_trace().token("digits", "1.5E-3"));
+        auto exponent_plus = LEXY_VERIFY_RUNTIME("1e+3");
+        CHECK(exponent_plus.status == test_result::success);
+        CHECK(exponent_plus.value == 1'000'000);
+        CHECK(exponent_plus.trace == test_trace().token("digits", "1e+3"));
+
+        auto long_number = LEXY_VERIFY_RUNTIME("3.14159265358979323846264338327950288");
+        CHECK(long_number.status == test_result::success);
+        CHECK(long_number.value == 3'141);
+        auto huge = LEXY_VERIFY_RUNTIME("1e400");
+        CHECK(huge.status == test_result::success);
+        CHECK(huge.value == -1);
+
+        auto missing_fraction = LEXY_VERIFY_RUNTIME("1.");
+        CHECK(missing_fraction.status == test_result::recovered_error);
+        CHECK(missing_fraction.value == 1'000);
+        CHECK(missing_fraction.trace
+              == test_trace()
+                     .expected_char_class(2, "digit.decimal")
+                     .recovery()
+                     .token("digits", "1."));
+        auto missing_exponent = LEXY_VERIFY_RUNTIME("1.5e+");
+        CHECK(missing_exponent.status == test_result::recovered_error);
+        CHECK(missing_exponent.value == 1'500);
+        CHECK(missing_exponent.trace
+              == test_trace()
+                     .expected_char_class(5, "digit.decimal")
+                     .recovery()
+                     .token("digits", "1.5e+"));
+    }
+    SUBCASE("as branch")
+    {
+        constexpr auto rule = dsl::if_(real);
+
+        auto empty = LEXY_VERIFY_RUNTIME("");
+        CHECK(empty.status == test_result::success);
+        CHECK(empty.value == -11);
+        CHECK(empty.trace == test_trace());
+
+        auto fraction = LEXY_VERIFY_RUNTIME("3.25");
+        CHECK(fraction.status == test_result::success);
+        CHECK(fraction.value == 3'250);
+        CHECK(fraction.trace == test_trace().token("digits", "3.25"));
+        auto exponent = LEXY_VERIFY_RUNTIME("1.5E-3");
+        CHECK(exponent.status == test_result::success);
+        CHECK(exponent.value == 1);
+        CHECK(exponent.trace == test_trace().token("digits", "1.5E-3"));
+
+        auto missing_fraction = LEXY_VERIFY_RUNTIME("1.");
+        CHECK(missing_fraction.status == test_result::success);
+        CHECK(missing_fraction.value == -11);
+        CHECK(missing_fraction.trace == test_trace());
+    }
+    SUBCASE("float")
+    {
+        constexpr auto rule = dsl::real<float>;
+        constexpr auto callback = lexy::callback<int>(
+            [](const char*, float value) { return static_cast<int>(value * 1000); });
+
+        auto fraction = LEXY_VERIFY_RUNTIME("0.1");
+        CHECK(fraction.status == test_result::success);
+        CHECK(fraction.value == 100);
+        auto exponent = LEXY_VERIFY_RUNTIME("2.5e-1");
+        CHECK(exponent.status == test_result::success);
+        CHECK(exponent.value == 250);
+    }
+    SUBCASE("with sign")
+    {
+        constexpr auto rule = dsl::minus_sign + real;
+        constexpr auto callback = lexy::callback<int>(
+            [](const char*, double value) { return static_cast<int>(value * 1000); },
+            [](const char*, lexy::minus_sign, double value) {
+                return static_cast<int>(-value * 1000);
+            });
+
+        auto positive = LEXY_VERIFY_RUNTIME("2.5");
+        CHECK(positive.status == test_result::success);
+        CHECK(positive.value == 2'500);
+        auto negative = LEXY_VERIFY_RUNTIME("-2.5");
+        CHECK(negative.status == test_result::success);
+        CHECK(negative.value == -2'500);
+        CHECK(negative.trace == test_trace().literal("-").token("digits", "2.5"));
+    }
+}
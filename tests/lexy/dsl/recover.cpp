@@ -44,6 +44,29 @@ TEST_CASE("dsl::find()")
     auto unterminated = LEXY_VERIFY("abc");
     CHECK(unterminated.status == test_result::fatal_error);
     CHECK(unterminated.trace == test_trace().recovery().error_token("abc").cancel().cancel());
+
+    auto long_garbage = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz"
+                                                                  "abcdefghijklmnopqrstuvwxyz"
+                                                                  "abcdefghijklmnopqrstuvwxyz;");
+    CHECK(long_garbage.status == test_result::success);
+    CHECK(long_garbage.trace
+          == test_trace()
+                 .recovery()
+                 .error_token("abcdefghijklmnopqrstuvwxyz"
+                              "abcdefghijklmnopqrstuvwxyz"
+                              "abcdefghijklmnopqrstuvwxyz")
+                 .finish());
+    auto long_unterminated
+        = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz"
+                                                  "abcdefghijklmnopqrstuvwxyz");
+    CHECK(long_unterminated.status == test_result::fatal_error);
+    CHECK(long_unterminated.trace
+          == test_trace()
+                 .recovery()
+                 .error_token("abcdefghijklmnopqrstuvwxyz"
+                              "abcdefghijklmnopqrstuvwxyz")
+                 .cancel()
+                 .cancel());
 }
 
 TEST_CASE("dsl::find().limit()")
@@ -85,6 +108,18 @@ TEST_CASE("dsl::find().limit()")
     auto limited = LEXY_VERIFY("abc;def");
     CHECK(limited.status == test_result::fatal_error);
     CHECK(limited.trace == test_trace().recovery().error_token("abc").cancel().cancel());
+
+    auto long_limited = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz"
+                                                                  "abcdefghijklmnopqrstuvwxyz"
+                                                                  ",def!");
+    CHECK(long_limited.status == test_result::fatal_error);
+    CHECK(long_limited.trace
+          == test_trace()
+                 .recovery()
+                 .error_token("abcdefghijklmnopqrstuvwxyz"
+                              "abcdefghijklmnopqrstuvwxyz")
+                 .cancel()
+                 .cancel());
 }
 
 TEST_CASE("dsl::recover()")
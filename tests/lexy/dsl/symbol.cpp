@@ -4,11 +4,13 @@
 #include <lexy/dsl/symbol.hpp>
 
 #include "verify.hpp"
+#include <cstdio>
 #include <lexy/dsl/ascii.hpp>
 #include <lexy/dsl/case_folding.hpp>
 #include <lexy/dsl/identifier.hpp>
 #include <lexy/dsl/if.hpp>
 #include <lexy/dsl/whitespace.hpp>
+#include <lexy/input/string_input.hpp>
 
 TEST_CASE("symbol_table")
 {
@@ -466,3 +468,313 @@ TEST_CASE("dsl::symbol with case folding")
     CHECK(Ab.trace == test_trace().token("identifier", "A"));
 }
 
+namespace
+{
+constexpr auto symbols_perfect_hash = lexy::symbol_table<int> //
+                                          .map<'A'>(1)
+                                          .map<'B'>(2)
+                                          .map<'C'>(3)
+                                          .map<LEXY_SYMBOL("Abc")>(4)
+                                          .map<LEXY_SYMBOL("Abcdefghijklmnopqrstuvwxyz")>(5)
+                                          .map<'B'>(6)
+                                          .perfect_hash();
+constexpr auto symbols_perfect_hash_case_folded
+    = lexy::symbol_table<int>.case_folding(dsl::ascii::case_folding)
+          .perfect_hash()
+          .map<'a'>(1)
+          .map<LEXY_SYMBOL("abc")>(4);
+
+// A table with the symbols "k0000" to "k1023".
+// We don't need the mapped values, so we can spell the type instead of calling map() 1024 times.
+constexpr auto generated_symbol_count = std::size_t(1024);
+
+template <std::size_t Idx>
+using generated_symbol
+    = lexy::_detail::type_string<char, 'k', char('0' + Idx / 1000 % 10), char('0' + Idx / 100 % 10),
+                                 char('0' + Idx / 10 % 10), char('0' + Idx % 10)>;
+
+template <std::size_t... Idx>
+auto generated_symbol_table(lexy::_detail::index_sequence<Idx...>)
+    -> lexy::_symbol_table<int, lexy::_detail::lit_no_case_fold, true, generated_symbol<Idx>...>;
+
+constexpr auto symbols_perfect_hash_generated = decltype(generated_symbol_table(
+    lexy::_detail::make_index_sequence<generated_symbol_count>{})){};
+} // namespace
+
+TEST_CASE("dsl::symbol with perfect hash")
+{
+    SUBCASE("token")
+    {
+        constexpr auto rule
+            = dsl::symbol<symbols_perfect_hash>(dsl::token(dsl::identifier(dsl::ascii::alpha)));
+        CHECK(lexy::is_branch_rule<decltype(rule)>);
+
+        auto A = LEXY_VERIFY("A");
+        CHECK(A.status == test_result::success);
+        CHECK(A.value == 1);
+        CHECK(A.trace == test_trace().token("A"));
+        auto B = LEXY_VERIFY("B");
+        CHECK(B.status == test_result::success);
+        CHECK(B.value == 6);
+        CHECK(B.trace == test_trace().token("B"));
+        auto Abc = LEXY_VERIFY("Abc");
+        CHECK(Abc.status == test_result::success);
+        CHECK(Abc.value == 4);
+        CHECK(Abc.trace == test_trace().token("Abc"));
+        auto alphabet = LEXY_VERIFY("Abcdefghijklmnopqrstuvwxyz");
+        CHECK(alphabet.status == test_result::success);
+        CHECK(alphabet.value == 5);
+        CHECK(alphabet.trace == test_trace().token("Abcdefghijklmnopqrstuvwxyz"));
+
+        auto Ab = LEXY_VERIFY("Ab");
+        CHECK(Ab.status == test_result::fatal_error);
+        CHECK(Ab.trace == test_trace().token("Ab").error(0, 2, "unknown symbol").cancel());
+        auto Abd = LEXY_VERIFY("Abd");
+        CHECK(Abd.status == test_result::fatal_error);
+        CHECK(Abd.trace == test_trace().token("Abd").error(0, 3, "unknown symbol").cancel());
+    }
+    SUBCASE("identifier")
+    {
+        constexpr auto symbol
+            = dsl::symbol<symbols_perfect_hash>(dsl::identifier(dsl::ascii::alpha));
+        CHECK(lexy::is_branch_rule<decltype(symbol)>);
+
+        struct production : test_production_for<decltype(symbol)>, with_whitespace
+        {};
+
+        auto empty = LEXY_VERIFY_P(production, "");
+        CHECK(empty.status == test_result::fatal_error);
+        CHECK(empty.trace == test_trace().expected_char_class(0, "ASCII.alpha").cancel());
+
+        auto A = LEXY_VERIFY_P(production, "A");
+        CHECK(A.status == test_result::success);
+        CHECK(A.value == 1);
+        CHECK(A.trace == test_trace().token("identifier", "A"));
+        auto Abc = LEXY_VERIFY_P(production, "Abc");
+        CHECK(Abc.status == test_result::success);
+        CHECK(Abc.value == 4);
+        CHECK(Abc.trace == test_trace().token("identifier", "Abc"));
+
+        auto Ab = LEXY_VERIFY_P(production, "Ab");
+        CHECK(Ab.status == test_result::fatal_error);
+        CHECK(Ab.trace
+              == test_trace().token("identifier", "Ab").error(0, 2, "unknown symbol").cancel());
+        auto Abcd = LEXY_VERIFY_P(production, "Abcd");
+        CHECK(Abcd.status == test_result::fatal_error);
+        CHECK(Abcd.trace
+              == test_trace().token("identifier", "Abcd").error(0, 4, "unknown symbol").cancel());
+
+        auto whitespace = LEXY_VERIFY_P(production, "Abc...");
+        CHECK(whitespace.status == test_result::success);
+        CHECK(whitespace.value == 4);
+        CHECK(whitespace.trace == test_trace().token("identifier", "Abc").whitespace("..."));
+    }
+    SUBCASE("identifier as branch")
+    {
+        constexpr auto rule
+            = dsl::if_(dsl::symbol<symbols_perfect_hash>(dsl::identifier(dsl::ascii::alpha)));
+
+        auto Abc = LEXY_VERIFY("Abc");
+        CHECK(Abc.status == test_result::success);
+        CHECK(Abc.value == 4);
+        CHECK(Abc.trace == test_trace().token("identifier", "Abc"));
+        auto Abcd = LEXY_VERIFY("Abcd");
+        CHECK(Abcd.status == test_result::success);
+        CHECK(Abcd.value == 0);
+        CHECK(Abcd.trace == test_trace());
+    }
+    SUBCASE("case folding")
+    {
+        constexpr auto rule = dsl::symbol<symbols_perfect_hash_case_folded>(
+            dsl::identifier(dsl::ascii::alpha));
+
+        auto A = LEXY_VERIFY("A");
+        CHECK(A.status == test_result::success);
+        CHECK(A.value == 1);
+        CHECK(A.trace == test_trace().token("identifier", "A"));
+        auto aBC = LEXY_VERIFY("aBC");
+        CHECK(aBC.status == test_result::success);
+        CHECK(aBC.value == 4);
+        CHECK(aBC.trace == test_trace().token("identifier", "aBC"));
+
+        auto ab = LEXY_VERIFY("ab");
+        CHECK(ab.status == test_result::fatal_error);
+        CHECK(ab.trace
+              == test_trace().token("identifier", "ab").error(0, 2, "unknown symbol").cancel());
+    }
+    SUBCASE("many symbols")
+    {
+        constexpr auto& table = symbols_perfect_hash_generated;
+        using table_type      = LEXY_DECAY_DECLTYPE(table);
+        CHECK(table.size() == generated_symbol_count);
+
+        char str[16];
+        for (auto i = std::size_t(0); i != generated_symbol_count; ++i)
+        {
+            std::snprintf(str, sizeof(str), "k%04zu", i);
+            INFO(str);
+            CHECK(table.parse(lexy::zstring_input(str)) == table_type::key_index(i));
+        }
+
+        // Out of range, prefixes and extensions of symbols, and characters at the wrong place.
+        const char* unknown[]
+            = {"", "k", "k0", "k000", "k1024", "k9999", "k00000", "k10230", "0k000", "x0000"};
+        for (auto str : unknown)
+        {
+            INFO(str);
+            CHECK(!table.parse(lexy::zstring_input(str)));
+        }
+
+        constexpr auto rule
+            = dsl::symbol<symbols_perfect_hash_generated>(dsl::identifier(dsl::ascii::alnum));
+
+        auto last = LEXY_VERIFY("k1023");
+        CHECK(last.status == test_result::success);
+        CHECK(last.trace == test_trace().token("identifier", "k1023"));
+
+        auto out_of_range = LEXY_VERIFY("k1024");
+        CHECK(out_of_range.status == test_result::fatal_error);
+        CHECK(out_of_range.trace
+              == test_trace().token("identifier", "k1024").error(0, 5, "unknown symbol").cancel());
+    }
+}
+
+TEST_CASE("runtime_symbol_table")
+{
+    SUBCASE("empty")
+    {
+        lexy::runtime_symbol_table<int> table;
+        CHECK(table.empty());
+        CHECK(table.size() == 0);
+        CHECK(table.begin() == table.end());
+
+        CHECK(!table.parse(lexy::zstring_input("")));
+        CHECK(!table.parse(lexy::zstring_input("a")));
+    }
+    SUBCASE("non-empty")
+    {
+        std::pair<lexy::_detail::string_view, int> mappings[]
+            = {{"a", 0}, {"b", 1}, {"abc", 2}, {"b", 3}};
+        lexy::runtime_symbol_table<int> table(mappings);
+        CHECK(!table.empty());
+        CHECK(table.size() == 3);
+
+        auto iter = table.begin();
+        CHECK(iter != table.end());
+        CHECK(iter->symbol == lexy::_detail::string_view("a"));
+        CHECK(iter->value == 0);
+
+        ++iter;
+        CHECK(iter != table.end());
+        CHECK(iter->symbol == lexy::_detail::string_view("b"));
+        CHECK(iter->value == 3);
+
+        ++iter;
+        CHECK(iter != table.end());
+        CHECK(iter->symbol == lexy::_detail::string_view("abc"));
+        CHECK(iter->value == 2);
+
+        ++iter;
+        CHECK(iter == table.end());
+
+        auto abc = table.parse(lexy::zstring_input("abc"));
+        CHECK(abc);
+        CHECK(table[abc] == 2);
+        CHECK(!table.parse(lexy::zstring_input("ab")));
+        CHECK(!table.parse(lexy::zstring_input("abcd")));
+
+        auto moved = LEXY_MOV(table);
+        CHECK(table.empty());
+        CHECK(moved.size() == 3);
+        CHECK(moved[moved.parse(lexy::zstring_input("b"))] == 3);
+
+        // Through a reference, so the compiler doesn't warn about the self move.
+        auto& self = moved;
+        moved      = LEXY_MOV(self);
+        CHECK(moved.size() == 3);
+        CHECK(moved[moved.parse(lexy::zstring_input("b"))] == 3);
+    }
+}
+
+namespace
+{
+// In the tests, the parse state is the test handler, so we can't store the table in it.
+const std::pair<lexy::_detail::string_view, int> runtime_mappings[]
+    = {{"A", 1}, {"B", 2}, {"C", 3}, {"Abc", 4}};
+const lexy::runtime_symbol_table<int> runtime_symbols(runtime_mappings);
+
+constexpr auto get_runtime_symbols
+    = [](const auto&) -> const lexy::runtime_symbol_table<int>& { return runtime_symbols; };
+} // namespace
+
+TEST_CASE("dsl::symbol with runtime symbol table")
+{
+    SUBCASE("basic")
+    {
+        constexpr auto rule = dsl::symbol<get_runtime_symbols>;
+        CHECK(lexy::is_branch_rule<decltype(rule)>);
+
+        auto empty = LEXY_VERIFY_RUNTIME("");
+        CHECK(empty.status == test_result::fatal_error);
+        CHECK(empty.trace == test_trace().error(0, 0, "unknown symbol").cancel());
+
+        auto A = LEXY_VERIFY_RUNTIME("A");
+        CHECK(A.status == test_result::success);
+        CHECK(A.value == 1);
+        CHECK(A.trace == test_trace().token("identifier", "A"));
+        auto Abc = LEXY_VERIFY_RUNTIME("Abc");
+        CHECK(Abc.status == test_result::success);
+        CHECK(Abc.value == 4);
+        CHECK(Abc.trace == test_trace().token("identifier", "Abc"));
+
+        auto Ab = LEXY_VERIFY_RUNTIME("Ab");
+        CHECK(Ab.status == test_result::success);
+        CHECK(Ab.value == 1);
+        CHECK(Ab.trace == test_trace().token("identifier", "A"));
+    }
+    SUBCASE("token")
+    {
+        constexpr auto rule
+            = dsl::symbol<get_runtime_symbols>(dsl::token(dsl::identifier(dsl::ascii::alpha)));
+        CHECK(lexy::is_branch_rule<decltype(rule)>);
+
+        auto Abc = LEXY_VERIFY_RUNTIME("Abc");
+        CHECK(Abc.status == test_result::success);
+        CHECK(Abc.value == 4);
+        CHECK(Abc.trace == test_trace().token("Abc"));
+
+        auto Ab = LEXY_VERIFY_RUNTIME("Ab");
+        CHECK(Ab.status == test_result::fatal_error);
+        CHECK(Ab.trace == test_trace().token("Ab").error(0, 2, "unknown symbol").cancel());
+    }
+    SUBCASE("identifier")
+    {
+        constexpr auto rule
+            = dsl::symbol<get_runtime_symbols>(dsl::identifier(dsl::ascii::alpha));
+        CHECK(lexy::is_branch_rule<decltype(rule)>);
+
+        auto B = LEXY_VERIFY_RUNTIME("B");
+        CHECK(B.status == test_result::success);
+        CHECK(B.value == 2);
+        CHECK(B.trace == test_trace().token("identifier", "B"));
+
+        auto Abcd = LEXY_VERIFY_RUNTIME("Abcd");
+        CHECK(Abcd.status == test_result::fatal_error);
+        CHECK(Abcd.trace
+              == test_trace().token("identifier", "Abcd").error(0, 4, "unknown symbol").cancel());
+    }
+    SUBCASE("identifier as branch")
+    {
+        constexpr auto rule
+            = dsl::if_(dsl::symbol<get_runtime_symbols>(dsl::identifier(dsl::ascii::alpha)));
+
+        auto Abc = LEXY_VERIFY_RUNTIME("Abc");
+        CHECK(Abc.status == test_result::success);
+        CHECK(Abc.value == 4);
+        CHECK(Abc.trace == test_trace().token("identifier", "Abc"));
+        auto Abcd = LEXY_VERIFY_RUNTIME("Abcd");
+        CHECK(Abcd.status == test_result::success);
+        CHECK(Abcd.value == 0);
+        CHECK(Abcd.trace == test_trace());
+    }
+}
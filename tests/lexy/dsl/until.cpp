@@ -68,6 +68,15 @@ TEST_CASE("dsl::until()")
         CHECK(partial_before.trace
               == test_trace().token("any", "abcdefghijklmno\\rpqrstuvwxyz\\n"));
 
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz"
+                                                              "abcdefghijklmnopqrstuvwxyz"
+                                                              "\rabcdefghijklmnopqrstuvwxyz\n");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().token("any", "abcdefghijklmnopqrstuvwxyz"
+                                           "abcdefghijklmnopqrstuvwxyz"
+                                           "\\rabcdefghijklmnopqrstuvwxyz\\n"));
+
         auto unterminated = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz");
         CHECK(unterminated.status == test_result::fatal_error);
         CHECK(unterminated.trace
@@ -76,6 +85,82 @@ TEST_CASE("dsl::until()")
                      .error(26, 26, "expected newline")
                      .cancel());
     }
+    SUBCASE("literal skip")
+    {
+        constexpr auto rule = dsl::until(LEXY_LIT("*/"));
+        CHECK(lexy::is_token_rule<decltype(rule)>);
+
+        auto few = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abc*/");
+        CHECK(few.status == test_result::success);
+        CHECK(few.trace == test_trace().token("any", "abc*/"));
+
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz"
+                                                              "abcdefghijklm*nopqrstuvwxyz"
+                                                              "abcdefghijklm/nopqrstuvwxyz*/");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().token("any", "abcdefghijklmnopqrstuvwxyz"
+                                           "abcdefghijklm*nopqrstuvwxyz"
+                                           "abcdefghijklm/nopqrstuvwxyz*/"));
+
+        auto non_ascii = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz"
+                                                                   "\u00E4bcdefghijklmnopqrstuvwxyz"
+                                                                   "**/");
+        CHECK(non_ascii.status == test_result::success);
+        CHECK(non_ascii.trace
+              == test_trace().token("any", "abcdefghijklmnopqrstuvwxyz"
+                                           "\\u00E4bcdefghijklmnopqrstuvwxyz"
+                                           "**/"));
+
+        auto unterminated = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdefghijklmnopqrstuvwxyz"
+                                                                      "abcdefghijklmnopqrstuvwxyz*");
+        CHECK(unterminated.status == test_result::fatal_error);
+        CHECK(unterminated.trace
+              == test_trace()
+                     .error_token("abcdefghijklmnopqrstuvwxyz"
+                                  "abcdefghijklmnopqrstuvwxyz*")
+                     .expected_literal(53, "*/", 0)
+                     .cancel());
+    }
+    SUBCASE("literal set skip")
+    {
+        constexpr auto rule = dsl::until(
+            dsl::literal_set(LEXY_LIT("!"), LEXY_LIT("."), LEXY_LIT(";"), LEXY_LIT(","),
+                             LEXY_LIT("?"), LEXY_LIT("end")));
+        CHECK(lexy::is_token_rule<decltype(rule)>);
+
+        auto few = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abc?");
+        CHECK(few.status == test_result::success);
+        CHECK(few.trace == test_trace().token("any", "abc?"));
+
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdfghijklmnopqrstuvwxyz"
+                                                              "abcdefghijklmnopqrstuvwxyz"
+                                                              "abcdefghijklmnopqrstuvwxyz.");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().token("any", "abcdfghijklmnopqrstuvwxyz"
+                                           "abcdefghijklmnopqrstuvwxyz"
+                                           "abcdefghijklmnopqrstuvwxyz."));
+
+        auto word = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdfghijklmnopqrstuvwxyz"
+                                                              "abcdfghijklmnopqrstuvwxyz"
+                                                              "abcdfghijklmnopqrstuvwxyzend");
+        CHECK(word.status == test_result::success);
+        CHECK(word.trace
+              == test_trace().token("any", "abcdfghijklmnopqrstuvwxyz"
+                                           "abcdfghijklmnopqrstuvwxyz"
+                                           "abcdfghijklmnopqrstuvwxyzend"));
+
+        auto unterminated = LEXY_VERIFY(lexy::utf8_char_encoding{}, "abcdfghijklmnopqrstuvwxyz"
+                                                                      "abcdfghijklmnopqrstuvwxyz");
+        CHECK(unterminated.status == test_result::fatal_error);
+        CHECK(unterminated.trace
+              == test_trace()
+                     .error_token("abcdfghijklmnopqrstuvwxyz"
+                                  "abcdfghijklmnopqrstuvwxyz")
+                     .error(50, 50, "expected literal set")
+                     .cancel());
+    }
 }
 
 TEST_CASE("dsl::until().or_eof()")
@@ -4,9 +4,12 @@
 #include <lexy/dsl/whitespace.hpp>
 
 #include "verify.hpp"
+#include <lexy/dsl/ascii.hpp>
 #include <lexy/dsl/if.hpp>
+#include <lexy/dsl/newline.hpp>
 #include <lexy/dsl/production.hpp>
 #include <lexy/dsl/recover.hpp>
+#include <lexy/dsl/until.hpp>
 
 namespace
 {
@@ -275,6 +278,104 @@ TEST_CASE("dsl::whitespace")
         CHECK(trailing_whitespace.status == test_result::success);
         CHECK(trailing_whitespace.trace == test_trace().whitespace("abc"));
     }
+    SUBCASE("char class")
+    {
+        constexpr auto rule = dsl::whitespace(dsl::ascii::space);
+        CHECK(lexy::is_rule<decltype(rule)>);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::success);
+        CHECK(empty.trace == test_trace());
+
+        auto mixed = LEXY_VERIFY(" \t\n x");
+        CHECK(mixed.status == test_result::success);
+        CHECK(mixed.trace == test_trace().whitespace("\\u0020\\t\\n\\u0020"));
+
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{}, "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"
+                                                            "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"
+                                                            "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"
+                                                            "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\nx");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().whitespace("\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t"
+                                         "\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n"
+                                         "\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t"
+                                         "\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n"));
+    }
+    SUBCASE("choice with char class")
+    {
+        constexpr auto rule
+            = dsl::whitespace(dsl::ascii::space | LEXY_LIT("//") >> dsl::until(dsl::newline));
+        CHECK(lexy::is_rule<decltype(rule)>);
+
+        auto empty = LEXY_VERIFY("");
+        CHECK(empty.status == test_result::success);
+        CHECK(empty.trace == test_trace());
+
+        auto space = LEXY_VERIFY("\t\tx");
+        CHECK(space.status == test_result::success);
+        CHECK(space.trace == test_trace().whitespace("\\t\\t"));
+        auto comment = LEXY_VERIFY("//abc\n");
+        CHECK(comment.status == test_result::success);
+        CHECK(comment.trace == test_trace().whitespace("//abc\\n"));
+        auto mixed = LEXY_VERIFY("\t//abc\n\t\t//def\n\tx");
+        CHECK(mixed.status == test_result::success);
+        CHECK(mixed.trace == test_trace().whitespace("\\t//abc\\n\\t\\t//def\\n\\t"));
+        auto slash = LEXY_VERIFY("\t\t/x");
+        CHECK(slash.status == test_result::success);
+        CHECK(slash.trace == test_trace().whitespace("\\t\\t"));
+
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{}, "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"
+                                                            "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"
+                                                            "//abcdefghijklmnopqrstuvwxyz\n"
+                                                            "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t"
+                                                            "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\nx");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().whitespace("\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t"
+                                         "\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n"
+                                         "//abcdefghijklmnopqrstuvwxyz\\n"
+                                         "\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t\\t"
+                                         "\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n\\n"));
+
+        auto ws_failure = LEXY_VERIFY("\t\t//abc");
+        CHECK(ws_failure.status == test_result::fatal_error);
+        CHECK(ws_failure.trace
+              == test_trace().error(7, 7, "expected newline").error_token("\\t\\t//abc").cancel());
+    }
+    SUBCASE("choice with char class after overlapping branch")
+    {
+        // The char class must not skip the newline, as the comment is tried first.
+        constexpr auto rule
+            = dsl::whitespace(LEXY_LIT("\n#") >> dsl::until(dsl::newline) | dsl::ascii::space);
+        CHECK(lexy::is_rule<decltype(rule)>);
+
+        auto comment = LEXY_VERIFY(" \n#abc\n x");
+        CHECK(comment.status == test_result::success);
+        CHECK(comment.trace == test_trace().whitespace("\\u0020\\n#abc\\n\\u0020"));
+
+        // The spaces can be skipped at once, but not the newline after them.
+        auto simd = LEXY_VERIFY(lexy::utf8_char_encoding{}, "                                "
+                                                            "\n#abcdefghijklmnopqrstuvwxyz\nx");
+        CHECK(simd.status == test_result::success);
+        CHECK(simd.trace
+              == test_trace().whitespace("\\u0020\\u0020\\u0020\\u0020"
+                                         "\\u0020\\u0020\\u0020\\u0020"
+                                         "\\u0020\\u0020\\u0020\\u0020"
+                                         "\\u0020\\u0020\\u0020\\u0020"
+                                         "\\u0020\\u0020\\u0020\\u0020"
+                                         "\\u0020\\u0020\\u0020\\u0020"
+                                         "\\u0020\\u0020\\u0020\\u0020"
+                                         "\\u0020\\u0020\\u0020\\u0020"
+                                         "\\n#abcdefghijklmnopqrstuvwxyz\\n"));
+
+        using no_class = LEXY_DECAY_DECLTYPE(rule);
+        CHECK(std::is_void_v<lexy::_detail::ws_char_class<no_class, lexy::utf8_encoding>>);
+        using disjoint_class = decltype(LEXY_LIT("//") >> dsl::until(dsl::newline)
+                                        | dsl::ascii::space);
+        CHECK(std::is_same_v<lexy::_detail::ws_char_class<disjoint_class, lexy::utf8_encoding>,
+                             LEXY_DECAY_DECLTYPE(dsl::ascii::space)>);
+    }
 
     SUBCASE("operator|")
     {
@@ -0,0 +1,255 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/grammar_analysis.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/dsl.hpp>
+
+namespace
+{
+namespace dsl = lexy::dsl;
+
+constexpr lexy::grammar_char_set char_set(const char* str)
+{
+    lexy::grammar_char_set result;
+    while (*str)
+        result.insert(static_cast<unsigned char>(*str++));
+    return result;
+}
+
+constexpr bool equal(const lexy::grammar_char_set& lhs, const lexy::grammar_char_set& rhs)
+{
+    if (lhs.known != rhs.known)
+        return false;
+    for (auto i = 0; i != 256; ++i)
+        if (lhs.contains[i] != rhs.contains[i])
+            return false;
+    return true;
+}
+
+struct number
+{
+    static constexpr auto name = "number";
+    static constexpr auto rule = dsl::digits<>;
+};
+
+struct boolean
+{
+    static constexpr auto name = "boolean";
+    static constexpr auto rule = LEXY_LIT("true") | LEXY_LIT("false");
+};
+
+struct list
+{
+    static constexpr auto name = "list";
+    static constexpr auto rule
+        = dsl::square_bracketed.opt_list(dsl::recurse<struct value>, dsl::sep(dsl::comma));
+};
+
+struct value
+{
+    static constexpr auto name = "value";
+    static constexpr auto rule = dsl::p<number> | dsl::p<boolean> | dsl::p<list>;
+};
+
+struct document
+{
+    static constexpr auto name       = "document";
+    static constexpr auto whitespace = dsl::ascii::space;
+    static constexpr auto rule       = dsl::p<value> + dsl::eof;
+};
+} // namespace
+
+TEST_CASE("grammar_analysis productions")
+{
+    using analysis = lexy::grammar_analysis<document>;
+    CHECK(analysis::production_count == 5);
+    CHECK(analysis::production_index<document>() == 0);
+    CHECK(analysis::production_index<value>() == 1);
+
+    constexpr auto& doc = analysis::production<document>();
+    CHECK(lexy::_detail::string_view(doc.name) == "document");
+    CHECK(equal(doc.first, char_set(" \t\n\r\f\v0123456789tf[")));
+    CHECK(!doc.nullable);
+    CHECK(equal(doc.follow, char_set("")));
+
+    constexpr auto& val = analysis::production<value>();
+    CHECK(equal(val.first, char_set("0123456789tf[")));
+    CHECK(!val.nullable);
+    CHECK(equal(val.follow, char_set(",]")));
+
+    constexpr auto& num = analysis::production<number>();
+    CHECK(equal(num.first, char_set("0123456789")));
+    CHECK(equal(num.follow, char_set(",]")));
+
+    constexpr auto& lst = analysis::production<list>();
+    CHECK(equal(lst.first, char_set("[")));
+    CHECK(!lst.nullable);
+
+    CHECK(analysis::hazard_count == 0);
+}
+
+namespace
+{
+struct nullable_prod
+{
+    static constexpr auto name = "nullable_prod";
+    static constexpr auto rule = dsl::opt(dsl::lit_c<'a'> >> dsl::lit_c<'b'>);
+};
+
+struct nullable_seq
+{
+    static constexpr auto name = "nullable_seq";
+    static constexpr auto rule = dsl::p<nullable_prod> + dsl::while_(dsl::lit_c<'c'>)
+                                 + dsl::lit_c<'d'>;
+};
+} // namespace
+
+TEST_CASE("grammar_analysis nullable")
+{
+    using analysis = lexy::grammar_analysis<nullable_seq>;
+
+    constexpr auto& seq = analysis::production<nullable_seq>();
+    CHECK(equal(seq.first, char_set("acd")));
+    CHECK(!seq.nullable);
+
+    constexpr auto& prod = analysis::production<nullable_prod>();
+    CHECK(equal(prod.first, char_set("a")));
+    CHECK(prod.nullable);
+    CHECK(equal(prod.follow, char_set("cd")));
+}
+
+namespace
+{
+struct keyword_overlap
+{
+    static constexpr auto name = "keyword_overlap";
+    static constexpr auto rule
+        = LEXY_LIT("integer") | LEXY_LIT("interval") | LEXY_LIT("in") | LEXY_LIT("out");
+};
+} // namespace
+
+TEST_CASE("grammar_analysis choice")
+{
+    using analysis = lexy::grammar_analysis<keyword_overlap>;
+    REQUIRE(analysis::hazard_count == 3);
+
+    constexpr auto& first = analysis::hazard(0);
+    CHECK(first.kind == lexy::grammar_hazard_kind::choice_overlap);
+    CHECK(first.production == 0);
+    CHECK(first.decision == 0);
+    CHECK(first.branch == 1);
+    CHECK(first.other_branch == 0);
+    CHECK(lexy::_detail::string_view(first.branch_name) == "interval");
+    CHECK(lexy::_detail::string_view(first.other_branch_name) == "integer");
+    CHECK(equal(first.overlap, char_set("i")));
+    CHECK(first.lookahead == 5);
+
+    constexpr auto& second = analysis::hazard(1);
+    CHECK(second.kind == lexy::grammar_hazard_kind::choice_overlap);
+    CHECK(second.branch == 2);
+    CHECK(second.other_branch == 0);
+    CHECK(second.lookahead == 3);
+
+    constexpr auto& third = analysis::hazard(2);
+    CHECK(third.kind == lexy::grammar_hazard_kind::choice_overlap);
+    CHECK(third.branch == 2);
+    CHECK(third.other_branch == 1);
+    CHECK(third.lookahead == 3);
+}
+
+namespace
+{
+struct shadowed
+{
+    static constexpr auto name = "shadowed";
+    static constexpr auto rule
+        = LEXY_LIT("in") | LEXY_LIT("int") | dsl::else_ >> dsl::lit_c<'x'> | dsl::lit_c<'y'>;
+};
+
+struct unknown
+{
+    static constexpr auto name = "unknown";
+    static constexpr auto rule
+        = dsl::peek(dsl::until(dsl::lit_c<';'>)) >> dsl::lit_c<'a'> | dsl::lit_c<'b'>;
+};
+} // namespace
+
+TEST_CASE("grammar_analysis shadowed and unknown branches")
+{
+    SUBCASE("shadowed")
+    {
+        using analysis = lexy::grammar_analysis<shadowed>;
+        REQUIRE(analysis::hazard_count == 2);
+
+        constexpr auto& prefix = analysis::hazard(0);
+        CHECK(prefix.kind == lexy::grammar_hazard_kind::choice_shadowed);
+        CHECK(prefix.branch == 1);
+        CHECK(prefix.other_branch == 0);
+
+        constexpr auto& fallback = analysis::hazard(1);
+        CHECK(fallback.kind == lexy::grammar_hazard_kind::choice_shadowed);
+        CHECK(fallback.branch == 3);
+        CHECK(fallback.other_branch == 2);
+        CHECK(lexy::_detail::string_view(fallback.branch_name) == "y");
+        CHECK(fallback.other_branch_name == nullptr);
+    }
+    SUBCASE("unknown")
+    {
+        using analysis = lexy::grammar_analysis<unknown>;
+        REQUIRE(analysis::hazard_count == 1);
+
+        constexpr auto& hazard = analysis::hazard(0);
+        CHECK(hazard.kind == lexy::grammar_hazard_kind::choice_unknown);
+        CHECK(hazard.branch == 0);
+        CHECK(hazard.other_branch == lexy::grammar_hazard::npos);
+        CHECK(hazard.lookahead == lexy::grammar_hazard::npos);
+    }
+}
+
+namespace
+{
+struct opt_overlap
+{
+    static constexpr auto name = "opt_overlap";
+    static constexpr auto rule = dsl::if_(dsl::lit_c<'-'>) + dsl::lit_c<'-'>
+                                 + dsl::while_(dsl::lit_c<'+'>) + dsl::lit_c<'+'>;
+};
+
+struct list_overlap
+{
+    static constexpr auto name = "list_overlap";
+    static constexpr auto rule
+        = dsl::list(dsl::lit_c<'a'>, dsl::sep(dsl::comma)) + dsl::lit_c<','> + dsl::lit_c<'b'>;
+};
+} // namespace
+
+TEST_CASE("grammar_analysis optional and loop")
+{
+    SUBCASE("optional and while")
+    {
+        using analysis = lexy::grammar_analysis<opt_overlap>;
+        REQUIRE(analysis::hazard_count == 2);
+
+        constexpr auto& opt = analysis::hazard(0);
+        CHECK(opt.kind == lexy::grammar_hazard_kind::optional_overlap);
+        CHECK(opt.decision == 0);
+        CHECK(equal(opt.overlap, char_set("-")));
+        CHECK(opt.lookahead == 1);
+
+        constexpr auto& loop = analysis::hazard(1);
+        CHECK(loop.kind == lexy::grammar_hazard_kind::loop_overlap);
+        CHECK(loop.decision == 1);
+        CHECK(equal(loop.overlap, char_set("+")));
+    }
+    SUBCASE("list")
+    {
+        using analysis = lexy::grammar_analysis<list_overlap>;
+        REQUIRE(analysis::hazard_count == 1);
+
+        constexpr auto& list = analysis::hazard(0);
+        CHECK(list.kind == lexy::grammar_hazard_kind::loop_overlap);
+        CHECK(equal(list.overlap, char_set(",")));
+    }
+}
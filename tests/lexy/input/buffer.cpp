@@ -4,8 +4,14 @@
 #include <lexy/input/buffer.hpp>
 
 #include <doctest/doctest.h>
+#include <lexy/action/match.hpp>
+#include <lexy/dsl/any.hpp>
+#include <lexy/dsl/eof.hpp>
+#include <lexy/dsl/sequence.hpp>
 #include <lexy/input/argv_input.hpp>
 #include <lexy/input/string_input.hpp>
+#include <string>
+#include <vector>
 
 #if defined(__has_include) && __has_include(<memory_resource>) && !defined(_LIBCPP_VERSION)
 #    include <memory_resource>
@@ -14,6 +20,14 @@
 #    define LEXY_HAS_RESOURCE 0
 #endif
 
+namespace
+{
+struct any_production
+{
+    static constexpr auto rule = lexy::dsl::any + lexy::dsl::eof;
+};
+} // namespace
+
 TEST_CASE("buffer")
 {
     static const char str[] = {'a', 'b', 'c'};
@@ -276,6 +290,64 @@ TEST_CASE("buffer")
         CHECK(reader.peek() == 0xFF);
         CHECK(reader.peek_swar() == 0xFFFFFFFFFFFFFFFF);
     }
+    SUBCASE("reader, padding, swar")
+    {
+        REQUIRE(sizeof(lexy::_detail::swar_int) == 8);
+
+        const char16_t str[] = {0x0011, 0x2233, 0xFFFF, 0x4455, 0x6677};
+        const lexy::buffer<lexy::utf16_encoding> buffer(str, 5);
+
+        auto reader = buffer.reader();
+        CHECK(lexy::_detail::is_swar_reader<decltype(reader)>);
+        CHECK(reader.position() == buffer.data());
+        CHECK(reader.peek_swar() == 0x4455FFFF22330011);
+
+        reader.bump_swar();
+        CHECK(reader.position() == buffer.data() + 4);
+        CHECK(reader.peek() == 0x6677);
+        // The padding looks like a valid character, but peek() knows better.
+        CHECK(reader.peek_swar() == 0xFFFFFFFFFFFF6677);
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::utf16_encoding::eof());
+    }
+    SUBCASE("reader, padding, byte")
+    {
+        const unsigned char str[] = {0xFF, 0xFF};
+        const lexy::buffer<lexy::byte_encoding> buffer(str, 2);
+
+        auto reader = buffer.reader();
+        CHECK(lexy::_detail::is_swar_reader<decltype(reader)>);
+        CHECK(reader.peek() == 0xFF);
+
+        reader.bump();
+        CHECK(reader.peek() == 0xFF);
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::byte_encoding::eof());
+
+        // SWAR loops need to handle bytes that look like the padding.
+        const unsigned char long_str[]
+            = {0x01, 0x02, 0xFF, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF, 0xFF, 0x0A};
+        const lexy::buffer<lexy::byte_encoding> long_buffer(long_str, sizeof(long_str));
+        CHECK(lexy::match<any_production>(long_buffer));
+    }
+
+    SUBCASE("UTF-8 validation")
+    {
+        lexy::buffer<lexy::utf8_encoding> buffer("ab\u00E4\u20AC", 7);
+        CHECK(lexy::validate_utf8(buffer));
+        CHECK(!lexy::_detail::is_utf8_validated_reader<decltype(buffer.reader())>);
+
+        auto reader = lexy::_utf8_validated_reader(buffer.reader());
+        CHECK(lexy::_detail::is_utf8_validated_reader<decltype(reader)>);
+        CHECK(sizeof(buffer.reader()) == sizeof(void*));
+        CHECK(sizeof(reader) == sizeof(void*));
+        CHECK(reader.position() == buffer.data());
+
+        const lexy::buffer<lexy::utf8_encoding> ill_formed("ab\xFF", 3);
+        CHECK(!lexy::validate_utf8(ill_formed));
+    }
 }
 
 TEST_CASE("make_buffer_from_raw")
@@ -459,6 +531,164 @@ TEST_CASE("make_buffer_from_raw")
         CHECK(big_bom.size() == 1);
         CHECK(big_bom.data()[0] == 0x00112233);
     }
+    SUBCASE("long input")
+    {
+        // Long enough to use the vectorized byte swap.
+        unsigned char str[4 * 101];
+        for (auto i = 0u; i != sizeof(str); ++i)
+            str[i] = static_cast<unsigned char>(i);
+
+        auto utf16 = lexy::make_buffer_from_raw<lexy::utf16_encoding,
+                                                lexy::encoding_endianness::big>(str, sizeof(str));
+        REQUIRE(utf16.size() == 2 * 101);
+        for (auto i = 0u; i != utf16.size(); ++i)
+            CHECK(utf16.data()[i] == ((str[2 * i] << 8) | str[2 * i + 1]));
+
+        auto utf32 = lexy::make_buffer_from_raw<lexy::utf32_encoding,
+                                                lexy::encoding_endianness::big>(str, sizeof(str));
+        REQUIRE(utf32.size() == 101);
+        for (auto i = 0u; i != utf32.size(); ++i)
+            CHECK(utf32.data()[i]
+                  == ((char32_t(str[4 * i]) << 24) | (char32_t(str[4 * i + 1]) << 16)
+                      | (char32_t(str[4 * i + 2]) << 8) | char32_t(str[4 * i + 3])));
+    }
+}
+
+TEST_CASE("make_buffer_from_utf16")
+{
+    // The number of lone surrogates in the last call.
+    auto replaced   = std::size_t(0);
+    auto from_utf16 = [&replaced](std::initializer_list<char16_t> units, auto endian) {
+        constexpr auto little = decltype(endian)::value == lexy::encoding_endianness::little;
+
+        std::vector<unsigned char> bytes;
+        for (auto unit : units)
+        {
+            auto lo = static_cast<unsigned char>(unit & 0xFF);
+            auto hi = static_cast<unsigned char>(unit >> 8);
+            bytes.push_back(little ? lo : hi);
+            bytes.push_back(little ? hi : lo);
+        }
+
+        auto buffer
+            = lexy::make_buffer_from_utf16<lexy::utf8_encoding,
+                                           decltype(endian)::value>(bytes.data(), bytes.size(),
+                                                                    replaced);
+        return std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    };
+    auto little = std::integral_constant<lexy::encoding_endianness,
+                                         lexy::encoding_endianness::little>{};
+    auto big
+        = std::integral_constant<lexy::encoding_endianness, lexy::encoding_endianness::big>{};
+
+    SUBCASE("empty")
+    {
+        CHECK(from_utf16({}, little).empty());
+        CHECK(from_utf16({}, big).empty());
+    }
+    SUBCASE("ASCII")
+    {
+        CHECK(from_utf16({u'a', u'b', u'c'}, little) == "abc");
+        CHECK(from_utf16({u'a', u'b', u'c', u'd', u'e', u'f', u'g', u'h', u'i', u'j'}, big)
+              == "abcdefghij");
+    }
+    SUBCASE("multi-byte")
+    {
+        // U+00E4, U+20AC, U+1F600
+        auto expected = std::string("a\xC3\xA4\xE2\x82\xAC\xF0\x9F\x98\x80");
+        CHECK(from_utf16({u'a', 0x00E4, 0x20AC, 0xD83D, 0xDE00}, little) == expected);
+        CHECK(replaced == 0);
+        CHECK(from_utf16({u'a', 0x00E4, 0x20AC, 0xD83D, 0xDE00}, big) == expected);
+        CHECK(from_utf16({u'a', u'a', u'a', u'a', u'a', u'a', u'a', u'a', u'a', 0x00E4, 0x20AC,
+                          0xD83D, 0xDE00, u'a', u'a', u'a', u'a', u'a'},
+                         big)
+              == "aaaaaaaa" + expected + "aaaaa");
+    }
+    SUBCASE("surrogate pair across blocks")
+    {
+        // The pair starts at the end of the first block of eight code units.
+        CHECK(from_utf16({u'a', u'a', u'a', u'a', u'a', u'a', u'a', 0xD83D, 0xDE00, u'a', u'a',
+                          u'a', u'a', u'a', u'a', u'a'},
+                         little)
+              == "aaaaaaa\xF0\x9F\x98\x80" "aaaaaaa");
+    }
+    SUBCASE("lone surrogates")
+    {
+        // They are replaced by U+FFFD and counted.
+        CHECK(from_utf16({0xD83D}, little) == "\xEF\xBF\xBD");
+        CHECK(replaced == 1);
+        CHECK(from_utf16({0xDE00, u'a'}, little) == "\xEF\xBF\xBD" "a");
+        CHECK(replaced == 1);
+        CHECK(from_utf16({0xD83D, u'a', u'a', u'a', u'a', u'a', u'a', u'a', u'a'}, big)
+              == "\xEF\xBF\xBD" "aaaaaaaa");
+        CHECK(replaced == 1);
+        CHECK(from_utf16({0xD83D, 0xD83D, 0xDE00, 0xDE00}, big)
+              == "\xEF\xBF\xBD\xF0\x9F\x98\x80\xEF\xBF\xBD");
+        CHECK(replaced == 2);
+
+        auto result = from_utf16({u'a', 0xDE00, u'a', u'a', u'a', u'a', u'a', u'a', u'a'}, big);
+        CHECK(result == "a\xEF\xBF\xBD" "aaaaaaa");
+        CHECK(replaced == 1);
+        CHECK(lexy::_detail::validate_utf8(reinterpret_cast<const unsigned char*>(result.data()),
+                                           result.size()));
+    }
+    SUBCASE("replacement character")
+    {
+        // A U+FFFD in the input is valid, so it isn't counted.
+        CHECK(from_utf16({0xFFFD, u'a'}, big) == "\xEF\xBF\xBD" "a");
+        CHECK(replaced == 0);
+    }
+    SUBCASE("long input")
+    {
+        std::vector<char16_t> units;
+        std::string           expected;
+        for (auto i = 0; i != 100; ++i)
+        {
+            units.push_back(u'x');
+            units.push_back(0x00E4);
+            units.push_back(0x20AC);
+            expected += "x\xC3\xA4\xE2\x82\xAC";
+        }
+
+        std::vector<unsigned char> bytes;
+        for (auto unit : units)
+        {
+            bytes.push_back(static_cast<unsigned char>(unit >> 8));
+            bytes.push_back(static_cast<unsigned char>(unit & 0xFF));
+        }
+
+        auto buffer = lexy::make_buffer_from_utf16<lexy::utf8_encoding,
+                                                   lexy::encoding_endianness::big>(bytes.data(),
+                                                                                   bytes.size());
+        CHECK(std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size())
+              == expected);
+    }
+    SUBCASE("BOM")
+    {
+        const unsigned char little_bom_str[] = {0xFF, 0xFE, 0x61, 0x00};
+        auto                little_bom
+            = lexy::make_buffer_from_utf16<lexy::utf8_encoding,
+                                           lexy::encoding_endianness::bom>(little_bom_str,
+                                                                           sizeof(little_bom_str));
+        CHECK(little_bom.size() == 1);
+        CHECK(little_bom.data()[0] == 'a');
+
+        const unsigned char big_bom_str[] = {0xFE, 0xFF, 0x00, 0x61};
+        auto                big_bom
+            = lexy::make_buffer_from_utf16<lexy::utf8_encoding,
+                                           lexy::encoding_endianness::bom>(big_bom_str,
+                                                                           sizeof(big_bom_str));
+        CHECK(big_bom.size() == 1);
+        CHECK(big_bom.data()[0] == 'a');
+
+        const unsigned char no_bom_str[] = {0x00, 0x61};
+        auto                no_bom
+            = lexy::make_buffer_from_utf16<lexy::utf8_encoding,
+                                           lexy::encoding_endianness::bom>(no_bom_str,
+                                                                           sizeof(no_bom_str));
+        CHECK(no_bom.size() == 1);
+        CHECK(no_bom.data()[0] == 'a');
+    }
 }
 
 TEST_CASE("make_buffer_from_input")
@@ -6,6 +6,9 @@
 
 #include <cstdio>
 #include <doctest/doctest.h>
+#include <string>
+#include <thread>
+#include <vector>
 
 #if defined(__has_include) && __has_include(<memory_resource>) && !defined(_LIBCPP_VERSION)
 #    include <memory_resource>
@@ -14,6 +17,10 @@
 #    define LEXY_HAS_RESOURCE 0
 #endif
 
+#if defined(__unix__) || defined(__APPLE__)
+#    include <unistd.h>
+#endif
+
 namespace
 {
 constexpr auto test_file_name = "lexy-input-file.test.delete-me";
@@ -152,6 +159,32 @@ TEST_CASE("read_file")
 
         CHECK(reader.peek() == lexy::default_encoding::eof());
     }
+    SUBCASE("big file with options")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 2 * 1024 * 1024; ++i)
+                std::fputc('a', file);
+            for (auto i = 0; i != 2 * 1024 * 1024; ++i)
+                std::fputc('b', file);
+            std::fclose(file);
+        }
+
+        lexy::file_options options;
+        options.populate   = true;
+        options.sequential = true;
+        options.huge_pages = true;
+
+        auto result = lexy::read_file(test_file_name, options);
+        REQUIRE(result);
+
+        auto& buffer = result.buffer();
+        REQUIRE(buffer.size() == 4 * 1024 * 1024);
+        CHECK(buffer.data()[0] == 'a');
+        CHECK(buffer.data()[2 * 1024 * 1024 - 1] == 'a');
+        CHECK(buffer.data()[2 * 1024 * 1024] == 'b');
+        CHECK(buffer.data()[4 * 1024 * 1024 - 1] == 'b');
+    }
 #if LEXY_HAS_RESOURCE
     SUBCASE("custom encoding and resource")
     {
@@ -191,10 +224,379 @@ TEST_CASE("read_file")
         reader.bump();
         CHECK(reader.peek() == lexy::utf16_encoding::eof());
     }
+    SUBCASE("custom byte order with options")
+    {
+        const unsigned char data[] = {0xFE, 0xFF, 0x11, 0x22, 0x33, 0x44, 0x00};
+        write_test_data(reinterpret_cast<const char*>(data));
+
+        lexy::file_options options;
+        options.huge_pages = true;
+
+        auto result = lexy::read_file<lexy::utf16_encoding>(test_file_name, options);
+        REQUIRE(result);
+
+        auto reader = result.buffer().reader();
+        CHECK(reader.peek() == 0x1122);
+
+        reader.bump();
+        CHECK(reader.peek() == 0x3344);
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::utf16_encoding::eof());
+    }
+
+    std::remove(test_file_name);
+}
+
+TEST_CASE("map_file")
+{
+    std::remove(test_file_name);
+
+    SUBCASE("non-existing file")
+    {
+        auto result = lexy::map_file(test_file_name);
+        CHECK(!result);
+        CHECK(result.error() == lexy::file_error::file_not_found);
+    }
+    SUBCASE("empty file")
+    {
+        write_test_data("");
+
+        auto result = lexy::map_file(test_file_name);
+        REQUIRE(result);
+        CHECK(result.file().size() == 0);
+
+        auto reader = result.file().reader();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("tiny file")
+    {
+        write_test_data("abc");
+
+        auto result = lexy::map_file(test_file_name);
+        REQUIRE(result);
+        CHECK(result.file().size() == 3);
+
+        auto reader = result.file().reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("page-sized file")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 4 * 1024; ++i)
+                std::fputc('a', file);
+            std::fclose(file);
+        }
+
+        auto result = lexy::map_file<lexy::utf8_encoding>(test_file_name);
+        REQUIRE(result);
+        CHECK(result.file().size() == 4 * 1024);
+
+        auto reader = result.file().reader();
+        for (auto i = 0; i != 4 * 1024; ++i)
+        {
+            CHECK(reader.peek() == 'a');
+            reader.bump();
+        }
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+        CHECK(reader.peek_swar() == lexy::_detail::swar_fill(lexy::utf8_encoding::eof()));
+    }
+    SUBCASE("big file")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 200 * 1024; ++i)
+                std::fputc('a', file);
+            for (auto i = 0; i != 200 * 1024; ++i)
+                std::fputc('b', file);
+            std::fclose(file);
+        }
+
+        auto result = lexy::map_file(test_file_name);
+        REQUIRE(result);
+
+        auto reader = result.file().reader();
+        for (auto i = 0; i != 200 * 1024; ++i)
+        {
+            CHECK(reader.peek() == 'a');
+            reader.bump();
+        }
+
+        for (auto i = 0; i != 200 * 1024; ++i)
+        {
+            CHECK(reader.peek() == 'b');
+            reader.bump();
+        }
+
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("big file with options")
+    {
+        {
+            auto file = std::fopen(test_file_name, "wb");
+            for (auto i = 0; i != 2 * 1024 * 1024; ++i)
+                std::fputc('a', file);
+            for (auto i = 0; i != 2 * 1024 * 1024; ++i)
+                std::fputc('b', file);
+            std::fclose(file);
+        }
+
+        lexy::file_options options;
+        options.populate   = true;
+        options.sequential = true;
+        options.huge_pages = true;
+
+        auto result = lexy::map_file(test_file_name, options);
+        REQUIRE(result);
+
+        auto& file = result.file();
+        REQUIRE(file.size() == 4 * 1024 * 1024);
+        CHECK(file.data()[0] == 'a');
+        CHECK(file.data()[2 * 1024 * 1024 - 1] == 'a');
+        CHECK(file.data()[2 * 1024 * 1024] == 'b');
+        CHECK(file.data()[4 * 1024 * 1024 - 1] == 'b');
+    }
+    SUBCASE("UTF-8 with BOM")
+    {
+        write_test_data("\xEF\xBB\xBF" "abc");
+
+        auto result = lexy::map_file<lexy::utf8_encoding>(test_file_name);
+        REQUIRE(result);
+        CHECK(result.file().size() == 3);
+
+        auto reader = result.file().reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+    }
+    SUBCASE("move")
+    {
+        write_test_data("abc");
+
+        auto result = lexy::map_file(test_file_name);
+        REQUIRE(result);
+
+        auto file = LEXY_MOV(result).file();
+        CHECK(file.size() == 3);
+        CHECK(file.data()[0] == 'a');
+
+        lexy::mapped_file<> other;
+        other = LEXY_MOV(file);
+        CHECK(other.size() == 3);
+        CHECK(other.data()[0] == 'a');
+        CHECK(file.size() == 0);
+    }
 
     std::remove(test_file_name);
 }
 
+TEST_CASE("read_files")
+{
+    const char* paths[] = {"lexy-input-file.test.0.delete-me", "lexy-input-file.test.1.delete-me",
+                           "lexy-input-file.test.2.delete-me", "lexy-input-file.test.3.delete-me"};
+    auto        write_files = [&] {
+        // File 2 does not exist.
+        for (auto i = 0; i != 4; ++i)
+        {
+            std::remove(paths[i]);
+            if (i == 2)
+                continue;
+
+            auto file = std::fopen(paths[i], "wb");
+            for (auto j = 0; j != (i + 1) * 16 * 1024; ++j)
+                std::fputc('a' + i, file);
+            std::fclose(file);
+        }
+    };
+    auto remove_files = [&] {
+        for (auto path : paths)
+            std::remove(path);
+    };
+
+    write_files();
+
+    SUBCASE("single thread")
+    {
+        std::vector<std::size_t> sizes(4);
+        std::vector<int>         invoked(4);
+        lexy::read_files(
+            paths, 4,
+            [&](std::size_t index, lexy::read_file_result<>&& result) {
+                ++invoked[index];
+                if (result)
+                    sizes[index] = result.buffer().size();
+                else
+                    CHECK(result.error() == lexy::file_error::file_not_found);
+            },
+            1);
+
+        CHECK(invoked == std::vector<int>{1, 1, 1, 1});
+        CHECK(sizes == std::vector<std::size_t>{16 * 1024, 32 * 1024, 0, 64 * 1024});
+    }
+    SUBCASE("multiple threads")
+    {
+        std::vector<std::size_t> sizes(4);
+        std::vector<int>         invoked(4);
+        lexy::read_files(
+            paths, 4,
+            [&](std::size_t index, lexy::read_file_result<>&& result) {
+                // Different threads never write the same index.
+                ++invoked[index];
+                if (!result)
+                    return;
+
+                auto buffer = LEXY_MOV(result).buffer();
+                auto ok     = true;
+                for (auto ptr = buffer.data(); ptr != buffer.data() + buffer.size(); ++ptr)
+                    ok &= *ptr == char('a' + index);
+                if (ok)
+                    sizes[index] = buffer.size();
+            },
+            4);
+
+        CHECK(invoked == std::vector<int>{1, 1, 1, 1});
+        CHECK(sizes == std::vector<std::size_t>{16 * 1024, 32 * 1024, 0, 64 * 1024});
+    }
+    SUBCASE("exception")
+    {
+        auto caught = false;
+        try
+        {
+            lexy::read_files(
+                paths, 4, [&](std::size_t, lexy::read_file_result<>&&) { throw 42; }, 2);
+        }
+        catch (int i)
+        {
+            caught = i == 42;
+        }
+        CHECK(caught);
+    }
+
+    remove_files();
+}
+
+TEST_CASE("read_files_async")
+{
+    const char* paths[] = {"lexy-input-file.test.0.delete-me", "lexy-input-file.test.1.delete-me",
+                           "lexy-input-file.test.2.delete-me", "lexy-input-file.test.3.delete-me"};
+    auto        write_files = [&] {
+        // File 2 does not exist.
+        for (auto i = 0; i != 4; ++i)
+        {
+            std::remove(paths[i]);
+            if (i == 2)
+                continue;
+
+            auto file = std::fopen(paths[i], "wb");
+            for (auto j = 0; j != (i + 1) * 16 * 1024; ++j)
+                std::fputc('a' + i, file);
+            std::fclose(file);
+        }
+    };
+    auto remove_files = [&] {
+        for (auto path : paths)
+            std::remove(path);
+    };
+
+    write_files();
+    INFO(lexy::_detail::has_async_file_io());
+
+    SUBCASE("one file in flight")
+    {
+        std::vector<std::size_t> sizes(4);
+        std::vector<int>         invoked(4);
+        lexy::read_files_async(
+            paths, 4,
+            [&](std::size_t index, lexy::read_file_result<>&& result) {
+                ++invoked[index];
+                if (result)
+                    sizes[index] = result.buffer().size();
+                else
+                    CHECK(result.error() == lexy::file_error::file_not_found);
+            },
+            1);
+
+        CHECK(invoked == std::vector<int>{1, 1, 1, 1});
+        CHECK(sizes == std::vector<std::size_t>{16 * 1024, 32 * 1024, 0, 64 * 1024});
+    }
+    SUBCASE("multiple files in flight")
+    {
+        std::vector<std::size_t> sizes(4);
+        std::vector<int>         invoked(4);
+        lexy::read_files_async(
+            paths, 4,
+            [&](std::size_t index, lexy::read_file_result<>&& result) {
+                ++invoked[index];
+                if (!result)
+                    return;
+
+                auto buffer = LEXY_MOV(result).buffer();
+                auto ok     = true;
+                for (auto ptr = buffer.data(); ptr != buffer.data() + buffer.size(); ++ptr)
+                    ok &= *ptr == char('a' + index);
+                if (ok)
+                    sizes[index] = buffer.size();
+            },
+            4);
+
+        CHECK(invoked == std::vector<int>{1, 1, 1, 1});
+        CHECK(sizes == std::vector<std::size_t>{16 * 1024, 32 * 1024, 0, 64 * 1024});
+    }
+    SUBCASE("exception")
+    {
+        auto caught = false;
+        try
+        {
+            lexy::read_files_async(
+                paths, 4, [&](std::size_t, lexy::read_file_result<>&&) { throw 42; }, 2);
+        }
+        catch (int i)
+        {
+            caught = i == 42;
+        }
+        CHECK(caught);
+    }
+
+    remove_files();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+namespace
+{
+// Calls `read` while stdin reads from the file descriptor, which is closed afterwards.
+template <typename Fn>
+auto read_stdin_from(int fd, Fn read)
+{
+    auto saved_stdin = ::dup(STDIN_FILENO);
+    ::dup2(fd, STDIN_FILENO);
+    ::close(fd);
+
+    auto result = read();
+
+    ::dup2(saved_stdin, STDIN_FILENO);
+    ::close(saved_stdin);
+    return result;
+}
+} // namespace
+#endif
+
 TEST_CASE("read_stdin")
 {
     // Here, we'll reassociate stdin with our test file.
@@ -269,6 +671,144 @@ TEST_CASE("read_stdin")
 
         CHECK(reader.peek() == lexy::default_encoding::eof());
     }
+#if defined(__unix__) || defined(__APPLE__)
+    SUBCASE("pipe")
+    {
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+        REQUIRE(::write(fds[1], "abc", 3) == 3);
+        ::close(fds[1]);
+
+        auto result = read_stdin_from(fds[0], [] { return lexy::read_stdin(); });
+        REQUIRE(result);
+
+        auto reader = result.buffer().reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("big pipe")
+    {
+        // Several chunks, the last one only partially filled.
+        constexpr auto size = std::size_t(5) * 1024 * 1024 + 42;
+
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+        std::thread writer([fd = fds[1]] {
+            std::vector<char> data(size);
+            for (auto i = std::size_t(0); i != size; ++i)
+                data[i] = char('a' + i % 26);
+
+            for (auto written = std::size_t(0); written < size;)
+            {
+                auto result = ::write(fd, data.data() + written, size - written);
+                if (result <= 0)
+                    break;
+                written += std::size_t(result);
+            }
+            ::close(fd);
+        });
+
+        auto result = read_stdin_from(fds[0], [] { return lexy::read_stdin(); });
+        writer.join();
+        REQUIRE(result);
+
+        auto& buffer = result.buffer();
+        REQUIRE(buffer.size() == size);
+        auto mismatch = std::size_t(0);
+        for (auto i = std::size_t(0); i != size; ++i)
+            if (buffer.data()[i] != char('a' + i % 26))
+                ++mismatch;
+        CHECK(mismatch == 0);
+    }
+    SUBCASE("big pipe in a single block")
+    {
+        constexpr auto size = std::size_t(3) * 1024 * 1024 + 42;
+
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+        std::thread writer([fd = fds[1]] {
+            std::vector<char> data(size);
+            for (auto i = std::size_t(0); i != size; ++i)
+                data[i] = char('a' + i % 26);
+
+            for (auto written = std::size_t(0); written < size;)
+            {
+                auto result = ::write(fd, data.data() + written, size - written);
+                if (result <= 0)
+                    break;
+                written += std::size_t(result);
+            }
+            ::close(fd);
+        });
+
+        // The entry point that passes the contents as a single block of memory.
+        std::string contents;
+        auto        error = read_stdin_from(fds[0], [&contents] {
+            return lexy::_detail::read_stdin(
+                [](void* user_data, const char* memory, std::size_t size) {
+                    static_cast<std::string*>(user_data)->assign(memory, size);
+                },
+                &contents);
+        });
+        writer.join();
+        REQUIRE(error == lexy::file_error::_success);
+
+        REQUIRE(contents.size() == size);
+        auto mismatch = std::size_t(0);
+        for (auto i = std::size_t(0); i != size; ++i)
+            if (contents[i] != char('a' + i % 26))
+                ++mismatch;
+        CHECK(mismatch == 0);
+    }
+    SUBCASE("big pipe with byte order mark")
+    {
+        constexpr auto size = std::size_t(3) * 1024 * 1024;
+
+        int fds[2];
+        REQUIRE(::pipe(fds) == 0);
+        std::thread writer([fd = fds[1]] {
+            // UTF-16 big endian with a byte order mark.
+            std::vector<unsigned char> data(2 + 2 * size);
+            data[0] = 0xFE;
+            data[1] = 0xFF;
+            for (auto i = std::size_t(0); i != size; ++i)
+            {
+                data[2 + 2 * i]     = static_cast<unsigned char>(i >> 8);
+                data[2 + 2 * i + 1] = static_cast<unsigned char>(i);
+            }
+
+            for (auto written = std::size_t(0); written < data.size();)
+            {
+                auto result = ::write(fd, data.data() + written, data.size() - written);
+                if (result <= 0)
+                    break;
+                written += std::size_t(result);
+            }
+            ::close(fd);
+        });
+
+        auto result
+            = read_stdin_from(fds[0], [] { return lexy::read_stdin<lexy::utf16_encoding>(); });
+        writer.join();
+        REQUIRE(result);
+
+        auto& buffer = result.buffer();
+        REQUIRE(buffer.size() == size);
+        auto mismatch = std::size_t(0);
+        for (auto i = std::size_t(0); i != size; ++i)
+            if (buffer.data()[i] != char16_t(i & 0xFFFF))
+                ++mismatch;
+        CHECK(mismatch == 0);
+    }
+#endif
 #if LEXY_HAS_RESOURCE
     SUBCASE("custom encoding and resource")
     {
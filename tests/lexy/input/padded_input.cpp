@@ -0,0 +1,98 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/input/padded_input.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/action/match.hpp>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/loop.hpp>
+
+namespace
+{
+struct production
+{
+    static constexpr auto rule = lexy::dsl::while_(lexy::dsl::ascii::alpha) + LEXY_LIT("!");
+};
+} // namespace
+
+TEST_CASE("padded_input")
+{
+    SUBCASE("basic")
+    {
+        char memory[3 + lexy::padded_input<lexy::utf8_char_encoding>::padding];
+        memory[0] = 'a';
+        memory[1] = 'b';
+        memory[2] = 'c';
+
+        lexy::padded_input<lexy::utf8_char_encoding> input(memory, 3, sizeof(memory));
+        CHECK(input.data() == memory);
+        CHECK(input.size() == 3);
+
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_swar_reader<decltype(reader)>);
+        CHECK(reader.position() == memory);
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.position() == memory + 1);
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.position() == memory + 2);
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.position() == memory + 3);
+        CHECK(reader.peek() == lexy::utf8_char_encoding::eof());
+    }
+    SUBCASE("swar")
+    {
+        char memory[64];
+        for (auto i = 0u; i != sizeof(memory); ++i)
+            memory[i] = char('a' + i % 26);
+        lexy::padded_input<lexy::utf8_encoding> input(memory, 10, sizeof(memory));
+
+        auto reader = input.reader();
+        CHECK(reader.peek_swar()
+              == lexy::_detail::swar_pack('a', 'b', 'c', 'd', 'e', 'f', 'g', 'h').value);
+
+        // The tail is overwritten with EOF.
+        reader.bump_swar();
+        CHECK(reader.peek_swar()
+              == lexy::_detail::swar_pack('i', 'j', char(0xFF), char(0xFF), char(0xFF),
+                                          char(0xFF), char(0xFF), char(0xFF))
+                     .value);
+
+        reader.bump_swar(2);
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+        CHECK(memory[10 + input.padding - 1] == char(0xFF));
+        CHECK(memory[10 + input.padding] != char(0xFF));
+    }
+    SUBCASE("utf16")
+    {
+        char16_t memory[] = {u'a', u'b', u'c', u'd'};
+        lexy::padded_input input(memory, 3, 3);
+        CHECK(input.padding == 0);
+
+        auto reader = input.reader();
+        CHECK(reader.peek() == u'a');
+
+        reader.bump();
+        reader.bump();
+        reader.bump();
+        CHECK(reader.peek() == lexy::utf16_encoding::eof());
+        CHECK(memory[3] == u'd');
+    }
+    SUBCASE("match")
+    {
+        char memory[128] = "abcdefghijklmnopqrstuvwxyz!";
+
+        lexy::padded_input<lexy::utf8_encoding> input(memory, 27, sizeof(memory));
+        CHECK(lexy::match<production>(input));
+
+        lexy::padded_input<lexy::utf8_encoding> prefix(memory, 26, sizeof(memory));
+        CHECK(!lexy::match<production>(prefix));
+    }
+}
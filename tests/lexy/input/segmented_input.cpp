@@ -0,0 +1,131 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy/input/segmented_input.hpp>
+
+#include <doctest/doctest.h>
+#include <lexy/action/match.hpp>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/loop.hpp>
+
+namespace
+{
+struct production
+{
+    static constexpr auto rule = lexy::dsl::while_(lexy::dsl::ascii::alpha) + LEXY_LIT("!");
+};
+} // namespace
+
+TEST_CASE("segmented_input")
+{
+    using segment = lexy::input_segment<char>;
+
+    SUBCASE("empty")
+    {
+        lexy::segmented_input<> input;
+        CHECK(input.segment_count() == 1);
+        CHECK(input.reader().peek() == lexy::default_encoding::eof());
+
+        const segment segments[] = {{"", 0}, {"", 0}};
+        input                    = lexy::segmented_input<>(segments, 2);
+        CHECK(input.reader().peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("single segment")
+    {
+        const char    str[]      = "abc";
+        const segment segments[] = {{str, 3}};
+
+        lexy::segmented_input<> input(segments, 1);
+        CHECK(input.segments() == segments);
+        CHECK(input.segment_count() == 1);
+
+        auto reader = input.reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+    }
+    SUBCASE("multiple segments")
+    {
+        const segment segments[] = {{"", 0}, {"ab", 2}, {"", 0}, {"cde", 3}, {"f", 1}, {"", 0}};
+
+        lexy::segmented_input<> input(segments, 6);
+        auto                    reader = input.reader();
+
+        auto begin = reader.current();
+        for (auto c = 'a'; c <= 'f'; ++c)
+        {
+            CHECK(reader.peek() == c);
+            reader.bump();
+        }
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+
+        auto lexeme   = lexy::lexeme_for<decltype(input)>(begin.position(), reader.position());
+        auto expected = 'a';
+        for (auto c : lexeme)
+        {
+            CHECK(c == expected);
+            ++expected;
+        }
+        CHECK(expected == 'g');
+
+        reader.reset(begin);
+        CHECK(reader.peek() == 'a');
+        CHECK(reader.position() == begin.position());
+    }
+    SUBCASE("shared memory")
+    {
+        // Both segments refer to the same memory, but their positions are different.
+        const char    str[]      = "ab";
+        const segment segments[] = {{str, 2}, {str, 2}};
+
+        lexy::segmented_input<> input(segments, 2);
+        auto                    reader = input.reader();
+
+        auto first = reader.position();
+        reader.bump();
+        reader.bump();
+        CHECK(reader.peek() == 'a');
+        CHECK(reader.position() != first);
+    }
+    SUBCASE("swar")
+    {
+        const segment segments[] = {{"abcdefghij", 10}, {"klm", 3}, {"nop", 3}};
+
+        lexy::segmented_input<lexy::utf8_char_encoding> input(segments, 3);
+        auto                                            reader = input.reader();
+        CHECK(lexy::_detail::is_swar_reader<decltype(reader)>);
+
+        // Inside a segment.
+        CHECK(reader.peek_swar()
+              == lexy::_detail::swar_pack('a', 'b', 'c', 'd', 'e', 'f', 'g', 'h').value);
+
+        reader.bump_swar();
+        CHECK(reader.peek() == 'i');
+
+        // Crosses segment boundaries.
+        CHECK(reader.peek_swar()
+              == lexy::_detail::swar_pack('i', 'j', 'k', 'l', 'm', 'n', 'o', 'p').value);
+
+        reader.bump_swar();
+        CHECK(reader.peek() == lexy::utf8_char_encoding::eof());
+        CHECK(reader.peek_swar() == lexy::_detail::swar_fill(lexy::utf8_char_encoding::eof()));
+    }
+    SUBCASE("match")
+    {
+        const segment segments[] = {{"abcdefghijklmnopqrs", 19}, {"tuvwxyz", 7}, {"!", 1}};
+
+        lexy::segmented_input<lexy::utf8_char_encoding> input(segments, 3);
+        CHECK(lexy::match<production>(input));
+
+        lexy::segmented_input<lexy::utf8_char_encoding> prefix(segments, 2);
+        CHECK(!lexy::match<production>(prefix));
+    }
+}
@@ -0,0 +1,336 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#undef LEXY_DISABLE_FILE
+#include <lexy/input/stream_input.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <doctest/doctest.h>
+#include <lexy/action/match.hpp>
+#include <lexy/action/parse.hpp>
+#include <lexy/action/validate.hpp>
+#include <lexy/callback/noop.hpp>
+#include <lexy/dsl/ascii.hpp>
+#include <lexy/dsl/branch.hpp>
+#include <lexy/dsl/choice.hpp>
+#include <lexy/dsl/effect.hpp>
+#include <lexy/dsl/eof.hpp>
+#include <lexy/dsl/literal.hpp>
+#include <lexy/dsl/newline.hpp>
+#include <lexy/dsl/loop.hpp>
+#include <lexy/dsl/production.hpp>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>
+#    include <unistd.h>
+
+namespace
+{
+constexpr auto test_file_name = "lexy-input-stream_input.test.delete-me";
+
+int open_test_data(const char* data, std::size_t size)
+{
+    auto file = std::fopen(test_file_name, "wb");
+    std::fwrite(data, 1, size, file);
+    std::fclose(file);
+
+    return ::open(test_file_name, O_RDONLY);
+}
+int open_test_data(const char* data)
+{
+    return open_test_data(data, std::strlen(data));
+}
+
+struct production
+{
+    static constexpr auto rule = lexy::dsl::while_(lexy::dsl::ascii::alpha) + LEXY_LIT("!");
+};
+
+struct buffered_state
+{
+    const lexy::stream_input<lexy::utf8_encoding>* input;
+    std::size_t                                    max_buffered_size;
+};
+
+constexpr auto record_buffered_size = [](buffered_state& state) {
+    if (state.input->buffered_size() > state.max_buffered_size)
+        state.max_buffered_size = state.input->buffered_size();
+};
+
+struct item
+{
+    static constexpr auto rule = LEXY_LIT("ab") >> lexy::dsl::effect<record_buffered_size>;
+};
+
+struct item_list
+{
+    static constexpr auto rule
+        = lexy::dsl::loop(lexy::dsl::p<item> | lexy::dsl::eof >> lexy::dsl::break_);
+};
+
+struct record
+{
+    static constexpr auto rule = lexy::dsl::while_(lexy::dsl::ascii::alpha)
+                                 + lexy::dsl::effect<record_buffered_size> + lexy::dsl::newline;
+    static constexpr auto value = lexy::noop;
+};
+} // namespace
+
+TEST_CASE("stream_input")
+{
+    std::remove(test_file_name);
+
+    SUBCASE("empty")
+    {
+        auto fd = open_test_data("");
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd);
+        CHECK(input.buffered_size() == 0);
+
+        auto reader = input.reader();
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+        CHECK(!input.has_error());
+
+        ::close(fd);
+    }
+    SUBCASE("single chunk")
+    {
+        auto fd = open_test_data("abc");
+
+        lexy::stream_input<> input(fd);
+        auto                 reader = input.reader();
+        CHECK(reader.position().offset() == 0);
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.position().offset() == 1);
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.position().offset() == 3);
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(input.buffered_size() == 3);
+
+        ::close(fd);
+    }
+    SUBCASE("multiple chunks")
+    {
+        auto fd = open_test_data("abcdefghij");
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 4);
+        auto                                    reader = input.reader();
+
+        auto begin = reader.current();
+        for (auto c = 'a'; c <= 'j'; ++c)
+        {
+            CHECK(reader.peek() == c);
+            reader.bump();
+        }
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+        CHECK(input.buffered_size() == 10);
+
+        auto lexeme   = lexy::lexeme_for<decltype(input)>(begin.position(), reader.position());
+        auto expected = 'a';
+        for (auto c : lexeme)
+        {
+            CHECK(c == expected);
+            ++expected;
+        }
+        CHECK(expected == 'k');
+
+        reader.reset(begin);
+        CHECK(reader.peek() == 'a');
+
+        ::close(fd);
+    }
+    SUBCASE("discard chunks")
+    {
+        char data[1024];
+        std::memset(data, 'a', sizeof(data));
+        auto fd = open_test_data(data, sizeof(data));
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 16);
+        auto                                    reader = input.reader();
+        for (auto i = 0; i != 1024; ++i)
+        {
+            CHECK(reader.peek() == 'a');
+            reader.bump();
+            CHECK(input.buffered_size() <= 2 * 16);
+        }
+        CHECK(reader.peek() == lexy::utf8_encoding::eof());
+
+        ::close(fd);
+    }
+    SUBCASE("marker keeps chunks alive")
+    {
+        char data[1024];
+        std::memset(data, 'a', sizeof(data));
+        auto fd = open_test_data(data, sizeof(data));
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 16);
+        auto                                    reader = input.reader();
+        reader.bump();
+
+        auto marker = reader.current();
+        while (reader.peek() != lexy::utf8_encoding::eof())
+            reader.bump();
+        CHECK(input.buffered_size() == 1024);
+
+        reader.reset(marker);
+        CHECK(reader.position().offset() == 1);
+        CHECK(reader.peek() == 'a');
+
+        ::close(fd);
+    }
+    SUBCASE("reader continues where the last reader stopped")
+    {
+        auto fd = open_test_data("abcdefghij");
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 4);
+        {
+            auto reader = input.reader();
+            reader.bump();
+
+            // The copy is destroyed first, so it doesn't change the position.
+            auto copy = reader;
+            for (auto i = 0; i != 5; ++i)
+                copy.bump();
+        }
+
+        auto reader = input.reader();
+        CHECK(reader.position().offset() == 1);
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        // The old reader is still alive, so the new one starts at the beginning.
+        auto other = input.reader();
+        CHECK(other.position().offset() == 0);
+        CHECK(other.peek() == 'a');
+
+        ::close(fd);
+    }
+    SUBCASE("swar")
+    {
+        auto fd = open_test_data("abcdefghijk");
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 4);
+        auto                                    reader = input.reader();
+        CHECK(lexy::_detail::is_swar_reader<decltype(reader)>);
+
+        // Crosses chunk boundaries.
+        auto swar = reader.peek_swar();
+        CHECK(swar == lexy::_detail::swar_pack('a', 'b', 'c', 'd', 'e', 'f', 'g', 'h').value);
+
+        reader.bump_swar();
+        CHECK(reader.peek() == 'i');
+
+        // Reaches EOF.
+        swar = reader.peek_swar();
+        CHECK(swar
+              == lexy::_detail::swar_pack('i', 'j', 'k', char(0xFF), char(0xFF), char(0xFF),
+                                          char(0xFF), char(0xFF))
+                     .value);
+
+        ::close(fd);
+    }
+    SUBCASE("utf16")
+    {
+        const char16_t data[] = {u'a', u'b', u'c'};
+        auto           fd = open_test_data(reinterpret_cast<const char*>(data), sizeof(data));
+
+        lexy::stream_input<lexy::utf16_encoding> input(fd, 2);
+        auto                                     reader = input.reader();
+        CHECK(reader.peek() == 'a');
+
+        reader.bump();
+        CHECK(reader.peek() == 'b');
+
+        reader.bump();
+        CHECK(reader.peek() == 'c');
+
+        reader.bump();
+        CHECK(reader.peek() == lexy::utf16_encoding::eof());
+
+        ::close(fd);
+    }
+    SUBCASE("match")
+    {
+        auto fd = open_test_data("abcdefghijklmnopqrstuvwxyz!");
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 4);
+        CHECK(lexy::match<production>(input));
+
+        ::close(fd);
+    }
+    SUBCASE("match discards chunks")
+    {
+        std::string data;
+        for (auto i = 0; i != 16 * 1024; ++i)
+            data += "ab";
+        auto fd = open_test_data(data.data(), data.size());
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 256);
+        buffered_state                          state{&input, 0};
+        CHECK(lexy::match<item_list>(input, state));
+        CHECK(state.max_buffered_size > 0);
+        CHECK(state.max_buffered_size <= 2 * 256);
+
+        ::close(fd);
+    }
+    SUBCASE("validate keeps the stream")
+    {
+        std::string data;
+        for (auto i = 0; i != 16 * 1024; ++i)
+            data += "ab";
+        auto fd = open_test_data(data.data(), data.size());
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 256);
+        buffered_state                          state{&input, 0};
+        CHECK(lexy::validate<item_list>(input, state, lexy::noop).is_success());
+        // The beginning of item_list is kept for error reporting.
+        CHECK(state.max_buffered_size == data.size());
+
+        ::close(fd);
+    }
+    SUBCASE("parse record by record")
+    {
+        std::string data;
+        for (auto i = 0; i != 4 * 1024; ++i)
+            data += "abcdefgh\n";
+        auto fd = open_test_data(data.data(), data.size());
+
+        lexy::stream_input<lexy::utf8_encoding> input(fd, 256);
+        buffered_state                          state{&input, 0};
+
+        auto count = 0;
+        while (input.reader().peek() != lexy::utf8_encoding::eof())
+        {
+            auto result = lexy::parse<record>(input, state, lexy::noop);
+            REQUIRE(result.is_success());
+            ++count;
+        }
+        CHECK(count == 4 * 1024);
+        CHECK(state.max_buffered_size > 0);
+        CHECK(state.max_buffered_size <= 2 * 256);
+
+        ::close(fd);
+    }
+    SUBCASE("read error")
+    {
+        lexy::stream_input<> input(-1);
+
+        auto reader = input.reader();
+        CHECK(reader.peek() == lexy::default_encoding::eof());
+        CHECK(input.has_error());
+        CHECK(input.error() == lexy::file_error::os_error);
+    }
+
+    std::remove(test_file_name);
+}
+#endif
+
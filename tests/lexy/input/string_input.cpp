@@ -64,6 +64,35 @@ TEST_CASE("string_input")
         CHECK(reader.position() == str + 3);
         CHECK(reader.peek() == lexy::default_encoding::eof());
     }
+    SUBCASE("swar")
+    {
+        REQUIRE(sizeof(lexy::_detail::swar_int) == 8);
+
+        const char data[]
+            = {'\x00', '\x11', '\x22', '\x33', '\x44', '\x55', '\x66', '\x77', '\x88', '\x99'};
+        auto input = lexy::string_input<lexy::utf8_encoding>(data, sizeof(data));
+
+        auto reader = input.reader();
+        CHECK(lexy::_detail::is_swar_reader<decltype(reader)>
+              == bool(LEXY_HAS_IS_CONSTANT_EVALUATED));
+        if constexpr (lexy::_detail::is_swar_reader<decltype(reader)>)
+        {
+            CHECK(reader.peek_swar() == 0x7766554433221100);
+
+            reader.bump_swar();
+            CHECK(reader.position() == input.data() + 8);
+            CHECK(reader.peek() == 0x88);
+            // Doesn't read past the end.
+            CHECK(reader.peek_swar() == 0xFFFFFFFFFFFF9988);
+
+            reader.bump_swar(2);
+            CHECK(reader.peek() == lexy::utf8_encoding::eof());
+            CHECK(reader.peek_swar() == 0xFFFFFFFFFFFFFFFF);
+        }
+
+        // The default encoding has no EOF char.
+        CHECK(!lexy::_detail::is_swar_reader<decltype(lexy::string_input(str, 3).reader())>);
+    }
     SUBCASE("converting ctor")
     {
         lexy::string_input<lexy::byte_encoding> input;
@@ -119,6 +119,38 @@ TEST_CASE("get_input_location()")
             verify(loc, input.data() + 18, 4, input.data() + 18, 1);
         }
     }
+    SUBCASE("many lines")
+    {
+        // Long enough to count the lines with SIMD, if available.
+        auto input = lexy::zstring_input<lexy::utf8_char_encoding>("Line 1\n"
+                                                                   "Line 2\r\n"
+                                                                   "Line 3 is a little bit longer\n"
+                                                                   "\n"
+                                                                   "Line 5\r\n"
+                                                                   "Line 6 is also a bit longer\n"
+                                                                   "Line 7\n"
+                                                                   "Line 8\r\n"
+                                                                   "Line 9\n");
+
+        auto line_begin = input.data();
+        auto line_nr    = 1u;
+        for (auto cur = input.data(); cur != input.data() + input.size(); ++cur)
+        {
+            auto loc = lexy::get_input_location(input, cur);
+            INFO(cur - input.data());
+            if (*cur == '\n' && cur != line_begin && cur[-1] == '\r')
+                // The \n part of the newline.
+                verify(loc, line_begin, line_nr, cur - 1, unsigned(cur - line_begin));
+            else
+                verify(loc, line_begin, line_nr, cur, unsigned(cur - line_begin + 1));
+
+            if (*cur == '\n')
+            {
+                line_begin = cur + 1;
+                ++line_nr;
+            }
+        }
+    }
     SUBCASE("byte counting")
     {
         auto input
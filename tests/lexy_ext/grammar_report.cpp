@@ -0,0 +1,69 @@
+// Copyright (C) 2020-2024 Jonathan Müller and lexy contributors
+// SPDX-License-Identifier: BSL-1.0
+
+#include <lexy_ext/grammar_report.hpp>
+
+#include <doctest/doctest.h>
+#include <iterator>
+#include <lexy/dsl.hpp>
+#include <string>
+
+namespace
+{
+namespace dsl = lexy::dsl;
+
+struct keyword
+{
+    static constexpr auto name = "keyword";
+    static constexpr auto rule = LEXY_LIT("if") | LEXY_LIT("in");
+};
+
+struct production
+{
+    static constexpr auto name = "production";
+    static constexpr auto rule = dsl::p<keyword> + dsl::opt(dsl::lit_c<'-'> >> dsl::digits<>);
+};
+} // namespace
+
+TEST_CASE("_detail::write_char_set")
+{
+    auto write = [](const char* chars) {
+        lexy::grammar_char_set set;
+        for (auto cur = chars; *cur; ++cur)
+            set.insert(static_cast<unsigned char>(*cur));
+
+        std::string str;
+        lexy_ext::_detail::write_char_set(std::back_insert_iterator(str), set);
+        return str;
+    };
+
+    CHECK(write("") == "[]");
+    CHECK(write("a") == "[a]");
+    CHECK(write("ab") == "[ab]");
+    CHECK(write("abcd") == "[a-d]");
+    CHECK(write("0123456789+-") == "[+\\-0-9]");
+    CHECK(write(" \t\n") == "[\\t\\n\\s]");
+
+    std::string str;
+    lexy_ext::_detail::write_char_set(std::back_insert_iterator(str),
+                                      lexy::grammar_char_set::unknown());
+    CHECK(str == "<any>");
+}
+
+TEST_CASE("write_grammar_report")
+{
+    std::string str;
+    lexy_ext::write_grammar_report<production>(std::back_insert_iterator(str));
+    CHECK(str == R"*(production production
+  first:    [i]
+  nullable: no
+  follow:   []
+production keyword
+  first:    [i]
+  nullable: no
+  follow:   [\-]
+
+1 hazard(s)
+in keyword, decision 0: branch 1 (in) overlaps branch 0 (if) on [i], which reads 2 code unit(s) before it fails
+)*");
+}